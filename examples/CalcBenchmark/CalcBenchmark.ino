@@ -0,0 +1,108 @@
+/*
+  SmartMatrix Calculation Benchmark - This example code is released into the public domain
+
+  Measures how much CPU time the refresh calculations take (reading pixels from the layers and converting them
+  into the bitplane format that is sent to the panels) and prints the results once per second over Serial.
+  The timing is done with the CPU cycle counter, so the numbers are reproducible and can be compared before and
+  after making changes to the library.  Change the matrix size, refresh depth, panel type, and options to benchmark
+  different configurations.
+
+  Output columns:
+  - refresh: current refresh rate, which may be lowered automatically if the calculations can't keep up
+  - cycles/frame: cycles spent filling the refresh buffers for the last complete frame
+  - elapsed: (ESP32 only) cycles from start to finish of the last frame, about half of cycles/frame when the
+    SM_HUB75_OPTIONS_ESP32_DUAL_CORE_CALC option splits the rows between both cores
+  - ns/row: average time spent calculating a single refresh row
+  - max ns/row: worst case time spent calculating a single refresh row in the last second
+  - bytes/row: size of the refresh buffer written for each row
+*/
+
+// uncomment one line to select your MatrixHardware configuration - configuration header needs to be included before <SmartMatrix.h>
+//#include <MatrixHardware_Teensy3_ShieldV4.h>        // SmartLED Shield for Teensy 3 (V4)
+//#include <MatrixHardware_Teensy4_ShieldV5.h>        // SmartLED Shield for Teensy 4 (V5)
+//#include <MatrixHardware_Teensy3_ShieldV1toV3.h>    // SmartMatrix Shield for Teensy 3 V1-V3
+//#include <MatrixHardware_Teensy4_ShieldV4Adapter.h> // Teensy 4 Adapter attached to SmartLED Shield for Teensy 3 (V4)
+//#include <MatrixHardware_ESP32_V0.h>                // This file contains multiple ESP32 hardware configurations, edit the file to define GPIOPINOUT (or add #define GPIOPINOUT with a hardcoded number before this #include)
+//#include "MatrixHardware_Custom.h"                  // Copy an existing MatrixHardware file to your Sketch directory, rename, customize, and you can include it like this
+#include <SmartMatrix.h>
+
+#define COLOR_DEPTH 24                  // Choose the color depth used for storing pixels in the layers: 24 or 48 (24 is good for most sketches - If the sketch uses type `rgb24` directly, COLOR_DEPTH must be 24)
+const uint16_t kMatrixWidth = 32;       // Set to the width of your display, must be a multiple of 8
+const uint16_t kMatrixHeight = 32;      // Set to the height of your display
+const uint8_t kRefreshDepth = 36;       // Tradeoff of color quality vs refresh rate, max brightness, and RAM usage.  36 is typically good, drop down to 24 if you need to.  On Teensy, multiples of 3, up to 48: 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45, 48.  On ESP32: 24, 36, 48
+const uint8_t kDmaBufferRows = 4;       // known working: 2-4, use 2 to save RAM, more to keep from dropping frames and automatically lowering refresh rate.  (This isn't used on ESP32, leave as default)
+const uint8_t kPanelType = SM_PANELTYPE_HUB75_32ROW_MOD16SCAN;   // Choose the configuration that matches your panels.  See more details in MatrixCommonHub75.h and the docs: https://github.com/pixelmatix/SmartMatrix/wiki
+const uint32_t kMatrixOptions = (SM_HUB75_OPTIONS_NONE);        // see docs for options: https://github.com/pixelmatix/SmartMatrix/wiki
+const uint8_t kBackgroundLayerOptions = (SM_BACKGROUND_OPTIONS_NONE);
+const uint8_t kScrollingLayerOptions = (SM_SCROLLING_OPTIONS_NONE);
+
+SMARTMATRIX_ALLOCATE_BUFFERS(matrix, kMatrixWidth, kMatrixHeight, kRefreshDepth, kDmaBufferRows, kPanelType, kMatrixOptions);
+SMARTMATRIX_ALLOCATE_BACKGROUND_LAYER(backgroundLayer, kMatrixWidth, kMatrixHeight, COLOR_DEPTH, kBackgroundLayerOptions);
+SMARTMATRIX_ALLOCATE_SCROLLING_LAYER(scrollingLayer, kMatrixWidth, kMatrixHeight, COLOR_DEPTH, kScrollingLayerOptions);
+
+uint32_t cpuCyclesPerMicrosecond() {
+#if defined(ESP32)
+  return ESP.getCpuFreqMHz();
+#elif defined(__IMXRT1062__)
+  return F_CPU_ACTUAL / 1000000;
+#else
+  return F_CPU / 1000000;
+#endif
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  matrix.addLayer(&backgroundLayer);
+  matrix.addLayer(&scrollingLayer);
+  matrix.begin();
+
+  matrix.setBrightness(255);
+  backgroundLayer.enableColorCorrection(true);
+
+  scrollingLayer.setColor({0xff, 0xff, 0xff});
+  scrollingLayer.setMode(wrapForward);
+  scrollingLayer.setSpeed(40);
+  scrollingLayer.setFont(font6x10);
+  scrollingLayer.start("SmartMatrix Benchmark", -1);
+}
+
+void loop() {
+  static uint8_t hue = 0;
+  static unsigned long lastPrintMillis = 0;
+
+  // draw a gradient that changes every frame, so the whole display is recalculated every frame on all platforms
+  for (int y = 0; y < kMatrixHeight; y++) {
+    for (int x = 0; x < kMatrixWidth; x++) {
+      backgroundLayer.drawPixel(x, y, {(uint8_t)(x * 8 + hue), (uint8_t)(y * 8 - hue), hue});
+    }
+  }
+  backgroundLayer.swapBuffers();
+  hue++;
+
+  if (millis() - lastPrintMillis >= 1000) {
+    lastPrintMillis = millis();
+
+    uint32_t cyclesPerFrame = matrix.getCalcCyclesPerFrame();
+    uint32_t maxCyclesPerRow = matrix.getMaxCalcCyclesPerRow();
+    uint32_t nsPerCycleTimes1000 = 1000000 / cpuCyclesPerMicrosecond();
+
+    Serial.print("refresh: ");
+    Serial.print(matrix.getRefreshRate());
+    Serial.print("  cycles/frame: ");
+    Serial.print(cyclesPerFrame);
+#if defined(ESP32)
+    Serial.print("  elapsed: ");
+    Serial.print(matrix.getCalcElapsedCyclesPerFrame());
+#endif
+    Serial.print("  ns/row: ");
+    Serial.print((uint32_t)((uint64_t)cyclesPerFrame * nsPerCycleTimes1000 / 1000 / CONVERT_PANELTYPE_TO_MATRIXSCANMOD(kPanelType)));
+    Serial.print("  max ns/row: ");
+    Serial.print((uint32_t)((uint64_t)maxCyclesPerRow * nsPerCycleTimes1000 / 1000));
+    Serial.print("  bytes/row: ");
+    Serial.println(sizeof(decltype(matrix)::rowDataStruct));
+
+    if (matrix.getRefreshRateLoweredFlag())
+      Serial.println("refresh rate was lowered, calculations couldn't keep up");
+  }
+}
@@ -52,7 +52,7 @@ SMARTMATRIX_ALLOCATE_SCROLLING_LAYER(scrollingLayer, kMatrixWidth, kMatrixHeight
 const uint16_t kApaMatrixWidth = 8;          // adjust this to your APA matrix/strip
 const uint16_t kApaMatrixHeight = 8;         // set kApaMatrixHeight to 1 for a strip
 const uint8_t kApaRefreshDepth = 36;        // not used for APA matrices as of now
-const uint8_t kApaDmaBufferRows = 1;        // not used for APA matrices as of now
+const uint8_t kApaDmaBufferRows = 2;        // number of frame buffers, minimum 2: one is refreshed while the next is calculated
 const uint8_t kApaPanelType = 0;            // not used for APA matrices as of now
 const uint32_t kApaMatrixOptions = (SM_APA102_OPTIONS_COLOR_ORDER_BGR);      // The default color order is BGR, change here to match your LEDs
 const uint8_t kApaBackgroundLayerOptions = (SM_BACKGROUND_OPTIONS_NONE);
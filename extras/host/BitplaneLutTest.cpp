@@ -0,0 +1,184 @@
+/*
+ * SmartMatrix Library - Host test for the Teensy 4 bitplane tables calculated in calculateBitplaneLUTs()
+ *
+ * Runs the Teensy 4 calc class with a layer that draws new pseudo-random pixels every frame, and checks every refresh row against
+ * one built with the per-bit masks and shifts used by earlier versions of loadMatrixBuffers48(), for every refresh depth.  HUB12
+ * mode (which inverts r0) and SM_HUB75_OPTIONS_T4_CLK_PIN_ALT (which changes the FlexIO pin configuration the tables are built
+ * from) are checked at depths that do and don't need the low byte of each color channel.
+ *
+ * Usage: BitplaneLutTest
+ */
+
+#include <MatrixHardware_Teensy4_ShieldV5.h>
+#include "HostSmartMatrix.h"
+
+const uint16_t kTestWidth = 64;
+const uint16_t kTestHeight = 32;
+const unsigned char kTestPanelType = SM_PANELTYPE_HUB75_32ROW_MOD16SCAN;
+const int kTestFrames = 4;
+const int kMaxReportedMismatches = 10;
+
+// every frame has different pixels, with each channel independent of the others
+class BitplaneTestLayer : public SM_Layer {
+    public:
+        BitplaneTestLayer() {
+            nextLayer = NULL;
+            matrixWidth = kTestWidth;
+            matrixHeight = kTestHeight;
+            frame = 0;
+        }
+
+        rgb48 getPixel(uint16_t x, uint16_t y) {
+            return rgb48(hashPixel(x, y, 0), hashPixel(x, y, 1), hashPixel(x, y, 2));
+        }
+
+        void begin() {}
+        void frameRefreshCallback() { frame++; }
+
+        void fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts = 0) {
+            for(int x=0; x<kTestWidth; x++)
+                refreshRow[x] = getPixel(x, hardwareY);
+        }
+
+        void fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts = 0) {}
+
+    private:
+        uint16_t hashPixel(uint16_t x, uint16_t y, int channel) {
+            uint32_t hash = (x * 73856093UL) ^ (y * 19349663UL) ^ ((channel + 1) * 83492791UL) ^ (frame * 2654435761UL);
+            hash ^= hash >> 13;
+            hash *= 0x5bd1e995UL;
+            hash ^= hash >> 15;
+            return hash;
+        }
+
+        uint32_t frame;
+};
+
+// the per-pixel bit extraction from before calculateBitplaneLUTs(), this panel doesn't need the refresh buffer map
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+static void referenceLoadMatrixBuffers48(typename SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rowDataStruct * currentRowDataPtr,
+    unsigned int currentRow, BitplaneTestLayer & testLayer) {
+
+    typedef SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags> Refresh;
+
+    for (int ind = 0; ind < matrixWidth; ind++) {
+        rgb48 pixel0 = testLayer.getPixel(ind, currentRow);
+        rgb48 pixel1 = testLayer.getPixel(ind, currentRow + ROW_PAIR_OFFSET);
+        uint16_t r0 = pixel0.red, g0 = pixel0.green, b0 = pixel0.blue;
+        uint16_t r1 = pixel1.red, g1 = pixel1.green, b1 = pixel1.blue;
+
+        if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE) {
+            r0 = ~r0;
+        }
+
+        uint32_t rgbdata;
+        uint8_t shift = (16 - COLOR_DEPTH_BITS);
+        uint16_t mask = 1 << shift;
+
+        for (int bitindex = 0; bitindex < COLOR_DEPTH_BITS; bitindex++) {
+            rgbdata  = (r0 & mask) << (Refresh::getFlexPinConfig().r0);
+            rgbdata |= (g0 & mask) << (Refresh::getFlexPinConfig().g0);
+            rgbdata |= (b0 & mask) << (Refresh::getFlexPinConfig().b0);
+            rgbdata |= (r1 & mask) << (Refresh::getFlexPinConfig().r1);
+            rgbdata |= (g1 & mask) << (Refresh::getFlexPinConfig().g1);
+            rgbdata |= (b1 & mask) << (Refresh::getFlexPinConfig().b1);
+            rgbdata >>= shift;
+
+            shift++;
+            mask <<= 1;
+
+            currentRowDataPtr->rowbits[bitindex].data[PAD_PIXELS + ind] = rgbdata;
+        }
+    }
+    currentRowDataPtr->rowbits[0].rowAddress = currentRow;
+}
+
+// the row buffer has one row for each refresh row, so every call to rowCalculationISR() recalculates the whole frame in order
+template <int refreshDepth, uint32_t optionFlags>
+static bool testBitplaneLUTs(const char * name) {
+    const int matrixWidth = kTestWidth;
+    const int matrixHeight = kTestHeight;
+    const unsigned char panelType = kTestPanelType;
+
+    typedef SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags> Refresh;
+    typedef typename Refresh::rowDataStruct rowDataStruct;
+
+    static volatile rowDataStruct rowsDataBuffer[MATRIX_SCAN_MOD];
+    static rowDataStruct referenceRow;
+    Refresh matrixRefresh(MATRIX_SCAN_MOD, rowsDataBuffer);
+    SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags> matrix(MATRIX_SCAN_MOD, rowsDataBuffer);
+    BitplaneTestLayer testLayer;
+
+    matrix.addLayer(&testLayer);
+    matrix.begin();
+
+    int mismatches = 0;
+    for(int frame = 0; frame < kTestFrames; frame++) {
+        if(frame)
+            rowCalculationISR<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>();
+
+        for(int currentRow = 0; currentRow < MATRIX_SCAN_MOD; currentRow++) {
+            memset(&referenceRow, 0, sizeof(referenceRow));
+            referenceLoadMatrixBuffers48<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>(&referenceRow, currentRow, testLayer);
+
+            const volatile rowDataStruct & sentRow = rowsDataBuffer[currentRow];
+            if(sentRow.rowbits[0].rowAddress != referenceRow.rowbits[0].rowAddress) {
+                fprintf(stderr, "%s frame %d row %d: address %08x, expected %08x\n", name, frame, currentRow,
+                    (unsigned int)sentRow.rowbits[0].rowAddress, (unsigned int)referenceRow.rowbits[0].rowAddress);
+                mismatches++;
+            }
+
+            for(int bitindex = 0; bitindex < COLOR_DEPTH_BITS; bitindex++) {
+                for(int position = 0; position < PAD_PIXELS + PIXELS_PER_LATCH; position++) {
+                    uint16_t sent = sentRow.rowbits[bitindex].data[position];
+                    uint16_t expected = referenceRow.rowbits[bitindex].data[position];
+                    if(sent == expected)
+                        continue;
+
+                    if(mismatches < kMaxReportedMismatches) {
+                        fprintf(stderr, "%s frame %d row %d bitplane %d position %d: %04x, expected %04x\n",
+                            name, frame, currentRow, bitindex, position - PAD_PIXELS, sent, expected);
+                    }
+                    mismatches++;
+                }
+            }
+        }
+    }
+
+    if(mismatches)
+        fprintf(stderr, "%s: %d differences\n", name, mismatches);
+    return !mismatches;
+}
+
+int main(int argc, char ** argv) {
+    bool passed = true;
+
+    if(!testBitplaneLUTs<3, SM_HUB75_OPTIONS_NONE>("depth 3")) passed = false;
+    if(!testBitplaneLUTs<6, SM_HUB75_OPTIONS_NONE>("depth 6")) passed = false;
+    if(!testBitplaneLUTs<9, SM_HUB75_OPTIONS_NONE>("depth 9")) passed = false;
+    if(!testBitplaneLUTs<12, SM_HUB75_OPTIONS_NONE>("depth 12")) passed = false;
+    if(!testBitplaneLUTs<15, SM_HUB75_OPTIONS_NONE>("depth 15")) passed = false;
+    if(!testBitplaneLUTs<18, SM_HUB75_OPTIONS_NONE>("depth 18")) passed = false;
+    if(!testBitplaneLUTs<21, SM_HUB75_OPTIONS_NONE>("depth 21")) passed = false;
+    if(!testBitplaneLUTs<24, SM_HUB75_OPTIONS_NONE>("depth 24")) passed = false;
+    if(!testBitplaneLUTs<27, SM_HUB75_OPTIONS_NONE>("depth 27")) passed = false;
+    if(!testBitplaneLUTs<30, SM_HUB75_OPTIONS_NONE>("depth 30")) passed = false;
+    if(!testBitplaneLUTs<33, SM_HUB75_OPTIONS_NONE>("depth 33")) passed = false;
+    if(!testBitplaneLUTs<36, SM_HUB75_OPTIONS_NONE>("depth 36")) passed = false;
+    if(!testBitplaneLUTs<39, SM_HUB75_OPTIONS_NONE>("depth 39")) passed = false;
+    if(!testBitplaneLUTs<42, SM_HUB75_OPTIONS_NONE>("depth 42")) passed = false;
+    if(!testBitplaneLUTs<45, SM_HUB75_OPTIONS_NONE>("depth 45")) passed = false;
+    if(!testBitplaneLUTs<48, SM_HUB75_OPTIONS_NONE>("depth 48")) passed = false;
+
+    if(!testBitplaneLUTs<24, SM_HUB75_OPTIONS_HUB12_MODE>("depth 24 HUB12")) passed = false;
+    if(!testBitplaneLUTs<27, SM_HUB75_OPTIONS_HUB12_MODE>("depth 27 HUB12")) passed = false;
+    if(!testBitplaneLUTs<48, SM_HUB75_OPTIONS_HUB12_MODE>("depth 48 HUB12")) passed = false;
+
+    if(!testBitplaneLUTs<24, SM_HUB75_OPTIONS_T4_CLK_PIN_ALT>("depth 24 CLK_PIN_ALT")) passed = false;
+    if(!testBitplaneLUTs<27, SM_HUB75_OPTIONS_T4_CLK_PIN_ALT>("depth 27 CLK_PIN_ALT")) passed = false;
+    if(!testBitplaneLUTs<48, SM_HUB75_OPTIONS_T4_CLK_PIN_ALT>("depth 48 CLK_PIN_ALT")) passed = false;
+    if(!testBitplaneLUTs<36, SM_HUB75_OPTIONS_T4_CLK_PIN_ALT | SM_HUB75_OPTIONS_HUB12_MODE>("depth 36 HUB12 CLK_PIN_ALT")) passed = false;
+
+    printf("BitplaneLutTest: %s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+/*
+ * SmartMatrix Library - Host calculation benchmark
+ *
+ * Host version of examples/CalcBenchmark: runs the refresh calculations for a list of configurations as fast as possible and
+ * prints how long they take per frame and per row.  Each CalcBenchmark_*.cpp file benchmarks the calc class of one platform,
+ * and the APA102 calc class.  The numbers only compare changes to the library on the same PC, the counters in
+ * examples/CalcBenchmark are still needed to know how much time the calculations take on the target.
+ *
+ * Usage: calcbenchmark_<platform> [-f frames] [--csv]
+ */
+
+#ifndef _SMARTMATRIX_HOST_CALCBENCHMARK_H_
+#define _SMARTMATRIX_HOST_CALCBENCHMARK_H_
+
+#include <chrono>
+#include <vector>
+
+#define COLOR_DEPTH 24
+
+const uint8_t kDmaBufferRows = 4;
+const uint8_t kApaBufferFrames = 2;
+const uint8_t kBackgroundLayerOptions = (SM_BACKGROUND_OPTIONS_NONE);
+const uint8_t kScrollingLayerOptions = (SM_SCROLLING_OPTIONS_NONE);
+
+const int kWarmupFrames = 20;
+
+struct BenchmarkOptions {
+    int frames;
+    bool csv;
+};
+
+struct BenchmarkResult {
+    const char * name;
+    double wallNsPerFrame;      // whole frame including the once-per-frame layer updates, from the host's clock
+    double calcNsPerFrame;      // only the rows, from getCalcCyclesPerFrame()
+    double nsPerRow;
+    uint32_t maxNsPerRow;       // from getMaxCalcCyclesPerRow()
+    size_t bytesPerRow;
+};
+
+static BenchmarkOptions benchmarkOptions = {200, false};
+static std::vector<BenchmarkResult> benchmarkResults;
+
+static bool parseBenchmarkOptions(int argc, char ** argv) {
+    for(int i=1; i<argc; i++) {
+        if(!strcmp(argv[i], "-f") && (i + 1 < argc)) {
+            benchmarkOptions.frames = atoi(argv[++i]);
+        } else if(!strcmp(argv[i], "--csv")) {
+            benchmarkOptions.csv = true;
+        } else {
+            fprintf(stderr, "usage: %s [-f frames] [--csv]\n", argv[0]);
+            return false;
+        }
+    }
+
+    if(benchmarkOptions.frames < 1) {
+        fprintf(stderr, "frames must be at least 1\n");
+        return false;
+    }
+    return true;
+}
+
+// draws a gradient that changes every frame, so the whole display is recalculated every frame on all platforms
+template <typename BackgroundLayer>
+static void drawBenchmarkFrame(BackgroundLayer & backgroundLayer, uint16_t width, uint16_t height, uint8_t hue) {
+    for(int y = 0; y < height; y++) {
+        for(int x = 0; x < width; x++) {
+            backgroundLayer.drawPixel(x, y, {(uint8_t)(x * 8 + hue), (uint8_t)(y * 8 - hue), hue});
+        }
+    }
+    backgroundLayer.swapBuffers(false);
+}
+
+// runFrame() calculates one frame, the swap is handled at the start of the frame so swapBuffers() never has to wait
+template <typename Matrix, typename BackgroundLayer, typename ScrollingLayer>
+static void runBenchmark(const char * name, Matrix & matrix, BackgroundLayer & backgroundLayer, ScrollingLayer & scrollingLayer,
+    uint16_t width, uint16_t height, void (*runFrame)(void), int rowsPerFrame, size_t bytesPerRow) {
+
+    scrollingLayer.setColor({0xff, 0xff, 0xff});
+    scrollingLayer.setMode(wrapForward);
+    scrollingLayer.setSpeed(40);
+    scrollingLayer.setFont(font6x10);
+    scrollingLayer.start("SmartMatrix Benchmark", -1);
+
+    uint8_t hue = 0;
+    for(int i=0; i<kWarmupFrames; i++) {
+        drawBenchmarkFrame(backgroundLayer, width, height, hue++);
+        runFrame();
+    }
+    matrix.getMaxCalcCyclesPerRow();
+
+    uint64_t wallNs = 0;
+    uint64_t calcNs = 0;
+    for(int i=0; i<benchmarkOptions.frames; i++) {
+        drawBenchmarkFrame(backgroundLayer, width, height, hue++);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        runFrame();
+        wallNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        calcNs += matrix.getCalcCyclesPerFrame();
+    }
+
+    BenchmarkResult result;
+    result.name = name;
+    result.wallNsPerFrame = (double)wallNs / benchmarkOptions.frames;
+    result.calcNsPerFrame = (double)calcNs / benchmarkOptions.frames;
+    result.nsPerRow = result.calcNsPerFrame / rowsPerFrame;
+    result.maxNsPerRow = matrix.getMaxCalcCyclesPerRow();
+    result.bytesPerRow = bytesPerRow;
+    benchmarkResults.push_back(result);
+}
+
+// results are printed at the end, as begin() prints to stdout on some platforms
+static void printBenchmarkResults(void) {
+    if(benchmarkOptions.csv) {
+        printf("config,ns/frame,calc ns/frame,ns/row,max ns/row,bytes/row\n");
+        for(const BenchmarkResult & result : benchmarkResults) {
+            printf("%s,%.0f,%.0f,%.1f,%u,%u\n", result.name, result.wallNsPerFrame, result.calcNsPerFrame, result.nsPerRow,
+                result.maxNsPerRow, (unsigned int)result.bytesPerRow);
+        }
+        return;
+    }
+
+    printf("\n%d frames per configuration, times in ns\n", benchmarkOptions.frames);
+    printf("%-44s %10s %12s %8s %11s %10s\n", "config", "ns/frame", "calc/frame", "ns/row", "max ns/row", "bytes/row");
+    for(const BenchmarkResult & result : benchmarkResults) {
+        printf("%-44s %10.0f %12.0f %8.1f %11u %10u\n", result.name, result.wallNsPerFrame, result.calcNsPerFrame, result.nsPerRow,
+            result.maxNsPerRow, (unsigned int)result.bytesPerRow);
+    }
+}
+
+// APA102 is benchmarked with every platform, the refresh sends one frame per apaRowShiftCompleteISR() call
+#define BENCHMARK_APA102(name, width, height, depth, options) { \
+    SMARTMATRIX_APA_ALLOCATE_BUFFERS(apamatrix, width, height, depth, kApaBufferFrames, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, options); \
+    SMARTMATRIX_ALLOCATE_BACKGROUND_LAYER(backgroundLayer, width, height, COLOR_DEPTH, kBackgroundLayerOptions); \
+    SMARTMATRIX_ALLOCATE_SCROLLING_LAYER(scrollingLayer, width, height, COLOR_DEPTH, kScrollingLayerOptions); \
+    apamatrix.addLayer(&backgroundLayer); \
+    apamatrix.addLayer(&scrollingLayer); \
+    apamatrix.begin(); \
+    apamatrix.setBrightness(255); \
+    backgroundLayer.enableColorCorrection(true); \
+    runBenchmark(name, apamatrix, backgroundLayer, scrollingLayer, width, height, \
+        apaRowShiftCompleteISR<depth, width, height, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, options>, height, \
+        sizeof(SmartMatrixAPA102Refresh<depth, width, height, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, options>::frameDataStruct) / height); \
+}
+
+static void benchmarkApa102(void) {
+    BENCHMARK_APA102("apa102 16x16", 16, 16, 36, SM_APA102_OPTIONS_COLOR_ORDER_BGR);
+    BENCHMARK_APA102("apa102 16x16 brightonly", 16, 16, 36, SM_APA102_OPTIONS_COLOR_ORDER_BGR | SM_APA102_OPTIONS_GBC_MODE_BRIGHTONLY);
+    BENCHMARK_APA102("apa102 16x16 2 strips", 16, 16, 36, SM_APA102_OPTIONS_COLOR_ORDER_BGR | SM_APA102_OPTIONS_PARALLEL_STRIPS(2));
+    BENCHMARK_APA102("apa102 32x32", 32, 32, 36, SM_APA102_OPTIONS_COLOR_ORDER_BGR);
+}
+
+#endif
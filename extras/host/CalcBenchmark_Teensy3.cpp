@@ -0,0 +1,53 @@
+/*
+ * SmartMatrix Library - Host calculation benchmark for the Teensy 3 calc class, see CalcBenchmark.h
+ */
+
+#include <MatrixHardware_Teensy3_ShieldV4.h>
+#include "HostSmartMatrix.h"
+#include "CalcBenchmark.h"
+
+// runs the refresh for one frame of rows, ending on the last buffer of the next frame's first rows, so the once-per-frame updates
+// (and the swap drawn before this call) happen inside the frame
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+static void runHub75Frame(void) {
+    static_assert(CONVERT_PANELTYPE_TO_MATRIXSCANMOD(panelType) % kDmaBufferRows == 0, "frames must end on a full buffer");
+
+    do {
+        rowCalculationISR<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>();
+    } while(hostLastRowWritten != kDmaBufferRows - 1);
+}
+
+#define BENCHMARK_HUB75(name, width, height, depth, panelType, options) { \
+    SMARTMATRIX_ALLOCATE_BUFFERS(matrix, width, height, depth, kDmaBufferRows, panelType, options); \
+    SMARTMATRIX_ALLOCATE_BACKGROUND_LAYER(backgroundLayer, width, height, COLOR_DEPTH, kBackgroundLayerOptions); \
+    SMARTMATRIX_ALLOCATE_SCROLLING_LAYER(scrollingLayer, width, height, COLOR_DEPTH, kScrollingLayerOptions); \
+    matrix.addLayer(&backgroundLayer); \
+    matrix.addLayer(&scrollingLayer); \
+    matrix.begin(); \
+    matrix.setBrightness(255); \
+    backgroundLayer.enableColorCorrection(true); \
+    runBenchmark(name, matrix, backgroundLayer, scrollingLayer, width, height, runHub75Frame<depth, width, height, panelType, options>, \
+        CONVERT_PANELTYPE_TO_MATRIXSCANMOD(panelType), sizeof(decltype(matrix)::rowDataStruct)); \
+}
+
+int main(int argc, char ** argv) {
+    if(!parseBenchmarkOptions(argc, argv))
+        return 1;
+
+    BENCHMARK_HUB75("teensy3 32x32 24", 32, 32, 24, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE);
+    BENCHMARK_HUB75("teensy3 32x32 36", 32, 32, 36, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE);
+    BENCHMARK_HUB75("teensy3 32x32 48", 32, 32, 48, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE);
+    BENCHMARK_HUB75("teensy3 64x32 36", 64, 32, 36, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE);
+    BENCHMARK_HUB75("teensy3 64x64 36 64row", 64, 64, 36, SM_PANELTYPE_HUB75_64ROW_MOD32SCAN, SM_HUB75_OPTIONS_NONE);
+    BENCHMARK_HUB75("teensy3 64x64 36 stacked", 64, 64, 36, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE);
+    BENCHMARK_HUB75("teensy3 64x64 36 stacked c-shape", 64, 64, 36, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_C_SHAPE_STACKING);
+    BENCHMARK_HUB75("teensy3 32x16 36 mod8", 32, 16, 36, SM_PANELTYPE_HUB75_16ROW_MOD8SCAN, SM_HUB75_OPTIONS_NONE);
+    BENCHMARK_HUB75("teensy3 32x16 36 mod4", 32, 16, 36, SM_PANELTYPE_HUB75_16ROW_32COL_MOD4SCAN, SM_HUB75_OPTIONS_NONE);
+    BENCHMARK_HUB75("teensy3 64x32 36 mod8", 64, 32, 36, SM_PANELTYPE_HUB75_32ROW_64COL_MOD8SCAN, SM_HUB75_OPTIONS_NONE);
+    BENCHMARK_HUB75("teensy3 32x32 36 dither", 32, 32, 36, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_TEMPORAL_DITHER);
+
+    benchmarkApa102();
+
+    printBenchmarkResults();
+    return 0;
+}
@@ -0,0 +1,261 @@
+/*
+ * SmartMatrix Library - Host test for the OE and LAT templates calculated in calculateControlBitTemplates() in the ESP32 calc class
+ *
+ * loadMatrixBuffers48/24() take the OE and LAT bits for each position from the templates, and only add the ADDX and RGB bits.
+ * This loads every refresh row after calculating the templates, and checks every word written to the I2S frame buffer against
+ * one built with the per-pixel OE, LAT and ADDX code used by earlier versions of loadMatrixBuffers48().  The OE bits depend on
+ * the brightness and lsbMsbTransitionBit, so a range of brightness values is checked with every lsbMsbTransitionBit the refresh
+ * class can choose, at each color depth, with and without the wider FM6126A latch pulse and HUB12 mode.
+ *
+ * Usage: ControlBitTest_Esp32
+ */
+
+#include <MatrixHardware_ESP32_V0.h>
+#include "HostSmartMatrix.h"
+
+const int kMaxReportedMismatches = 10;
+
+// values passed to setBrightness()
+const uint8_t kTestBrightness[] = { 255, 254, 200, 128, 100, 37, 8, 1, 0 };
+
+// pixels are independent of each other and of the channel
+class ControlBitTestLayer : public SM_Layer {
+    public:
+        ControlBitTestLayer(uint16_t width, uint16_t height) {
+            nextLayer = NULL;
+            matrixWidth = width;
+            matrixHeight = height;
+        }
+
+        rgb48 getPixel(uint16_t x, uint16_t y) {
+            return rgb48(hashPixel(x, y, 0), hashPixel(x, y, 1), hashPixel(x, y, 2));
+        }
+
+        void begin() {}
+        void frameRefreshCallback() {}
+
+        void fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts = 0) {
+            for(int x=0; x<matrixWidth; x++)
+                refreshRow[x] = getPixel(x, hardwareY);
+        }
+
+        void fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts = 0) {
+            for(int x=0; x<matrixWidth; x++)
+                refreshRow[x] = rgb24(getPixel(x, hardwareY));
+        }
+
+    private:
+        uint16_t hashPixel(uint16_t x, uint16_t y, int channel) {
+            uint32_t hash = (x * 73856093UL) ^ (y * 19349663UL) ^ ((channel + 1) * 83492791UL);
+            hash ^= hash >> 13;
+            hash *= 0x5bd1e995UL;
+            hash ^= hash >> 15;
+            return hash;
+        }
+};
+
+// friend of the calc class, so it can set the brightness and lsbMsbTransitionBit used by calculateControlBitTemplates()
+struct SmartMatrixControlBitTest {
+    // the per-pixel code from before calculateControlBitTemplates(), these panels don't need the refresh buffer map
+    template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+    static void referenceLoadMatrixBuffers(typename SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::frameStruct * frameBuffer,
+        int currentRow, int lsbMsbTransitionBit, int shiftedBrightness, ControlBitTestLayer & testLayer) {
+
+        for(int j=0; j<COLOR_DEPTH_BITS; j++) {
+            int maskoffset = 0;
+            if(COLOR_DEPTH_BITS == 12)   // 36-bit color
+                maskoffset = 4;
+
+            // rgb24 is used for 24-bit color, with 8 bits per channel
+            uint16_t mask = (1 << (j + maskoffset));
+            if(COLOR_DEPTH_BITS == 8)
+                mask <<= 8;
+
+            typename SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rowBitStruct *p=&(frameBuffer->rowdata[currentRow].rowbits[j]);
+
+            for(int refreshBufferPosition=0; refreshBufferPosition < PIXELS_PER_LATCH; refreshBufferPosition++) {
+                int v=0;
+
+#if (CLKS_DURING_LATCH == 0)
+                int gpioRowAddress = currentRow;
+                if(j == 0)
+                    gpioRowAddress = currentRow-1;
+
+                if (gpioRowAddress & 0x01) v|=BIT_A;
+                if (gpioRowAddress & 0x02) v|=BIT_B;
+                if (gpioRowAddress & 0x04) v|=BIT_C;
+                if (gpioRowAddress & 0x08) v|=BIT_D;
+                if (gpioRowAddress & 0x10) v|=BIT_E;
+
+                if((refreshBufferPosition) == 0) v|=BIT_OE;
+
+                if((refreshBufferPosition) == PIXELS_PER_LATCH-1) v|=BIT_LAT;
+
+                if(optionFlags & SMARTMATRIX_OPTIONS_FM6126A_RESET_AT_START) {
+                    if((refreshBufferPosition) == PIXELS_PER_LATCH-2) v|=BIT_LAT;
+                    if((refreshBufferPosition) == PIXELS_PER_LATCH-3) v|=BIT_LAT;
+                }
+#endif
+
+                if((j > lsbMsbTransitionBit || !j) && ((refreshBufferPosition) >= shiftedBrightness)) v|=BIT_OE;
+
+                if(j && j <= lsbMsbTransitionBit) {
+                    int lsbBrightness = shiftedBrightness >> (lsbMsbTransitionBit - j + 1);
+                    if((refreshBufferPosition) >= lsbBrightness) v|=BIT_OE;
+                }
+
+#if (CLKS_DURING_LATCH > 0)
+                if((refreshBufferPosition)==PIXELS_PER_LATCH-1) v|=BIT_OE;
+#else
+                if((refreshBufferPosition)>=PIXELS_PER_LATCH-2) v|=BIT_OE;
+#endif
+
+                rgb48 pixel0 = testLayer.getPixel(refreshBufferPosition, currentRow);
+                rgb48 pixel1 = testLayer.getPixel(refreshBufferPosition, currentRow + ROW_PAIR_OFFSET);
+
+                if (pixel0.red & mask)
+                    v|=BIT_R1;
+                if (pixel0.green & mask)
+                    v|=BIT_G1;
+                if (pixel0.blue & mask)
+                    v|=BIT_B1;
+                if (pixel1.red & mask)
+                    v|=BIT_R2;
+                if (pixel1.green & mask)
+                    v|=BIT_G2;
+                if (pixel1.blue & mask)
+                    v|=BIT_B2;
+
+                if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE) {
+                    if(v & BIT_OE) {
+                        v = v & ~(BIT_OE);
+                    } else {
+                        v |= BIT_OE;
+                    }
+
+                    if(v & BIT_R1) {
+                        v = v & ~(BIT_R1);
+                    } else {
+                        v |= BIT_R1;
+                    }
+                }
+
+                if(MATRIX_I2S_MODE == I2S_PARALLEL_BITS_8) {
+                    if(refreshBufferPosition%4 < 2) {
+                        p->data[(refreshBufferPosition)+2] = v;
+                    } else {
+                        p->data[(refreshBufferPosition)-2] = v;
+                    }
+                } else {
+                    if(refreshBufferPosition%2){
+                        p->data[(refreshBufferPosition)-1] = v;
+                    } else {
+                        p->data[(refreshBufferPosition)+1] = v;
+                    }
+                }
+            }
+
+#if (CLKS_DURING_LATCH > 0)
+            // the latch section isn't affected by the templates, compare it with what the calc class wrote
+            for(int k=PIXELS_PER_LATCH; k < PIXELS_PER_LATCH + CLKS_DURING_LATCH; k++)
+                p->data[k] = frameBuffer->rowdata[currentRow].rowbits[j].data[k];
+#endif
+        }
+    }
+
+    template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+    static int compareFrames(const char * name, ControlBitTestLayer & testLayer) {
+        typedef SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags> Calc;
+        typedef typename Calc::frameStruct frameStruct;
+
+        static frameStruct frame;
+        static frameStruct referenceFrame;
+        int mismatches = 0;
+
+        for(unsigned int b = 0; b < sizeof(kTestBrightness); b++) {
+            // the same as setBrightness() and matrixCalculations() with no brightness shifts requested by the layers
+            Calc::shiftedBrightness = (PIXELS_PER_LATCH * kTestBrightness[b]) / 255;
+
+            for(int lsbMsbTransitionBit = 0; lsbMsbTransitionBit < COLOR_DEPTH_BITS; lsbMsbTransitionBit++) {
+                Calc::lsbMsbTransitionBit = lsbMsbTransitionBit;
+                Calc::calculateControlBitTemplates();
+
+                // every word is written by loadMatrixBuffers48/24(), fill with different values so skipped words are found
+                memset(&frame, 0x55, sizeof(frame));
+                memset(&referenceFrame, 0xAA, sizeof(referenceFrame));
+
+                for(int currentRow = 0; currentRow < MATRIX_SCAN_MOD; currentRow++) {
+                    if(COLOR_DEPTH_BITS == 8)
+                        Calc::loadMatrixBuffers24(&frame, currentRow, lsbMsbTransitionBit);
+                    else
+                        Calc::loadMatrixBuffers48(&frame, currentRow, lsbMsbTransitionBit);
+
+                    referenceLoadMatrixBuffers<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>(&referenceFrame, currentRow,
+                        lsbMsbTransitionBit, Calc::shiftedBrightness, testLayer);
+                }
+
+                for(int currentRow = 0; currentRow < MATRIX_SCAN_MOD; currentRow++) {
+                    for(int j = 0; j < COLOR_DEPTH_BITS; j++) {
+                        const MATRIX_DATA_STORAGE_TYPE * data = frame.rowdata[currentRow].rowbits[j].data;
+                        const MATRIX_DATA_STORAGE_TYPE * expected = referenceFrame.rowdata[currentRow].rowbits[j].data;
+
+                        for(int k = 0; k < PIXELS_PER_LATCH + CLKS_DURING_LATCH; k++) {
+                            if(data[k] == expected[k])
+                                continue;
+
+                            if(mismatches < kMaxReportedMismatches) {
+                                fprintf(stderr, "%s brightness %d lsbMsbTransitionBit %d row %d bitplane %d word %d: %04x, expected %04x\n", name,
+                                    kTestBrightness[b], lsbMsbTransitionBit, currentRow, j, k, (unsigned int)data[k], (unsigned int)expected[k]);
+                            }
+                            mismatches++;
+                        }
+                    }
+                }
+            }
+        }
+
+        return mismatches;
+    }
+};
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+static bool testControlBits(const char * name) {
+    static_assert(!REFRESH_BUFFER_MAP_REQUIRED && MATRIX_STACK_HEIGHT == 1, "the reference loads pixels in order from a single panel");
+
+    SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags> matrixRefresh;
+    SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags> matrix;
+    ControlBitTestLayer testLayer(matrixWidth, matrixHeight);
+
+    // begin() allocates the temporary rows, the calc task is idle once the first frame is written
+    matrix.addLayer(&testLayer);
+    matrix.begin();
+    hostWaitForRefreshStarted();
+    hostWaitForTasksIdle();
+
+    int mismatches = SmartMatrixControlBitTest::compareFrames<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>(name, testLayer);
+
+    if(mismatches)
+        fprintf(stderr, "%s: %d words differ\n", name, mismatches);
+    return !mismatches;
+}
+
+int main(int argc, char ** argv) {
+    bool passed = true;
+
+    if(!testControlBits<24, 32, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE>("32x32 24")) passed = false;
+    if(!testControlBits<36, 32, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE>("32x32 36")) passed = false;
+    if(!testControlBits<48, 64, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE>("64x32 48")) passed = false;
+    if(!testControlBits<36, 64, 64, SM_PANELTYPE_HUB75_64ROW_MOD32SCAN, SM_HUB75_OPTIONS_NONE>("64x64 36 64row")) passed = false;
+    if(!testControlBits<36, 32, 16, SM_PANELTYPE_HUB75_16ROW_MOD8SCAN, SM_HUB75_OPTIONS_NONE>("32x16 36 mod8")) passed = false;
+
+    if(!testControlBits<24, 32, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_FM6126A_RESET_AT_START>("32x32 24 FM6126A")) passed = false;
+    if(!testControlBits<36, 64, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_FM6126A_RESET_AT_START>("64x32 36 FM6126A")) passed = false;
+
+    if(!testControlBits<24, 32, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_HUB12_MODE>("32x32 24 HUB12")) passed = false;
+    if(!testControlBits<48, 32, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_HUB12_MODE>("32x32 48 HUB12")) passed = false;
+    if(!testControlBits<36, 32, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN,
+        SM_HUB75_OPTIONS_FM6126A_RESET_AT_START | SM_HUB75_OPTIONS_HUB12_MODE>("32x32 36 FM6126A HUB12")) passed = false;
+
+    printf("ControlBitTest_Esp32: %s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
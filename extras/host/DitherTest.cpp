@@ -0,0 +1,85 @@
+/*
+ * SmartMatrix Library - Host test for the temporal dither helpers in MatrixCommonHub75.h
+ *
+ * hub75DitherChannel() has to saturate instead of wrapping past 0xFFFF, or the brightest colors would flicker to black.  Over the
+ * 16 frames of the 4x4 Bayer pattern, every pixel position gets each threshold once, and the average of the truncated output has
+ * to equal the input, to the 1/16 of an LSB that 16 frames can show.  Values in the top LSB are excluded from the average check, as
+ * those are kept at full brightness instead of being dithered.
+ *
+ * Usage: DitherTest
+ */
+
+#include <stdio.h>
+#include "MatrixCommonHub75.h"
+
+const int kFramesPerPattern = 16;
+const int kMaxReportedMismatches = 10;
+
+static bool testSaturation(void) {
+    int mismatches = 0;
+
+    for(uint32_t threshold = 0; threshold <= 0x0800; threshold++) {
+        for(uint32_t value = 0; value <= 0xffff; value++) {
+            uint32_t expected = (value + threshold > 0xffff) ? 0xffff : value + threshold;
+            uint16_t result = hub75DitherChannel(value, threshold);
+            if(result == expected)
+                continue;
+
+            if(mismatches < kMaxReportedMismatches)
+                fprintf(stderr, "hub75DitherChannel(0x%04x, 0x%04x) = 0x%04x, expected 0x%04x\n", value, threshold, result, expected);
+            mismatches++;
+        }
+    }
+
+    return !mismatches;
+}
+
+// truncatedBits covers the refresh depths used with rgb48 (16 - refreshDepth/3) and more
+static bool testAverage(uint8_t truncatedBits) {
+    uint32_t lsb = 1UL << truncatedBits;
+    int mismatches = 0;
+
+    for(int y = 0; y < 4; y++) {
+        for(int x = 0; x < 4; x++) {
+            // frame wraps at 256, start close to it to check the pattern still covers every threshold
+            for(int firstFrame = 0; firstFrame < 256; firstFrame += 250) {
+                for(uint32_t value = 0; value <= 0xffff - lsb; value++) {
+                    uint32_t sum = 0;
+                    for(int i = 0; i < kFramesPerPattern; i++) {
+                        uint16_t threshold = hub75DitherThreshold(x, y, (uint8_t)(firstFrame + i), truncatedBits);
+                        sum += hub75DitherChannel(value, threshold) & ~(lsb - 1);
+                    }
+
+                    // sum / 16 is value rounded to the nearest 1/16 LSB, which is exact when value is a multiple of 1/16 LSB
+                    uint32_t remainder = value & (lsb - 1);
+                    uint32_t expected = ((value - remainder) * kFramesPerPattern) + (((remainder * kFramesPerPattern) + (lsb / 2)) & ~(lsb - 1));
+                    if(sum == expected)
+                        continue;
+
+                    if(mismatches < kMaxReportedMismatches) {
+                        fprintf(stderr, "truncatedBits %d pixel %d,%d frame %d value 0x%04x: 16 frame sum 0x%05x, expected 0x%05x\n",
+                            truncatedBits, x, y, firstFrame, value, sum, expected);
+                    }
+                    mismatches++;
+                }
+            }
+        }
+    }
+
+    return !mismatches;
+}
+
+int main(int argc, char ** argv) {
+    bool passed = true;
+
+    if(!testSaturation())
+        passed = false;
+
+    for(int truncatedBits = 0; truncatedBits <= 12; truncatedBits++) {
+        if(!testAverage(truncatedBits))
+            passed = false;
+    }
+
+    printf("DitherTest: %s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+/*
+ * SmartMatrix Library - Host test for the gamma tables generated in MatrixCommon.h
+ *
+ * The tables generated with the default SMARTMATRIX_GAMMA must match the literal tables used by earlier versions of the library,
+ * kept in GammaTablesReference.h.
+ *
+ * Usage: GammaTableTest
+ */
+
+#include "Arduino.h"
+#include "MatrixCommon.h"
+#include "GammaTablesReference.h"
+
+template <typename T, int size>
+static bool compareTable(const char * name, const T (&generated)[size], const T (&reference)[size]) {
+    int mismatches = 0;
+    for(int i=0; i<size; i++) {
+        if(generated[i] == reference[i])
+            continue;
+
+        if(mismatches < 10)
+            fprintf(stderr, "%s[%d]: generated 0x%04x, expected 0x%04x\n", name, i, generated[i], reference[i]);
+        mismatches++;
+    }
+
+    if(mismatches)
+        fprintf(stderr, "%s: %d of %d entries differ\n", name, mismatches, size);
+    return !mismatches;
+}
+
+int main(int argc, char ** argv) {
+    bool passed = true;
+
+    if(!compareTable("lightPowerMap16bit", lightPowerMap16bit, referenceLightPowerMap16bit))
+        passed = false;
+    if(!compareTable("lightPowerMap4bit", lightPowerMap4bit, referenceLightPowerMap4bit))
+        passed = false;
+    if(!compareTable("lightPowerMap12to16bit", lightPowerMap12to16bit, referenceLightPowerMap12to16bit))
+        passed = false;
+
+    printf("GammaTableTest: %s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
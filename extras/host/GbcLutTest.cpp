@@ -0,0 +1,186 @@
+/*
+ * SmartMatrix Library - Host test for the APA102 GBC tables calculated in calculateGbcLUTs()
+ *
+ * Runs the APA102 calc class with a layer that puts every 16-bit value in every channel, at every brightness, and checks each pixel
+ * sent against the per-pixel divides and loops used by earlier versions of the library, for each GBC mode.  Every value is tested
+ * both as the brightest channel of its pixel and as a dimmer channel, so the "DEFAULT" reciprocals are checked against the
+ * numerators they divide.
+ *
+ * Usage: GbcLutTest
+ */
+
+#include <MatrixHardware_Teensy4_ShieldV5.h>
+#include "HostSmartMatrix.h"
+
+// one pixel for each 16-bit value, the calc class keeps the row in an unsigned char so the matrix can't be 256 rows high
+const uint16_t kTestWidth = 512;
+const uint16_t kTestHeight = 128;
+const int kTestDepth = 36;
+const int kTestPatterns = 2;
+const int kMaxReportedMismatches = 10;
+
+// pattern 0 sets all channels to the pixel's value, pattern 1 adds channels that are brighter and dimmer than it
+class GbcTestLayer : public SM_Layer {
+    public:
+        GbcTestLayer() {
+            nextLayer = NULL;
+            matrixWidth = kTestWidth;
+            matrixHeight = kTestHeight;
+            pattern = 0;
+        }
+
+        static rgb48 getPixel(int pattern, uint16_t x, uint16_t y) {
+            uint16_t value = y * kTestWidth + x;
+
+            if(!pattern)
+                return rgb48(value, value, value);
+            return rgb48(value, (uint16_t)(value * 40503), (uint16_t)~value);
+        }
+
+        void begin() {}
+        void frameRefreshCallback() {}
+
+        void fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts = 0) {
+            for(int x=0; x<kTestWidth; x++)
+                refreshRow[x] = getPixel(pattern, x, hardwareY);
+        }
+
+        void fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts = 0) {}
+
+        int pattern;
+};
+
+// the per-pixel calculations from before calculateGbcLUTs(), with dimmingMaximum = 255
+static void referencePixel(uint32_t gbcMode, uint8_t brightness, rgb48 pixel, uint8_t output[4]) {
+    uint16_t tempPixel1 = pixel.red;
+    uint16_t tempPixel2 = pixel.green;
+    uint16_t tempPixel3 = pixel.blue;
+
+    if(gbcMode == SM_APA102_OPTIONS_GBC_MODE_DEFAULT) {
+        uint8_t globalbrightness = (0x1F * brightness) / 255;
+
+        uint16_t maxrgb = max(max(tempPixel1, tempPixel2), tempPixel3);
+
+        uint16_t value  = (maxrgb * 31 * globalbrightness) / 0x10000 / 31;
+
+        output[0] = 0xE0 | (value+1);
+        output[1] = ((tempPixel1 * globalbrightness) / (value + 1)) >> 8;
+        output[2] = ((tempPixel2 * globalbrightness) / (value + 1)) >> 8;
+        output[3] = ((tempPixel3 * globalbrightness) / (value + 1)) >> 8;
+    }
+
+    if(gbcMode == SM_APA102_OPTIONS_GBC_MODE_SIMPLE) {
+        uint8_t globalbrightness = (0x20UL * brightness) / 255;
+        uint8_t localshift = 0;
+
+        if(globalbrightness == 0x20)
+            globalbrightness = 0x1f;
+
+        uint16_t value = tempPixel1 | tempPixel2 | tempPixel3;
+
+        while(!((value << localshift) & 0x8000) && (globalbrightness > 1)) {
+            globalbrightness >>= 1;
+            localshift++;
+        }
+
+        localshift = 8 - localshift;
+
+        output[0] = 0xE0 | globalbrightness;
+        output[1] = tempPixel1 >> localshift;
+        output[2] = tempPixel2 >> localshift;
+        output[3] = tempPixel3 >> localshift;
+    }
+
+    if(gbcMode == SM_APA102_OPTIONS_GBC_MODE_BRIGHTONLY) {
+        uint8_t globalbrightness = (0x20UL * brightness) / 255;
+
+        if(globalbrightness == 0x20)
+            globalbrightness = 0x1f;
+
+        output[0] = 0xE0 | globalbrightness;
+        output[1] = tempPixel1 >> 8;
+        output[2] = tempPixel2 >> 8;
+        output[3] = tempPixel3 >> 8;
+    }
+
+    if(gbcMode == SM_APA102_OPTIONS_GBC_MODE_NONE) {
+        output[0] = 0xFF;
+
+        tempPixel3 = (tempPixel3 * brightness) / 255;
+        tempPixel2 = (tempPixel2 * brightness) / 255;
+        tempPixel1 = (tempPixel1 * brightness) / 255;
+
+        output[1] = tempPixel1 >> 8;
+        output[2] = tempPixel2 >> 8;
+        output[3] = tempPixel3 >> 8;
+    }
+}
+
+// frames points to the first of numFrameBuffers frames, each frameBytes long
+template <typename Matrix>
+static bool testGbcMode(const char * name, uint32_t gbcMode, Matrix & apamatrix, GbcTestLayer & testLayer, void (*runFrame)(void),
+    const uint8_t * frames, size_t frameBytes, int numFrameBuffers) {
+
+    int mismatches = 0;
+    for(int brightness = 0; brightness <= 255; brightness++) {
+        for(int pattern = 0; pattern < kTestPatterns; pattern++) {
+            apamatrix.setBrightness(brightness);
+            testLayer.pattern = pattern;
+
+            // every row is recalculated once for each frame buffer, after that all the buffers hold the same frame
+            for(int i=0; i<numFrameBuffers * 2; i++)
+                runFrame();
+
+            for(int frame = 0; frame < numFrameBuffers; frame++) {
+                for(int y=0; y<kTestHeight; y++) {
+                    for(int x=0; x<kTestWidth; x++) {
+                        // serpentine layout, one strip
+                        int column = (y % 2) ? (kTestWidth - 1 - x) : x;
+                        const uint8_t * sent = &frames[(frame * frameBytes) + 4 + ((y * kTestWidth + column) * 4)];
+
+                        rgb48 pixel = GbcTestLayer::getPixel(pattern, x, y);
+                        uint8_t expected[4];
+                        referencePixel(gbcMode, brightness, pixel, expected);
+
+                        if(!memcmp(sent, expected, sizeof(expected)))
+                            continue;
+
+                        if(mismatches < kMaxReportedMismatches) {
+                            fprintf(stderr, "%s brightness %d pixel %04x %04x %04x: sent %02x %02x %02x %02x, expected %02x %02x %02x %02x\n",
+                                name, brightness, pixel.red, pixel.green, pixel.blue, sent[0], sent[1], sent[2], sent[3],
+                                expected[0], expected[1], expected[2], expected[3]);
+                        }
+                        mismatches++;
+                    }
+                }
+            }
+        }
+    }
+
+    if(mismatches)
+        fprintf(stderr, "%s: %d pixels differ\n", name, mismatches);
+    return !mismatches;
+}
+
+#define TEST_GBC_MODE(name, gbcMode) { \
+    SMARTMATRIX_APA_ALLOCATE_BUFFERS(apamatrix, kTestWidth, kTestHeight, kTestDepth, 0, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_APA102_OPTIONS_COLOR_ORDER_RGB | gbcMode); \
+    static GbcTestLayer testLayer; \
+    apamatrix.addLayer(&testLayer); \
+    apamatrix.begin(); \
+    if(!testGbcMode(name, gbcMode, apamatrix, testLayer, \
+        apaRowShiftCompleteISR<kTestDepth, kTestWidth, kTestHeight, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_APA102_OPTIONS_COLOR_ORDER_RGB | gbcMode>, \
+        frameDataBuffer[0].data, sizeof(frameDataBuffer[0]), APA102_NUM_FRAME_BUFFERS(0))) \
+        passed = false; \
+}
+
+int main(int argc, char ** argv) {
+    bool passed = true;
+
+    TEST_GBC_MODE("default", SM_APA102_OPTIONS_GBC_MODE_DEFAULT);
+    TEST_GBC_MODE("simple", SM_APA102_OPTIONS_GBC_MODE_SIMPLE);
+    TEST_GBC_MODE("brightonly", SM_APA102_OPTIONS_GBC_MODE_BRIGHTONLY);
+    TEST_GBC_MODE("none", SM_APA102_OPTIONS_GBC_MODE_NONE);
+
+    printf("GbcLutTest: %s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+/*
+ * SmartMatrix Library - Host replacement for SmartMatrix.h
+ *
+ * Includes the same headers as SmartMatrix.h, for the platform selected with SM_HOST_TEENSY3, SM_HOST_TEENSY4, or SM_HOST_ESP32,
+ * but with the refresh classes replaced by the Host*Refresh_Impl.h files in this directory.  The calc classes and layers are the
+ * real ones from src/.  Include a MatrixHardware_*.h file first, same as a sketch.
+ */
+
+#ifndef _SMARTMATRIX_HOST_H_
+#define _SMARTMATRIX_HOST_H_
+
+// the _Impl.h files include SmartMatrix.h, which would pick the platform from the compiler's defines
+#define SmartMatrix4_h
+#define SmartMatrix3_h
+
+#include <stdint.h>
+
+#include "Arduino.h"
+
+#include "MatrixCommon.h"
+#include "SpscRing_SM.h"
+#include "TripleBuffer_SM.h"
+
+#include "Layer_Scrolling.h"
+#include "Layer_Indexed.h"
+#include "Layer_Background.h"
+
+#include "MatrixCommonHub75.h"
+
+#include "MatrixCommonApa102.h"
+#include "MatrixCommonApa102Refresh.h"
+#include "MatrixCommonApa102Calc.h"
+
+#ifndef MATRIX_HARDWARE_H
+#pragma GCC error "No MatrixHardware*.h file included - You must include one before HostSmartMatrix.h"
+#endif
+
+#include "MatrixPanelMaps.h"
+
+#define BACKGROUND_MEMSECTION
+
+#if defined(SM_HOST_TEENSY3)
+    #include "MatrixTeensy3Hub75Refresh.h"
+    #include "MatrixTeensy3Hub75Calc.h"
+
+    #include "HostTeensy3Hub75Refresh_Impl.h"
+    #include "MatrixTeensy3Hub75Calc_Impl.h"
+#elif defined(SM_HOST_TEENSY4)
+    #include "MatrixTeensy4Hub75Refresh.h"
+    #include "MatrixTeensy4Hub75Calc.h"
+
+    #include "HostTeensy4Hub75Refresh_Impl.h"
+    #include "MatrixTeensy4Hub75Calc_Impl.h"
+#elif defined(SM_HOST_ESP32)
+    #include "MatrixEsp32Hub75Refresh.h"
+    #include "MatrixEsp32Hub75Calc.h"
+
+    #include "HostEsp32Hub75Refresh_Impl.h"
+    #include "MatrixEsp32Hub75Calc_Impl.h"
+#else
+#pragma GCC error "Define one of SM_HOST_TEENSY3, SM_HOST_TEENSY4, or SM_HOST_ESP32"
+#endif
+
+#include "HostApa102Refresh_Impl.h"
+#include "MatrixCommonApa102Calc_Impl.h"
+
+// same as the SmartMatrix.h macros for each platform, except APA102 always uses the Teensy 3 form, as there's no FlexIOSPI object
+#if defined(SM_HOST_TEENSY3)
+    #define SMARTMATRIX_ALLOCATE_BUFFERS(matrix_name, width, height, pwm_depth, buffer_rows, panel_type, option_flags) \
+        static SmartMatrixHub75Refresh<pwm_depth, width, height, panel_type, option_flags>::rowDataStruct rowsDataBuffer[buffer_rows]; \
+        SmartMatrixHub75Refresh<pwm_depth, width, height, panel_type, option_flags> matrix_name##Refresh(buffer_rows, rowsDataBuffer); \
+        SmartMatrixHub75Calc<pwm_depth, width, height, panel_type, option_flags> matrix_name(buffer_rows, rowsDataBuffer)
+#elif defined(SM_HOST_TEENSY4)
+    #define SMARTMATRIX_ALLOCATE_BUFFERS(matrix_name, width, height, pwm_depth, buffer_rows, panel_type, option_flags) \
+        static volatile SmartMatrixRefreshT4<pwm_depth, width, height, panel_type, option_flags>::rowDataStruct rowsDataBuffer[buffer_rows]; \
+        SmartMatrixRefreshT4<pwm_depth, width, height, panel_type, option_flags> matrix_name##Refresh(buffer_rows, rowsDataBuffer); \
+        SmartMatrixHub75Calc<pwm_depth, width, height, panel_type, option_flags> matrix_name(buffer_rows, rowsDataBuffer)
+#elif defined(SM_HOST_ESP32)
+    #define SMARTMATRIX_ALLOCATE_BUFFERS(matrix_name, width, height, pwm_depth, buffer_rows, panel_type, option_flags) \
+        SmartMatrixHub75Refresh<pwm_depth, width, height, panel_type, option_flags> matrix_name##Refresh; \
+        SmartMatrixHub75Calc<pwm_depth, width, height, panel_type, option_flags> matrix_name
+#endif
+
+#define SMARTMATRIX_APA_ALLOCATE_BUFFERS(matrix_name, width, height, pwm_depth, buffer_rows, panel_type, option_flags) \
+    static SmartMatrixAPA102Refresh<pwm_depth, width, height, panel_type, option_flags>::frameDataStruct frameDataBuffer[APA102_NUM_FRAME_BUFFERS(buffer_rows)]; \
+    SmartMatrixAPA102Refresh<pwm_depth, width, height, panel_type, option_flags> matrix_name##Refresh(buffer_rows, frameDataBuffer); \
+    SmartMatrixApaCalc<pwm_depth, width, height, panel_type, option_flags> matrix_name(buffer_rows, frameDataBuffer)
+
+#if defined(SM_HOST_ESP32)
+    #define SMARTMATRIX_ALLOCATE_BACKGROUND_LAYER(layer_name, width, height, storage_depth, background_options) \
+        typedef RGB_TYPE(storage_depth) SM_RGB; \
+        static SMLayerBackground<RGB_TYPE(storage_depth), background_options> layer_name(width, height)
+
+    #define SMARTMATRIX_ALLOCATE_SCROLLING_LAYER(layer_name, width, height, storage_depth, scrolling_options) \
+        typedef RGB_TYPE(storage_depth) SM_RGB; \
+        static SMLayerScrolling<RGB_TYPE(storage_depth), scrolling_options> layer_name(width, height)
+#else
+    #define SMARTMATRIX_ALLOCATE_BACKGROUND_LAYER(layer_name, width, height, storage_depth, background_options) \
+        typedef RGB_TYPE(storage_depth) SM_RGB; \
+        static RGB_TYPE(storage_depth) layer_name##Bitmap[SM_BACKGROUND_NUM_BUFFERS(background_options)*width*height]; \
+        static color_chan_t layer_name##colorCorrectionLUT[SM_BACKGROUND_LUT_SIZE(SM_RGB)]; \
+        static uint8_t layer_name##RowsChanged[SM_BACKGROUND_ROWS_CHANGED_BYTES(background_options, width, height)]; \
+        static SMLayerBackground<RGB_TYPE(storage_depth), background_options> layer_name(layer_name##Bitmap, width, height, layer_name##colorCorrectionLUT, layer_name##RowsChanged)
+
+    #define SMARTMATRIX_ALLOCATE_SCROLLING_LAYER(layer_name, width, height, storage_depth, scrolling_options) \
+        typedef RGB_TYPE(storage_depth) SM_RGB; \
+        static uint8_t layer_name##Bitmap[width * (height / 8)]; \
+        static SMLayerScrolling<RGB_TYPE(storage_depth), scrolling_options> layer_name(layer_name##Bitmap, width, height)
+#endif
+
+#endif
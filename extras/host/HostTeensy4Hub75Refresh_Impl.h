@@ -0,0 +1,128 @@
+/*
+ * SmartMatrix Library - Host replacement for MatrixTeensy4Hub75Refresh_Impl.h
+ *
+ * Implements the SmartMatrixRefreshT4 API used by the Teensy 4 calc class without any hardware.  Rows written by the calc class
+ * are queued in dmaBuffer the same as on Teensy, and rowCalculationISR() takes all queued rows out of the buffer as if DMA had
+ * shifted them out, then calls the calc class to refill it.  Only pin configurations that can be checked at compile time (see
+ * SmartMatrixFlexPinOffsetsT4) are supported, as there's no FlexIO_t4 library to map the pins at runtime.
+ */
+
+#define INLINE __attribute__( ( always_inline ) ) inline
+
+#define MIN_REFRESH_RATE    1
+#define MAX_REFRESH_RATE    1000
+
+// row most recently written by the calc class, the benchmark uses this to find the end of a frame
+static int hostLastRowWritten = -1;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+SpscRing_SM SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBufferNumRows;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+volatile typename SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rowDataStruct * SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateRows;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+typename SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrix_calc_callback SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixCalcCallback;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+typename SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrix_underrun_callback SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUnderrunCallback;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+typename SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::flexPinConfigStruct SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::flexPinConfig;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+typename SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::flexPinConfigStruct SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::addxPinConfig;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::SmartMatrixRefreshT4(uint8_t bufferrows, volatile rowDataStruct * rowDataBuf) {
+    dmaBufferNumRows = bufferrows;
+    matrixUpdateRows = rowDataBuf;
+
+    // initialize matrixUpdateRows to all zeros to ensure all padding pixels are blank
+    for (int row = 0; row < dmaBufferNumRows; row++)
+        memset((void*) &matrixUpdateRows[row], 0, sizeof(rowDataStruct));
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+bool SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::isRowBufferFree(void) {
+    return !dmaBuffer.isFull();
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+volatile typename SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rowDataStruct * SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getNextRowBufferPtr(void) {
+    return &(matrixUpdateRows[dmaBuffer.getNextWrite()]);
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::writeRowBuffer(uint8_t currentRow) {
+    hostLastRowWritten = currentRow;
+    dmaBuffer.write();
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::recoverFromDmaUnderrun(void) {
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setMatrixCalculationsCallback(matrix_calc_callback f) {
+    matrixCalcCallback = f;
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setMatrixUnderrunCallback(matrix_underrun_callback f) {
+    matrixUnderrunCallback = f;
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setBrightness(uint8_t newBrightness) {
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setRefreshRate(uint16_t newRefreshRate) {
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+const typename SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::flexPinConfigStruct & SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getFlexPinConfig(void) {
+    return flexPinConfig;
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calculateFlexPinConfig(void) {
+    static_assert(flexPinOffsets::isValid, "The host build needs FlexIO pins that are known at compile time (see flexIO2PinFromTeensyPin())");
+
+    flexPinConfig.r0 = flexPinOffsets::offsetOf(R_0_SIGNAL);
+    flexPinConfig.g0 = flexPinOffsets::offsetOf(G_0_SIGNAL);
+    flexPinConfig.b0 = flexPinOffsets::offsetOf(B_0_SIGNAL);
+    flexPinConfig.r1 = flexPinOffsets::offsetOf(R_1_SIGNAL);
+    flexPinConfig.g1 = flexPinOffsets::offsetOf(G_1_SIGNAL);
+    flexPinConfig.b1 = flexPinOffsets::offsetOf(B_1_SIGNAL);
+
+    addxPinConfig.addx0 = flexPinOffsets::offsetOf(ADDX_0_SIGNAL);
+    addxPinConfig.addx1 = flexPinOffsets::offsetOf(ADDX_1_SIGNAL);
+    addxPinConfig.addx2 = flexPinOffsets::offsetOf(ADDX_2_SIGNAL);
+    addxPinConfig.addx3 = flexPinOffsets::offsetOf(ADDX_3_SIGNAL);
+    addxPinConfig.addx4 = flexPinOffsets::offsetOf(ADDX_4_SIGNAL);
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::begin(void) {
+    calculateFlexPinConfig();
+    dmaBuffer.init(dmaBufferNumRows);
+
+    // fill buffer with data before enabling DMA
+    matrixCalcCallback(true);
+}
+
+// called by the benchmark in place of the DMA and timer interrupts
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void rowCalculationISR(void) {
+    SpscRing_SM & dmaBuffer = SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer;
+
+    while(!dmaBuffer.isEmpty())
+        dmaBuffer.read();
+
+    SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixCalcCallback(false);
+}
@@ -0,0 +1,155 @@
+/*
+ * SmartMatrix Library - Host test for loadMatrixBuffersPacked() in the Teensy 3 calc class
+ *
+ * loadMatrixBuffersPacked() is used instead of loadMatrixBuffers48() when the refresh buffer map isn't needed, and has to write
+ * the same rowbits[].  This loads every refresh row with both functions, from a layer with pseudo-random pixels that change every
+ * frame, and compares the results, for 16 frames so every step of the temporal dither pattern is covered.  Both rgb24 and rgb48
+ * temporary rows are checked where the refresh depth allows it, with and without HUB12 mode, temporal dithering, and the
+ * hardware CLK (one DMA update per pixel instead of two), and for widths that are and aren't a multiple of the pixels per word.
+ *
+ * Usage: PackedRowTest_Teensy3
+ */
+
+// SM_HUB75_OPTIONS_T3_HARDWARE_CLK needs FTM3, as on the Teensy 3.6
+#define __MK66FX1M0__
+
+#include <MatrixHardware_Teensy3_ShieldV4.h>
+#include "HostSmartMatrix.h"
+
+const int kTestFrames = 16;
+const int kDmaBufferRows = 2;
+const int kMaxReportedMismatches = 10;
+
+// every frame has different pixels, with each channel independent of the others
+class PackedTestLayer : public SM_Layer {
+    public:
+        PackedTestLayer(uint16_t width, uint16_t height) {
+            nextLayer = NULL;
+            matrixWidth = width;
+            matrixHeight = height;
+            frame = 0;
+        }
+
+        void begin() {}
+        void frameRefreshCallback() {}
+
+        void fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts = 0) {
+            for(int x=0; x<matrixWidth; x++)
+                refreshRow[x] = rgb48(hashPixel(x, hardwareY, 0), hashPixel(x, hardwareY, 1), hashPixel(x, hardwareY, 2));
+        }
+
+        void fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts = 0) {
+            for(int x=0; x<matrixWidth; x++)
+                refreshRow[x] = rgb24(hashPixel(x, hardwareY, 0) >> 8, hashPixel(x, hardwareY, 1) >> 8, hashPixel(x, hardwareY, 2) >> 8);
+        }
+
+        uint32_t frame;
+
+    private:
+        uint16_t hashPixel(uint16_t x, uint16_t y, int channel) {
+            uint32_t hash = (x * 73856093UL) ^ (y * 19349663UL) ^ ((channel + 1) * 83492791UL) ^ (frame * 2654435761UL);
+            hash ^= hash >> 13;
+            hash *= 0x5bd1e995UL;
+            hash ^= hash >> 15;
+            return hash;
+        }
+};
+
+// friend of the calc class, so it can call both functions for the same rows
+struct SmartMatrixPackedRowTest {
+    template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags, typename RGB_TEMP>
+    static int compareRows(const char * name, PackedTestLayer & testLayer) {
+        typedef SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags> Calc;
+        typedef typename Calc::rowDataStruct rowDataStruct;
+
+        static rowDataStruct rows48;
+        static rowDataStruct rowsPacked;
+        int mismatches = 0;
+
+        for(int frame = 0; frame < kTestFrames; frame++) {
+            testLayer.frame = frame;
+            Calc::ditherFrame = frame;
+
+            for(int currentRow = 0; currentRow < MATRIX_SCAN_MOD; currentRow++) {
+                // the packed function writes every byte of data[], fill with different values so skipped bytes are found
+                memset(&rows48, 0x55, sizeof(rows48));
+                memset(&rowsPacked, 0xAA, sizeof(rowsPacked));
+                Calc::loadMatrixBuffers48(&rows48, currentRow, RGB_TEMP(0,0,0));
+                Calc::loadMatrixBuffersPacked(&rowsPacked, currentRow, RGB_TEMP(0,0,0));
+
+                for(int bitindex = 0; bitindex < COLOR_DEPTH_BITS; bitindex++) {
+                    const uint8_t * data48 = rows48.rowbits[bitindex].data;
+                    const uint8_t * dataPacked = rowsPacked.rowbits[bitindex].data;
+                    if(!memcmp(data48, dataPacked, sizeof(rows48.rowbits[bitindex].data)))
+                        continue;
+
+                    for(unsigned int i = 0; i < sizeof(rows48.rowbits[bitindex].data); i++) {
+                        if(data48[i] == dataPacked[i])
+                            continue;
+
+                        if(mismatches < kMaxReportedMismatches) {
+                            fprintf(stderr, "%s rgb%d frame %d row %d bitplane %d byte %d: packed %02x, expected %02x\n", name,
+                                (int)sizeof(RGB_TEMP) * 8, frame, currentRow, bitindex, i, dataPacked[i], data48[i]);
+                        }
+                        mismatches++;
+                    }
+                }
+            }
+        }
+
+        return mismatches;
+    }
+};
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+static bool testPackedRows(const char * name) {
+    static_assert(!REFRESH_BUFFER_MAP_REQUIRED, "loadMatrixBuffersPacked() is only used without the refresh buffer map");
+
+    typedef SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags> Refresh;
+
+    static typename Refresh::rowDataStruct rowsDataBuffer[kDmaBufferRows];
+    Refresh matrixRefresh(kDmaBufferRows, rowsDataBuffer);
+    SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags> matrix(kDmaBufferRows, rowsDataBuffer);
+    PackedTestLayer testLayer(matrixWidth, matrixHeight);
+
+    matrix.addLayer(&testLayer);
+    matrix.begin();
+
+    int mismatches = SmartMatrixPackedRowTest::compareRows<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags, rgb48>(name, testLayer);
+    // the rgb24 temporary rows only have 8 bits per channel
+    if(COLOR_DEPTH_BITS <= 8)
+        mismatches += SmartMatrixPackedRowTest::compareRows<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags, rgb24>(name, testLayer);
+
+    if(mismatches)
+        fprintf(stderr, "%s: %d bytes differ\n", name, mismatches);
+    return !mismatches;
+}
+
+int main(int argc, char ** argv) {
+    bool passed = true;
+
+    if(!testPackedRows<24, 32, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE>("32x32 24")) passed = false;
+    if(!testPackedRows<36, 32, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE>("32x32 36")) passed = false;
+    if(!testPackedRows<48, 32, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE>("32x32 48")) passed = false;
+    if(!testPackedRows<12, 37, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE>("37x32 12")) passed = false;
+    if(!testPackedRows<24, 37, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE>("37x32 24")) passed = false;
+    if(!testPackedRows<48, 37, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE>("37x32 48")) passed = false;
+    if(!testPackedRows<36, 32, 64, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_NONE>("32x64 36 stacked")) passed = false;
+    if(!testPackedRows<36, 32, 64, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_BOTTOM_TO_TOP_STACKING>("32x64 36 stacked bottom to top")) passed = false;
+    if(!testPackedRows<36, 32, 16, SM_PANELTYPE_HUB75_16ROW_MOD8SCAN, SM_HUB75_OPTIONS_NONE>("32x16 36 mod8")) passed = false;
+
+    if(!testPackedRows<24, 32, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_HUB12_MODE>("32x32 24 HUB12")) passed = false;
+    if(!testPackedRows<36, 37, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_HUB12_MODE>("37x32 36 HUB12")) passed = false;
+
+    if(!testPackedRows<24, 32, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_TEMPORAL_DITHER>("32x32 24 dither")) passed = false;
+    if(!testPackedRows<36, 37, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_TEMPORAL_DITHER>("37x32 36 dither")) passed = false;
+
+    if(!testPackedRows<24, 32, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_T3_HARDWARE_CLK>("32x32 24 hardware CLK")) passed = false;
+    if(!testPackedRows<36, 37, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_T3_HARDWARE_CLK>("37x32 36 hardware CLK")) passed = false;
+    if(!testPackedRows<48, 38, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN, SM_HUB75_OPTIONS_T3_HARDWARE_CLK>("38x32 48 hardware CLK")) passed = false;
+    if(!testPackedRows<24, 37, 32, SM_PANELTYPE_HUB75_32ROW_MOD16SCAN,
+        SM_HUB75_OPTIONS_T3_HARDWARE_CLK | SM_HUB75_OPTIONS_HUB12_MODE | SM_HUB75_OPTIONS_TEMPORAL_DITHER>("37x32 24 hardware CLK HUB12 dither")) passed = false;
+
+    printf("PackedRowTest_Teensy3: %s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
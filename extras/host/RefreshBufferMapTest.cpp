@@ -0,0 +1,348 @@
+/*
+ * SmartMatrix Library - Host test for the refresh buffer map built by calculateRefreshBufferMap()
+ *
+ * Runs the Teensy 4 calc class for every panel type, stacked two panels wide and two panels high, with each combination of C-shape
+ * and bottom to top stacking, and checks every refresh row against one loaded the way earlier versions of the library did:  walking
+ * the panel map with advanceMultiRowRefreshMapToNextPixelGroup() for each group of pixels, and loading physical rows until the map's
+ * row offset wraps to 0, instead of the fixed PHYSICAL_ROWS_PER_REFRESH_ROW loop used now.  Each pixel has a different value in
+ * each channel, so any pixel written to the wrong position, or any physical row missed or loaded twice, changes the row data.  The
+ * image rows loaded for each stack come from getPanelStackRows() in both, as those changed on purpose for upside down multi-row
+ * refresh panels.
+ *
+ * Usage: RefreshBufferMapTest
+ */
+
+#include <MatrixHardware_Teensy4_ShieldV5.h>
+#include "HostSmartMatrix.h"
+
+const int kTestDepth = 48;
+const int kPanelsWide = 2;
+const int kPanelsHigh = 2;
+const int kMaxReportedMismatches = 10;
+
+// fills every row with pixels that are different in every position and channel
+class MapTestLayer : public SM_Layer {
+    public:
+        MapTestLayer(uint16_t width, uint16_t height) {
+            nextLayer = NULL;
+            matrixWidth = width;
+            matrixHeight = height;
+        }
+
+        static rgb48 getPixel(uint16_t x, uint16_t y) {
+            return rgb48(hashPixel(x, y, 0), hashPixel(x, y, 1), hashPixel(x, y, 2));
+        }
+
+        void begin() {}
+        void frameRefreshCallback() {}
+
+        void fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts = 0) {
+            for(int x=0; x<matrixWidth; x++)
+                refreshRow[x] = getPixel(x, hardwareY);
+        }
+
+        void fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts = 0) {}
+
+    private:
+        static uint16_t hashPixel(uint16_t x, uint16_t y, int channel) {
+            uint32_t hash = (x * 73856093UL) ^ (y * 19349663UL) ^ ((channel + 1) * 83492791UL);
+            hash ^= hash >> 13;
+            hash *= 0x5bd1e995UL;
+            hash ^= hash >> 15;
+            return hash;
+        }
+};
+
+// the panel map walk from before calculateRefreshBufferMap(), with the same state as the calc class kept
+struct OldMultiRowRefreshMap {
+    const PanelMappingEntry * map;
+    int colsPerPanel;
+    int physicalRowsPerRefreshRow;
+    int mapIndex_CurrentRowGroups;
+    int mapIndex_CurrentPixelGroup;
+    int PixelOffsetFromPanelsAlreadyMapped;
+    int NumPanelsAlreadyMapped;
+
+    void resetPosition(void) {
+        mapIndex_CurrentRowGroups = 0;
+        resetPixelGroupToStartOfRow();
+    }
+
+    void resetPixelGroupToStartOfRow(void) {
+        mapIndex_CurrentPixelGroup = mapIndex_CurrentRowGroups;
+        PixelOffsetFromPanelsAlreadyMapped = 0;
+        NumPanelsAlreadyMapped = 0;
+    }
+
+    void advanceToNextRow(void) {
+        int currentRowOffset = map[mapIndex_CurrentRowGroups].rowOffset;
+
+        while(!IS_LAST_PANEL_MAP_ENTRY(map[mapIndex_CurrentRowGroups])) {
+            mapIndex_CurrentRowGroups++;
+
+            if(map[mapIndex_CurrentRowGroups].rowOffset != currentRowOffset)
+                break;
+        }
+
+        resetPixelGroupToStartOfRow();
+    }
+
+    void advanceToNextPixelGroup(void) {
+        int currentRowOffset = map[mapIndex_CurrentPixelGroup].rowOffset;
+
+        if(IS_LAST_PANEL_MAP_ENTRY(map[mapIndex_CurrentPixelGroup]))
+            return;
+
+        if(!IS_LAST_PANEL_MAP_ENTRY(map[mapIndex_CurrentPixelGroup + 1]) &&
+            (map[mapIndex_CurrentPixelGroup + 1].rowOffset == currentRowOffset)) {
+            mapIndex_CurrentPixelGroup++;
+        } else {
+            while((mapIndex_CurrentPixelGroup > 0) && (map[mapIndex_CurrentPixelGroup - 1].rowOffset == currentRowOffset))
+                mapIndex_CurrentPixelGroup--;
+
+            NumPanelsAlreadyMapped++;
+            PixelOffsetFromPanelsAlreadyMapped = NumPanelsAlreadyMapped * colsPerPanel * physicalRowsPerRefreshRow;
+        }
+    }
+
+    int getRowOffset(void) {
+        if(IS_LAST_PANEL_MAP_ENTRY(map[mapIndex_CurrentRowGroups]))
+            return -1;
+
+        return map[mapIndex_CurrentRowGroups].rowOffset;
+    }
+
+    int getNumPixelsToMap(void) {
+        return map[mapIndex_CurrentPixelGroup].numPixels;
+    }
+
+    int getPixelGroupOffset(void) {
+        return map[mapIndex_CurrentPixelGroup].bufferOffset + PixelOffsetFromPanelsAlreadyMapped;
+    }
+};
+
+// loadMatrixBuffers48() from before calculateRefreshBufferMap(), returns the number of physical rows loaded
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+static int referenceLoadMatrixBuffers48(typename SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rowDataStruct * currentRowDataPtr,
+    unsigned int currentRow, SM_Layer * baseLayer) {
+
+    typedef SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags> Refresh;
+
+    int i;
+    int multiRowRefreshRowOffset = 0;
+    int physicalRowsLoaded = 0;
+    const int numPixelsPerTempRow = PIXELS_PER_LATCH/PHYSICAL_ROWS_PER_REFRESH_ROW;
+
+    static rgb48 tempRow0[numPixelsPerTempRow];
+    static rgb48 tempRow1[numPixelsPerTempRow];
+
+    OldMultiRowRefreshMap mapState;
+    mapState.map = getMultiRowRefreshPanelMap(panelType);
+    mapState.colsPerPanel = COLS_PER_PANEL;
+    mapState.physicalRowsPerRefreshRow = PHYSICAL_ROWS_PER_REFRESH_ROW;
+
+    if(MULTI_ROW_REFRESH_REQUIRED)
+        mapState.resetPosition();
+
+    do {
+        memset(tempRow0, 0, sizeof(tempRow0));
+        memset(tempRow1, 0, sizeof(tempRow1));
+
+        // the rows for upside down stacks of multi-row refresh panels were fixed after the map was added, use the current rows
+        SM_Layer * templayer = baseLayer;
+        while (templayer) {
+            for (i = 0; i < MATRIX_STACK_HEIGHT; i++) {
+                PanelStackRows stackRows = getPanelStackRows(currentRow + multiRowRefreshRowOffset, i, MATRIX_STACK_HEIGHT,
+                    MATRIX_PANEL_HEIGHT, ROW_PAIR_OFFSET, optionFlags);
+                templayer->fillRefreshRow(stackRows.y0, &tempRow0[i * matrixWidth]);
+                templayer->fillRefreshRow(stackRows.y1, &tempRow1[i * matrixWidth]);
+            }
+            templayer = templayer->nextLayer;
+        }
+
+        i=0;
+
+        if(MULTI_ROW_REFRESH_REQUIRED)
+            mapState.resetPixelGroupToStartOfRow();
+
+        while(i < numPixelsPerTempRow) {
+            int numPixelsToMap;
+            int currentMapOffset = 0;
+            bool reversePixelBlock = false;
+
+            if(MULTI_ROW_REFRESH_REQUIRED) {
+                numPixelsToMap = mapState.getNumPixelsToMap();
+
+                if(numPixelsToMap < 0) {
+                    reversePixelBlock = true;
+                    numPixelsToMap = abs(numPixelsToMap);
+                }
+
+                currentMapOffset = mapState.getPixelGroupOffset();
+            } else {
+                numPixelsToMap = matrixWidth;
+            }
+
+            for(int k=0; k < numPixelsToMap; k++) {
+                uint16_t r0, g0, b0, r1, g1, b1;
+                int ind;
+
+                int refreshBufferPosition;
+                if(MULTI_ROW_REFRESH_REQUIRED) {
+                    if(reversePixelBlock) {
+                        refreshBufferPosition = currentMapOffset-k;
+                    } else {
+                        refreshBufferPosition = currentMapOffset+k;
+                    }
+                } else {
+                    refreshBufferPosition = i+k;
+                }
+
+                int currentStack = i/matrixWidth;
+                if((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) && !((currentStack % 2) == ((MATRIX_STACK_HEIGHT - 1) % 2))) {
+                    ind = (currentStack*matrixWidth) + (matrixWidth-1) - ((i+k)%matrixWidth);
+                } else {
+                    ind = i+k;
+                }
+                r0 = tempRow0[ind].red;
+                g0 = tempRow0[ind].green;
+                b0 = tempRow0[ind].blue;
+                r1 = tempRow1[ind].red;
+                g1 = tempRow1[ind].green;
+                b1 = tempRow1[ind].blue;
+
+                if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE) {
+                    r0 = ~r0;
+                }
+
+                uint32_t rgbdata;
+                uint8_t shift = (16 - COLOR_DEPTH_BITS);
+                uint16_t mask = 1 << shift;
+
+                for (int bitindex = 0; bitindex < COLOR_DEPTH_BITS; bitindex++) {
+                    rgbdata  = (r0 & mask) << (Refresh::getFlexPinConfig().r0);
+                    rgbdata |= (g0 & mask) << (Refresh::getFlexPinConfig().g0);
+                    rgbdata |= (b0 & mask) << (Refresh::getFlexPinConfig().b0);
+                    rgbdata |= (r1 & mask) << (Refresh::getFlexPinConfig().r1);
+                    rgbdata |= (g1 & mask) << (Refresh::getFlexPinConfig().g1);
+                    rgbdata |= (b1 & mask) << (Refresh::getFlexPinConfig().b1);
+                    rgbdata >>= shift;
+
+                    shift++;
+                    mask <<= 1;
+
+                    currentRowDataPtr->rowbits[bitindex].data[PAD_PIXELS + refreshBufferPosition] = rgbdata;
+                }
+            }
+            i += numPixelsToMap;
+            if(MULTI_ROW_REFRESH_REQUIRED)
+                mapState.advanceToNextPixelGroup();
+        }
+        currentRowDataPtr->rowbits[0].rowAddress = currentRow;
+
+        if(panelType == SM_PANELTYPE_HUB75_16ROW_32COL_MOD4SCAN_V4)
+            currentRowDataPtr->rowbits[0].rowAddress = ~(0x01 << currentRow);
+
+        physicalRowsLoaded++;
+
+        if(MULTI_ROW_REFRESH_REQUIRED) {
+            mapState.advanceToNextRow();
+            multiRowRefreshRowOffset = mapState.getRowOffset();
+        }
+    } while (MULTI_ROW_REFRESH_REQUIRED ? (multiRowRefreshRowOffset > 0) : 0);
+
+    return physicalRowsLoaded;
+}
+
+// the row buffer has one row for each refresh row, so begin() fills the whole frame in order
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+static bool testRefreshBufferMap(const char * panelName, const char * stackingName) {
+    typedef SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags> Refresh;
+    typedef typename Refresh::rowDataStruct rowDataStruct;
+
+    static volatile rowDataStruct rowsDataBuffer[MATRIX_SCAN_MOD];
+    static rowDataStruct referenceRow;
+    Refresh matrixRefresh(MATRIX_SCAN_MOD, rowsDataBuffer);
+    SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags> matrix(MATRIX_SCAN_MOD, rowsDataBuffer);
+    MapTestLayer testLayer(matrixWidth, matrixHeight);
+
+    matrix.addLayer(&testLayer);
+    matrix.begin();
+
+    int mismatches = 0;
+    for(int currentRow = 0; currentRow < MATRIX_SCAN_MOD; currentRow++) {
+        memset(&referenceRow, 0, sizeof(referenceRow));
+        int physicalRowsLoaded = referenceLoadMatrixBuffers48<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>(&referenceRow, currentRow, &testLayer);
+
+        if(physicalRowsLoaded != PHYSICAL_ROWS_PER_REFRESH_ROW) {
+            fprintf(stderr, "%s %s row %d: map walk loaded %d physical rows, PHYSICAL_ROWS_PER_REFRESH_ROW is %d\n",
+                panelName, stackingName, currentRow, physicalRowsLoaded, PHYSICAL_ROWS_PER_REFRESH_ROW);
+            mismatches++;
+        }
+
+        const volatile rowDataStruct & sentRow = rowsDataBuffer[currentRow];
+        if(sentRow.rowbits[0].rowAddress != referenceRow.rowbits[0].rowAddress) {
+            fprintf(stderr, "%s %s row %d: address %08x, expected %08x\n", panelName, stackingName, currentRow, (unsigned int)sentRow.rowbits[0].rowAddress,
+                (unsigned int)referenceRow.rowbits[0].rowAddress);
+            mismatches++;
+        }
+
+        for(int bitindex = 0; bitindex < COLOR_DEPTH_BITS; bitindex++) {
+            for(int position = 0; position < PAD_PIXELS + PIXELS_PER_LATCH; position++) {
+                uint16_t sent = sentRow.rowbits[bitindex].data[position];
+                uint16_t expected = referenceRow.rowbits[bitindex].data[position];
+                if(sent == expected)
+                    continue;
+
+                if(mismatches < kMaxReportedMismatches) {
+                    fprintf(stderr, "%s %s row %d bitplane %d position %d: %04x, expected %04x\n",
+                        panelName, stackingName, currentRow, bitindex, position - PAD_PIXELS, sent, expected);
+                }
+                mismatches++;
+            }
+        }
+    }
+
+    if(mismatches)
+        fprintf(stderr, "%s %s: %d differences\n", panelName, stackingName, mismatches);
+    return !mismatches;
+}
+
+template <unsigned char panelType>
+static bool testPanelType(const char * name) {
+    const int width = kPanelsWide * CONVERT_PANELTYPE_TO_MATRIXPANELWIDTH(panelType);
+    const int height = kPanelsHigh * CONVERT_PANELTYPE_TO_MATRIXPANELHEIGHT(panelType);
+    bool passed = true;
+
+    if(!testRefreshBufferMap<kTestDepth, width, height, panelType, SM_HUB75_OPTIONS_NONE>(name, "top to bottom"))
+        passed = false;
+    if(!testRefreshBufferMap<kTestDepth, width, height, panelType, SM_HUB75_OPTIONS_BOTTOM_TO_TOP_STACKING>(name, "bottom to top"))
+        passed = false;
+    if(!testRefreshBufferMap<kTestDepth, width, height, panelType, SM_HUB75_OPTIONS_C_SHAPE_STACKING>(name, "c-shape top to bottom"))
+        passed = false;
+    if(!testRefreshBufferMap<kTestDepth, width, height, panelType, SM_HUB75_OPTIONS_C_SHAPE_STACKING | SM_HUB75_OPTIONS_BOTTOM_TO_TOP_STACKING>(name, "c-shape bottom to top"))
+        passed = false;
+    return passed;
+}
+
+int main(int argc, char ** argv) {
+    bool passed = true;
+
+    if(!testPanelType<SM_PANELTYPE_HUB75_32ROW_MOD16SCAN>("32ROW_MOD16SCAN")) passed = false;
+    if(!testPanelType<SM_PANELTYPE_HUB75_16ROW_MOD8SCAN>("16ROW_MOD8SCAN")) passed = false;
+    if(!testPanelType<SM_PANELTYPE_HUB75_64ROW_MOD32SCAN>("64ROW_MOD32SCAN")) passed = false;
+    if(!testPanelType<SM_PANELTYPE_HUB75_4ROW_MOD2SCAN>("4ROW_MOD2SCAN")) passed = false;
+    if(!testPanelType<SM_PANELTYPE_HUB75_8ROW_MOD4SCAN>("8ROW_MOD4SCAN")) passed = false;
+    if(!testPanelType<SM_PANELTYPE_HUB75_16ROW_32COL_MOD2SCAN>("16ROW_32COL_MOD2SCAN")) passed = false;
+    if(!testPanelType<SM_PANELTYPE_HUB12_16ROW_32COL_MOD4SCAN>("HUB12_16ROW_32COL_MOD4SCAN")) passed = false;
+    if(!testPanelType<SM_PANELTYPE_HUB75_16ROW_32COL_MOD4SCAN>("16ROW_32COL_MOD4SCAN")) passed = false;
+    if(!testPanelType<SM_PANELTYPE_HUB75_2ROW_MOD1SCAN>("2ROW_MOD1SCAN")) passed = false;
+    if(!testPanelType<SM_PANELTYPE_HUB75_16ROW_32COL_MOD4SCAN_V2>("16ROW_32COL_MOD4SCAN_V2")) passed = false;
+    if(!testPanelType<SM_PANELTYPE_HUB75_32ROW_64COL_MOD8SCAN>("32ROW_64COL_MOD8SCAN")) passed = false;
+    if(!testPanelType<SM_PANELTYPE_HUB75_64ROW_64COL_MOD16SCAN>("64ROW_64COL_MOD16SCAN")) passed = false;
+    if(!testPanelType<SM_PANELTYPE_HUB75_16ROW_32COL_MOD4SCAN_V3>("16ROW_32COL_MOD4SCAN_V3")) passed = false;
+    if(!testPanelType<SM_PANELTYPE_HUB75_16ROW_32COL_MOD4SCAN_V4>("16ROW_32COL_MOD4SCAN_V4")) passed = false;
+
+    printf("RefreshBufferMapTest: %s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
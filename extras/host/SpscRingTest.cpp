@@ -0,0 +1,111 @@
+/*
+ * SmartMatrix Library - Host stress test for SpscRing_SM
+ *
+ * Runs a producer and a consumer thread on the same ring the way the calc and refresh use it: the producer fills the buffer at
+ * getNextWrite() with a sequence number before write(), the consumer checks the buffer at getNextRead() before read().  Every
+ * number has to arrive once and in order, and a buffer can't change while the consumer still owns it.  Each ring size from one
+ * buffer up is tested, including sizes that aren't a power of two.
+ *
+ * Usage: SpscRingTest [-n elements]
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SpscRing_SM.h"
+
+static const int kMaxRingSize = 9;
+
+static bool testRing(int ringSize, uint32_t numElements) {
+    SpscRing_SM ring;
+    // stands in for the row/frame buffers, the ring only holds the indexes
+    volatile uint32_t buffers[kMaxRingSize];
+    std::atomic<bool> failed(false);
+
+    ring.init(ringSize);
+    for(int i=0; i<ringSize; i++)
+        buffers[i] = 0;
+
+    std::thread producer([&]() {
+        for(uint32_t sequence = 1; sequence <= numElements && !failed; ) {
+            // yield so the test doesn't crawl when both threads have to share one core
+            if(ring.isFull()) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            if(ring.getNumElements() >= (uint32_t)ringSize) {
+                fprintf(stderr, "size %d: %u elements in ring after isFull() returned false\n", ringSize, ring.getNumElements());
+                failed = true;
+                break;
+            }
+
+            buffers[ring.getNextWrite()] = sequence++;
+            ring.write();
+        }
+    });
+
+    std::thread consumer([&]() {
+        for(uint32_t expected = 1; expected <= numElements && !failed; ) {
+            if(ring.isEmpty()) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            int index = ring.getNextRead();
+            uint32_t value = buffers[index];
+            if(value != expected) {
+                fprintf(stderr, "size %d: read %u from buffer %d, expected %u\n", ringSize, value, index, expected);
+                failed = true;
+                break;
+            }
+
+            // hold on to the buffer for a bit like the DMA would, the producer must not reuse it yet
+            for(volatile int i=0; i<(int)(expected & 0x1f); i++);
+            if(buffers[index] != value) {
+                fprintf(stderr, "size %d: buffer %d overwritten while being read\n", ringSize, index);
+                failed = true;
+                break;
+            }
+
+            ring.read();
+            expected++;
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    if(!failed && !ring.isEmpty()) {
+        fprintf(stderr, "size %d: ring not empty after all elements were read\n", ringSize);
+        failed = true;
+    }
+
+    return !failed;
+}
+
+int main(int argc, char ** argv) {
+    uint32_t numElements = 200000;
+
+    for(int i=1; i<argc; i++) {
+        if(!strcmp(argv[i], "-n") && (i + 1 < argc)) {
+            numElements = strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [-n elements]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    bool passed = true;
+    for(int ringSize = 1; ringSize <= kMaxRingSize; ringSize++) {
+        if(!testRing(ringSize, numElements))
+            passed = false;
+    }
+
+    printf("SpscRingTest: %s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/*
+ * SmartMatrix Library - Arduino API stub for the host build in extras/host
+ *
+ * Just enough of the Arduino core for the calculation classes and layers to compile on a PC.  There's no hardware, so pins
+ * do nothing, Serial prints to stdout, and millis()/micros() count from the start of the program.
+ */
+
+#ifndef _SMARTMATRIX_HOST_ARDUINO_H_
+#define _SMARTMATRIX_HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <chrono>
+#include <thread>
+using std::min;
+using std::max;
+#endif
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define PROGMEM
+#define DMAMEM
+#define EXTMEM
+#define FASTRUN
+#define F(str) (str)
+
+#define pgm_read_byte(addr)     (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)     (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr)    (*(const uint32_t *)(addr))
+#define pgm_read_pointer(addr)  (*(void * const *)(addr))
+
+#define HIGH    1
+#define LOW     0
+#define INPUT   0
+#define OUTPUT  1
+
+#ifdef __cplusplus
+
+// nanoseconds since the first call, the host equivalent of the CPU cycle counter
+static inline uint64_t hostNanoseconds(void) {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+static inline unsigned long millis(void) { return (unsigned long)(hostNanoseconds() / 1000000); }
+static inline unsigned long micros(void) { return (unsigned long)(hostNanoseconds() / 1000); }
+static inline void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+static inline void delayMicroseconds(unsigned int) {}
+static inline void yield(void) {}
+
+static inline void pinMode(uint8_t, uint8_t) {}
+static inline void digitalWrite(uint8_t, uint8_t) {}
+static inline int digitalRead(uint8_t) { return LOW; }
+
+// the profiling in the calc classes (see getCalcCyclesPerFrame()) counts nanoseconds on the host
+#define SM_GET_CPU_CYCLE_COUNT()    ((uint32_t)hostNanoseconds())
+
+class HostSerial {
+public:
+    void begin(unsigned long) {}
+    operator bool() const { return true; }
+    void print(const char * str) { fputs(str, stdout); }
+    void print(char c) { putchar(c); }
+    void print(int value) { printf("%d", value); }
+    void print(unsigned int value) { printf("%u", value); }
+    void print(long value) { printf("%ld", value); }
+    void print(unsigned long value) { printf("%lu", value); }
+    void print(double value) { printf("%.2f", value); }
+    template <typename T> void println(T value) { print(value); putchar('\n'); }
+    void println(void) { putchar('\n'); }
+};
+
+static HostSerial Serial;
+
+#if defined(ESP32)
+// the ESP32 core includes FreeRTOS and parts of ESP-IDF from Arduino.h, the Teensy core doesn't have assert() and the layers
+// call SM_Layer::assert() instead
+#include <assert.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DMA      (1 << 3)
+#define MALLOC_CAP_8BIT     (1 << 2)
+
+static inline void * heap_caps_malloc(size_t size, uint32_t caps) { return malloc(size); }
+static inline unsigned int heap_caps_get_free_size(uint32_t caps) { return 0; }
+static inline unsigned int heap_caps_get_largest_free_block(uint32_t caps) { return 0; }
+
+static inline int gpio_set_level(int gpio, uint32_t level) { return 0; }
+
+class EspClass {
+public:
+    uint32_t getCycleCount(void) { return SM_GET_CPU_CYCLE_COUNT(); }
+    uint32_t getCpuFreqMHz(void) { return 1000; }
+};
+
+static EspClass ESP;
+#endif
+
+#endif
+
+#endif
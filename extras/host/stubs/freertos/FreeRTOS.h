@@ -0,0 +1,141 @@
+/*
+ * SmartMatrix Library - FreeRTOS stub for the host build in extras/host
+ *
+ * Only the parts used by the ESP32 calc class.  Tasks are threads, and binary semaphores are a flag protected by a mutex.  Core
+ * affinity and priorities are ignored.
+ *
+ * hostWaitForTasksIdle() is an addition for the benchmark: it waits until every task is blocked waiting for a semaphore, so the
+ * calculations can be run from the main thread without racing the calc task.
+ */
+
+#ifndef _SMARTMATRIX_HOST_FREERTOS_H_
+#define _SMARTMATRIX_HOST_FREERTOS_H_
+
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define pdPASS              pdTRUE
+#define portMAX_DELAY       0xFFFFFFFF
+#define portTICK_PERIOD_MS  1
+
+// from esp_attr.h, which FreeRTOS includes on ESP32
+#define IRAM_ATTR
+
+struct HostSemaphore {
+    bool given;
+    int waitingTasks;   // tasks blocked in xSemaphoreTake(), cleared when the semaphore is given
+    uint32_t gives;
+};
+
+typedef HostSemaphore * SemaphoreHandle_t;
+typedef std::thread * TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+// shared by every file, so the functions below aren't static, and never destroyed, as the tasks are still waiting on it at exit
+struct HostTaskState {
+    std::mutex mutex;
+    std::condition_variable changed;
+    int numTasks;
+    int numTasksWaiting;
+};
+
+inline HostTaskState & hostTaskState(void) {
+    static HostTaskState * state = new HostTaskState();
+    return *state;
+}
+
+// true in threads started with xTaskCreatePinnedToCore()
+inline bool & hostIsTask(void) {
+    static thread_local bool isTask = false;
+    return isTask;
+}
+
+static inline SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return new HostSemaphore{false, 0, 0};
+}
+
+static inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    HostTaskState & state = hostTaskState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if(semaphore->given)
+        return pdFALSE;
+    semaphore->given = true;
+    semaphore->gives++;
+    // the tasks waiting for this semaphore can run now
+    state.numTasksWaiting -= semaphore->waitingTasks;
+    semaphore->waitingTasks = 0;
+    state.changed.notify_all();
+    return pdTRUE;
+}
+
+static inline BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t * higherPriorityTaskWoken) {
+    return xSemaphoreGive(semaphore);
+}
+
+static inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    HostTaskState & state = hostTaskState();
+    std::unique_lock<std::mutex> lock(state.mutex);
+
+    if(ticksToWait == portMAX_DELAY) {
+        // another thread may take the semaphore first after it's given, then wait for the next give
+        while(!semaphore->given) {
+            uint32_t gives = semaphore->gives;
+            if(hostIsTask()) {
+                semaphore->waitingTasks++;
+                state.numTasksWaiting++;
+                state.changed.notify_all();
+            }
+            state.changed.wait(lock, [semaphore, gives] { return semaphore->gives != gives; });
+        }
+    } else if(!semaphore->given && ticksToWait) {
+        state.changed.wait_for(lock, std::chrono::milliseconds(ticksToWait * portTICK_PERIOD_MS), [semaphore] { return semaphore->given; });
+    }
+
+    if(!semaphore->given)
+        return pdFALSE;
+    semaphore->given = false;
+    return pdTRUE;
+}
+
+static inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char * name, uint32_t stackDepth, void * parameters,
+    UBaseType_t priority, TaskHandle_t * createdTask, BaseType_t coreId) {
+    HostTaskState & state = hostTaskState();
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.numTasks++;
+    }
+
+    // tasks run until the program exits
+    std::thread * task = new std::thread([function, parameters] {
+        hostIsTask() = true;
+        function(parameters);
+    });
+    task->detach();
+
+    if(createdTask)
+        *createdTask = task;
+    return pdPASS;
+}
+
+static inline void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+}
+
+// only counts tasks blocked with portMAX_DELAY, which is all the ESP32 calc class uses
+static inline void hostWaitForTasksIdle(void) {
+    HostTaskState & state = hostTaskState();
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.changed.wait(lock, [&state] { return state.numTasksWaiting == state.numTasks; });
+}
+
+#endif
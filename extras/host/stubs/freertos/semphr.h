@@ -0,0 +1,5 @@
+/*
+ * SmartMatrix Library - FreeRTOS stub for the host build in extras/host, everything is in FreeRTOS.h
+ */
+
+#include "FreeRTOS.h"
@@ -0,0 +1,13 @@
+/*
+ * SmartMatrix Library - FlexIO_t4 stub for the host build in extras/host
+ *
+ * MatrixTeensy4Hub75Refresh.h only keeps pointers to the FlexIO and FlexPWM registers, so the types don't need to be complete.
+ */
+
+#ifndef _SMARTMATRIX_HOST_FLEXIO_T4_H_
+#define _SMARTMATRIX_HOST_FLEXIO_T4_H_
+
+typedef struct IMXRT_FLEXIO_struct IMXRT_FLEXIO_t;
+typedef struct IMXRT_FLEXPWM_struct IMXRT_FLEXPWM_t;
+
+#endif
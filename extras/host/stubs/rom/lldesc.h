@@ -0,0 +1,18 @@
+/*
+ * SmartMatrix Library - ESP-IDF stub for the host build in extras/host, only the types used by esp32_i2s_parallel.h
+ */
+
+#ifndef _SMARTMATRIX_HOST_LLDESC_H_
+#define _SMARTMATRIX_HOST_LLDESC_H_
+
+#include <stdint.h>
+
+typedef struct lldesc_s {
+    uint32_t size;
+    uint32_t length;
+    uint32_t flags;
+    uint8_t * buf;
+    struct lldesc_s * next;
+} lldesc_t;
+
+#endif
@@ -0,0 +1,10 @@
+/*
+ * SmartMatrix Library - ESP-IDF stub for the host build in extras/host, only the types used by esp32_i2s_parallel.h
+ */
+
+#ifndef _SMARTMATRIX_HOST_I2S_STRUCT_H_
+#define _SMARTMATRIX_HOST_I2S_STRUCT_H_
+
+typedef struct i2s_dev_s i2s_dev_t;
+
+#endif
@@ -46,3 +46,20 @@ int SM_Layer::getRequestedBrightnessShifts() {
 bool SM_Layer::isLayerChanged() {
     return true;
 }
+
+bool SM_Layer::isRefreshRowChanged(uint16_t hardwareY) {
+    return true;
+}
+
+SM_RefreshSpan SM_Layer::getRefreshRowSpan(uint16_t hardwareY) {
+    SM_RefreshSpan span = {0, matrixWidth, false};
+    return span;
+}
+
+void SM_Layer::fillRefreshSpan(uint16_t hardwareY, const SM_RefreshSpan & span, rgb48 refreshRow[], int brightnessShifts) {
+    fillRefreshRow(hardwareY, refreshRow, brightnessShifts);
+}
+
+void SM_Layer::fillRefreshSpan(uint16_t hardwareY, const SM_RefreshSpan & span, rgb24 refreshRow[], int brightnessShifts) {
+    fillRefreshRow(hardwareY, refreshRow, brightnessShifts);
+}
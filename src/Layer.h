@@ -24,8 +24,20 @@
 #ifndef _LAYER_H_
 #define _LAYER_H_
 
+#include <string.h>
 #include "MatrixCommon.h"
 
+// the range of hardware columns a layer writes to when filling a refresh row, x1 is exclusive
+// opaque is set if every pixel in the range is written, hiding the layers below
+typedef struct SM_RefreshSpan {
+    uint16_t x0;
+    uint16_t x1;
+    bool opaque;
+} SM_RefreshSpan;
+
+// number of layers fillRefreshRowFromLayers() keeps spans for on the stack, more layers work but call getRefreshRowSpan() twice
+#define SM_MAX_CACHED_REFRESH_SPANS     8
+
 class SM_Layer {
     public:
         virtual void begin() = 0;
@@ -35,6 +47,17 @@ class SM_Layer {
         virtual void fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts = 0) = 0;
         virtual void fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts = 0) = 0;
 
+        // describes which pixels fillRefreshRow() writes on hardwareY, default is the full row, not opaque
+        virtual SM_RefreshSpan getRefreshRowSpan(uint16_t hardwareY);
+        // fills only the pixels in span (from getRefreshRowSpan()), default calls fillRefreshRow()
+        virtual void fillRefreshSpan(uint16_t hardwareY, const SM_RefreshSpan & span, rgb48 refreshRow[], int brightnessShifts = 0);
+        virtual void fillRefreshSpan(uint16_t hardwareY, const SM_RefreshSpan & span, rgb24 refreshRow[], int brightnessShifts = 0);
+
+        // composites the chain of layers starting at baseLayer into refreshRow (width pixels), skipping layers hidden
+        // under an opaque layer and layers with nothing to draw on hardwareY, and only clearing refreshRow if needed
+        template <typename RGB>
+        static void fillRefreshRowFromLayers(SM_Layer * baseLayer, uint16_t hardwareY, RGB refreshRow[], uint16_t width, int brightnessShifts = 0);
+
         virtual void setRotation(rotationDegrees newrotation);
         rotationDegrees getLayerRotation(void) const { return layerRotation; };
         uint16_t getLayerWidth(void) const { return layerWidth; };
@@ -44,6 +67,8 @@ class SM_Layer {
         virtual void setRefreshRate(uint8_t newRefreshRate);
         virtual int getRequestedBrightnessShifts();
         virtual bool isLayerChanged();
+        // called after frameRefreshCallback() if isLayerChanged() was true, returns true if hardwareY may have changed, default is every row
+        virtual bool isRefreshRowChanged(uint16_t hardwareY);
 
         SM_Layer * nextLayer;
 
@@ -61,4 +86,39 @@ class SM_Layer {
     private:
 };
 
+template <typename RGB>
+void SM_Layer::fillRefreshRowFromLayers(SM_Layer * baseLayer, uint16_t hardwareY, RGB refreshRow[], uint16_t width, int brightnessShifts) {
+    SM_Layer * templayer;
+    SM_Layer * firstLayer = NULL;
+    int firstLayerIndex = 0;
+    int i;
+    SM_RefreshSpan span;
+    // spans from the first pass are reused when filling, any layers past the first SM_MAX_CACHED_REFRESH_SPANS get theirs again
+    SM_RefreshSpan spans[SM_MAX_CACHED_REFRESH_SPANS];
+
+    // the topmost layer that covers the full row with opaque pixels hides everything below it
+    for (templayer = baseLayer, i = 0; templayer; templayer = templayer->nextLayer, i++) {
+        span = templayer->getRefreshRowSpan(hardwareY);
+        if (i < SM_MAX_CACHED_REFRESH_SPANS)
+            spans[i] = span;
+
+        if (span.opaque && span.x0 == 0 && span.x1 >= width) {
+            firstLayer = templayer;
+            firstLayerIndex = i;
+        }
+    }
+
+    // clear buffer to prevent garbage data showing through transparent layers
+    if (!firstLayer) {
+        memset(refreshRow, 0x00, sizeof(RGB) * width);
+        firstLayer = baseLayer;
+    }
+
+    for (templayer = firstLayer, i = firstLayerIndex; templayer; templayer = templayer->nextLayer, i++) {
+        span = (i < SM_MAX_CACHED_REFRESH_SPANS) ? spans[i] : templayer->getRefreshRowSpan(hardwareY);
+        if (span.x0 < span.x1)
+            templayer->fillRefreshSpan(hardwareY, span, refreshRow, brightnessShifts);
+    }
+}
+
 #endif
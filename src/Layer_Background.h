@@ -27,20 +27,38 @@
 #include "Layer.h"
 #include "MatrixCommon.h"
 #include "MatrixFontCommon.h"
+#include "TripleBuffer_SM.h"
 
-#define SM_BACKGROUND_OPTIONS_NONE     0
+#define SM_BACKGROUND_OPTIONS_NONE              0
+// use a third buffer so swapBuffers() never waits for the refresh ISR, frames swapped faster than the refresh rate are dropped
+#define SM_BACKGROUND_OPTIONS_TRIPLE_BUFFER     (1 << 0)
+// store the buffers in layer coordinates instead of hardware coordinates: drawing and backBuffer() access in rotation90/270 is
+// row by row, and the rotation is applied when reading the buffer during refresh instead.  backBuffer() is then in layer
+// coordinates, and existing pixels aren't rotated by setRotation(), so redraw after changing the rotation
+#define SM_BACKGROUND_OPTIONS_LOCAL_STORAGE     (1 << 1)
+
+#define SM_BACKGROUND_NUM_BUFFERS(options)      (((options) & SM_BACKGROUND_OPTIONS_TRIPLE_BUFFER) ? 3 : 2)
+
+// changed-row bits, one bit per buffer row in each set (with local storage the buffer has width rows in rotation90/270), three sets
+// plus six more for triple buffering
+#define SM_BACKGROUND_ROWS_CHANGED_SET_SIZE(options, width, height) \
+    ((((((options) & SM_BACKGROUND_OPTIONS_LOCAL_STORAGE) && (width) > (height)) ? (width) : (height)) + 7) / 8)
+#define SM_BACKGROUND_ROWS_CHANGED_BYTES(options, width, height) \
+    ((((options) & SM_BACKGROUND_OPTIONS_TRIPLE_BUFFER) ? 9 : 3) * SM_BACKGROUND_ROWS_CHANGED_SET_SIZE(options, width, height))
 
 template <typename RGB, unsigned int optionFlags>
 class SMLayerBackground : public SM_Layer {
     public:
-        SMLayerBackground(RGB * buffer, uint16_t width, uint16_t height, color_chan_t * colorCorrectionLUT);
+        SMLayerBackground(RGB * buffer, uint16_t width, uint16_t height, color_chan_t * colorCorrectionLUT, uint8_t * rowsChangedBuffer = NULL);
         SMLayerBackground(uint16_t width, uint16_t height);
         void begin(void);
         void frameRefreshCallback();
         void fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts = 0);
         void fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts = 0);
+        SM_RefreshSpan getRefreshRowSpan(uint16_t hardwareY);
         int getRequestedBrightnessShifts();
         bool isLayerChanged();
+        bool isRefreshRowChanged(uint16_t hardwareY);
         
         void swapBuffers(bool copy = true);
         bool isSwapPending();
@@ -80,9 +98,17 @@ class SMLayerBackground : public SM_Layer {
 
         RGB *getRealBackBuffer();
 
+        // copies a w x h image to x,y, clipped and rotated like drawPixel(), srcStride is the number of bytes between source rows
+        // palette is only used with blitFormatIndexed8
+        void blit(int16_t x, int16_t y, int16_t w, int16_t h, const void * src, int srcStride, blitFormat srcFormat, const rgb24 * palette = NULL);
+
         void setFont(fontChoices newFont);
         void setBrightness(uint8_t brightness);
         void enableColorCorrection(bool enabled);
+        SM_BackgroundLUT * getColorCorrectionLUT(void);
+        bool setColorCorrectionLUT(SM_BackgroundLUT * lut);
+        bool setColorCorrection(const SM_ColorCorrection & correction);
+        void resetColorCorrection(void);
 
     private:
         bool ccEnabled = true;
@@ -90,9 +116,16 @@ class SMLayerBackground : public SM_Layer {
         RGB *currentDrawBufferPtr;
         RGB *currentRefreshBufferPtr;
 
-        RGB *backgroundBuffers[2];
+        RGB *backgroundBuffers[3];
 
         RGB *getCurrentRefreshRow(uint16_t y);
+        RGB *getRefreshRowStart(uint16_t hardwareY, int &step);
+
+        // drawing functions map layer coordinates to buffer coordinates with drawRotation(), which is always rotation0 with
+        // SM_BACKGROUND_OPTIONS_LOCAL_STORAGE, the "hardware" coordinates and rows below are buffer coordinates and rows
+        rotationDegrees drawRotation(void);
+        uint16_t bufferWidth(void);
+        uint16_t bufferHeight(void);
 
         void loadPixelToDrawBuffer(int16_t hwx, int16_t hwy, const RGB& color);
         const RGB readPixelFromDrawBuffer(int16_t hwx, int16_t hwy);
@@ -102,11 +135,16 @@ class SMLayerBackground : public SM_Layer {
         // drawing functions not meant for user
         void drawHardwareHLine(uint16_t x0, uint16_t x1, uint16_t y, const RGB& color);
         void drawHardwareVLine(uint16_t x, uint16_t y0, uint16_t y1, const RGB& color);
+        void fillHardwareRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, const RGB& color);
         void bresteepline(int16_t x3, int16_t y3, int16_t x4, int16_t y4, const RGB& color);
         void fillFlatSideTriangleInt(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, const RGB& color);
 
-        uint8_t backgroundBrightness = 255;
-        color_chan_t * backgroundColorCorrectionLUT;
+        color_chan_t * redColorCorrectionLUT = NULL;
+        color_chan_t * greenColorCorrectionLUT = NULL;
+        color_chan_t * blueColorCorrectionLUT = NULL;
+        SM_BackgroundLUT ownColorCorrectionLUT = {NULL, SM_BACKGROUND_LUT_SIZE(RGB), -1, 255};
+        SM_BackgroundLUT * colorCorrectionLUT = &ownColorCorrectionLUT;
+        uint8_t colorCorrectionLUTUpdateCount = 0;
         bitmap_font *font;
 
         // idealBrightnessShifts is the number of shifts towards MSB the pixel data can handle without overflowing
@@ -119,6 +157,25 @@ class SMLayerBackground : public SM_Layer {
         volatile unsigned char currentRefreshBuffer;
         volatile bool swapPending;
         void handleBufferSwap(void);
+
+        // with SM_BACKGROUND_OPTIONS_TRIPLE_BUFFER, tripleBuffer replaces swapPending, and each buffer has the rows that changed since
+        // the previous frame, and the rows that may differ from the newest frame (only used by the drawing side)
+        TripleBuffer_SM tripleBuffer;
+        uint8_t * frameRowsChanged[3];
+        uint8_t * staleRows[3];
+
+        // copies only the rows set in rows, used for swapBuffers(true)
+        void copyRows(RGB * dst, const RGB * src, const uint8_t * rows);
+
+        // one bit per buffer row: rows drawn since the last swap, rows where the two buffers differ (drawn since the buffers were last
+        // copied), and rows that changed in the refresh buffer with the last swap
+        uint8_t * drawRowsChanged = NULL;
+        uint8_t * unsyncedRows;
+        uint8_t * refreshRowsChanged;
+        volatile bool allRowsChangedPending = true;
+        void setRowsChangedBuffer(uint8_t * buffer);
+        void markAllDrawRowsChanged(void);
+        void markDrawRowsChanged(uint16_t y0, uint16_t y1);
 };
 
 #include "Layer_Background_Impl.h"
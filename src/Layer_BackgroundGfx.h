@@ -27,11 +27,25 @@
 #include "Layer.h"
 #include "MatrixCommon.h"
 #include "MatrixFontCommon.h"
+#include "TripleBuffer_SM.h"
 
 // Adafruit_GFX includes
 #include "MatrixGfxFontCommon.h"
 
-#define SM_BACKGROUND_GFX_OPTIONS_NONE     0
+#define SM_BACKGROUND_GFX_OPTIONS_NONE              0
+// same as SM_BACKGROUND_OPTIONS_TRIPLE_BUFFER
+#define SM_BACKGROUND_GFX_OPTIONS_TRIPLE_BUFFER     (1 << 0)
+// same as SM_BACKGROUND_OPTIONS_LOCAL_STORAGE
+#define SM_BACKGROUND_GFX_OPTIONS_LOCAL_STORAGE     (1 << 1)
+
+#define SM_BACKGROUND_GFX_NUM_BUFFERS(options)      (((options) & SM_BACKGROUND_GFX_OPTIONS_TRIPLE_BUFFER) ? 3 : 2)
+
+// changed-row bits, one bit per buffer row in each set (with local storage the buffer has width rows in rotation90/270), two sets
+// or four for triple buffering
+#define SM_BACKGROUND_GFX_ROWS_CHANGED_SET_SIZE(options, width, height) \
+    ((((((options) & SM_BACKGROUND_GFX_OPTIONS_LOCAL_STORAGE) && (width) > (height)) ? (width) : (height)) + 7) / 8)
+#define SM_BACKGROUND_GFX_ROWS_CHANGED_BYTES(options, width, height) \
+    ((((options) & SM_BACKGROUND_GFX_OPTIONS_TRIPLE_BUFFER) ? 4 : 2) * SM_BACKGROUND_GFX_ROWS_CHANGED_SET_SIZE(options, width, height))
 
 #define SM_BACKGROUND_GFX_BACKWARDS_COMPATIBILITY
 //#define SM_BACKGROUND_GFX_OLD_DRAWING_FUNCTIONS
@@ -40,12 +54,13 @@ template <typename RGB, unsigned int optionFlags>
 class SMLayerBackgroundGFX : public SM_Layer, public Adafruit_GFX {
     public:
         /* RGB specific methods */
-        SMLayerBackgroundGFX(RGB * buffer, uint16_t width, uint16_t height, color_chan_t * colorCorrectionLUT);
+        SMLayerBackgroundGFX(RGB * buffer, uint16_t width, uint16_t height, color_chan_t * colorCorrectionLUT, uint8_t * rowsChangedBuffer = NULL);
         SMLayerBackgroundGFX(uint16_t width, uint16_t height);
         void begin(void);
         void frameRefreshCallback();
         void fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts = 0);
         void fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts = 0);
+        SM_RefreshSpan getRefreshRowSpan(uint16_t hardwareY);
         void copyRefreshToDrawing(void);
 
         // could make this generic if moving the buffer copy code to a new function
@@ -56,6 +71,11 @@ class SMLayerBackgroundGFX : public SM_Layer, public Adafruit_GFX {
 
         /* RGB Specific Adafruit_GFX methods */
         void drawPixel(int16_t x, int16_t y, uint16_t color);
+        // these are called by most Adafruit_GFX drawing functions, and fill spans directly instead of calling drawPixel() for each pixel
+        void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+        void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+        void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+        void fillScreen(uint16_t color);
 
         /* RGB Specific SmartMatrix Library 3.0 Backwards Compatibility */
 #ifdef SM_BACKGROUND_GFX_BACKWARDS_COMPATIBILITY
@@ -71,6 +91,9 @@ class SMLayerBackgroundGFX : public SM_Layer, public Adafruit_GFX {
         RGB *backBuffer(void);
         void setBackBuffer(RGB *newBuffer);
         RGB *getRealBackBuffer();
+        // copies a w x h image to x,y, clipped and rotated like drawPixel(), srcStride is the number of bytes between source rows
+        // palette is only used with blitFormatIndexed8
+        void blit(int16_t x, int16_t y, int16_t w, int16_t h, const void * src, int srcStride, blitFormat srcFormat, const rgb24 * palette = NULL);
 
         /* Shared */
         void setBrightnessShifts(int numShifts);
@@ -79,6 +102,10 @@ class SMLayerBackgroundGFX : public SM_Layer, public Adafruit_GFX {
         bool isSwapPending();
         void setBrightness(uint8_t brightness);
         void enableColorCorrection(bool enabled);
+        SM_BackgroundLUT * getColorCorrectionLUT(void);
+        bool setColorCorrectionLUT(SM_BackgroundLUT * lut);
+        bool setColorCorrection(const SM_ColorCorrection & correction);
+        void resetColorCorrection(void);
         void setRotation(rotationDegrees newrotation);
 
         /* Shared SmartMatrix Library 3.0 Backwards Compatibility */
@@ -129,13 +156,23 @@ class SMLayerBackgroundGFX : public SM_Layer, public Adafruit_GFX {
         // drawing functions not meant for user
         void drawHardwareHLine(uint16_t x0, uint16_t x1, uint16_t y, const RGB& color);
         void drawHardwareVLine(uint16_t x, uint16_t y0, uint16_t y1, const RGB& color);
+        void fillHardwareRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, const RGB& color);
+        void fillLocalRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color);
+        RGB colorFromGfx(uint16_t color);
 
         bool ccEnabled = true;
 
         RGB *currentDrawBufferPtr;
         RGB *currentRefreshBufferPtr;
 
-        RGB *backgroundBuffers[2];
+        RGB *backgroundBuffers[3];
+
+        // drawing functions map layer coordinates to buffer coordinates with drawRotation(), which is always rotation0 with
+        // SM_BACKGROUND_GFX_OPTIONS_LOCAL_STORAGE, the "hardware" coordinates and rows below are buffer coordinates and rows
+        rotationDegrees drawRotation(void);
+        uint16_t bufferWidth(void);
+        uint16_t bufferHeight(void);
+        RGB *getRefreshRowStart(uint16_t hardwareY, int &step);
 
         RGB passThruColor;
         bool passThruColorFlag = false;
@@ -152,8 +189,12 @@ class SMLayerBackgroundGFX : public SM_Layer, public Adafruit_GFX {
         bitmap_font *font;
 #endif
 
-        uint8_t backgroundBrightness = 255;
-        color_chan_t * backgroundColorCorrectionLUT;
+        color_chan_t * redColorCorrectionLUT = NULL;
+        color_chan_t * greenColorCorrectionLUT = NULL;
+        color_chan_t * blueColorCorrectionLUT = NULL;
+        SM_BackgroundLUT ownColorCorrectionLUT = {NULL, SM_BACKGROUND_LUT_SIZE(RGB), -1, 255};
+        SM_BackgroundLUT * colorCorrectionLUT = &ownColorCorrectionLUT;
+        uint8_t colorCorrectionLUTUpdateCount = 0;
 
         int16_t layerXOffset = 0;
         int16_t layerYOffset = 0;
@@ -168,6 +209,19 @@ class SMLayerBackgroundGFX : public SM_Layer, public Adafruit_GFX {
         volatile unsigned char currentRefreshBuffer;
         volatile bool swapPending;
         void handleBufferSwap(void);
+
+        // used instead of swapPending with SM_BACKGROUND_GFX_OPTIONS_TRIPLE_BUFFER
+        TripleBuffer_SM tripleBuffer;
+
+        // one bit per buffer row, so swapBuffers(true) only copies rows that differ: rows drawn since the last swap, and rows where
+        // the two buffers differ (or with triple buffering, rows where each buffer may differ from the newest frame)
+        uint8_t * drawRowsChanged = NULL;
+        uint8_t * unsyncedRows;
+        uint8_t * staleRows[3];
+        bool allRowsChangedPending = false;
+        void setRowsChangedBuffer(uint8_t * buffer);
+        void markDrawRowsChanged(uint16_t y0, uint16_t y1);
+        void copyRows(RGB * dst, const RGB * src, const uint8_t * rows);
 };
 
 #include "Layer_BackgroundGfx_Impl.h"
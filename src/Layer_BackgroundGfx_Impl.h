@@ -25,16 +25,22 @@
 
 #define INLINE __attribute__( ( always_inline ) ) inline
 
+#define BACKGROUND_GFX_ROWS_CHANGED_SIZE    SM_BACKGROUND_GFX_ROWS_CHANGED_SET_SIZE(optionFlags, this->matrixWidth, this->matrixHeight)
+
 /* RGB specific methods */
 
 // call when backgroundBuffers and backgroundColorCorrectionLUT buffer is allocated outside of class
+// rowsChangedBuffer is SM_BACKGROUND_GFX_ROWS_CHANGED_BYTES() long, it's allocated in begin() if not given
 template <typename RGB, unsigned int optionFlags>
-SMLayerBackgroundGFX<RGB, optionFlags>::SMLayerBackgroundGFX(RGB * buffer, uint16_t width, uint16_t height, color_chan_t * colorCorrectionLUT) : Adafruit_GFX(width, height) {
+SMLayerBackgroundGFX<RGB, optionFlags>::SMLayerBackgroundGFX(RGB * buffer, uint16_t width, uint16_t height, color_chan_t * colorCorrectionLUT, uint8_t * rowsChangedBuffer) : Adafruit_GFX(width, height) {
     backgroundBuffers[0] = buffer;
     backgroundBuffers[1] = buffer + (width * height);
-    backgroundColorCorrectionLUT = colorCorrectionLUT;
+    backgroundBuffers[2] = (optionFlags & SM_BACKGROUND_GFX_OPTIONS_TRIPLE_BUFFER) ? buffer + (2 * width * height) : NULL;
+    ownColorCorrectionLUT.table = colorCorrectionLUT;
     this->matrixWidth = width;
     this->matrixHeight = height;
+    if(rowsChangedBuffer)
+        setRowsChangedBuffer(rowsChangedBuffer);
 }
 
 // call this when buffers should be sourced from malloc inside begin()
@@ -44,6 +50,24 @@ SMLayerBackgroundGFX<RGB, optionFlags>::SMLayerBackgroundGFX(uint16_t width, uin
     this->matrixHeight = height;
 }
 
+// triple buffering uses staleRows[] instead of unsyncedRows
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackgroundGFX<RGB, optionFlags>::setRowsChangedBuffer(uint8_t * buffer) {
+    drawRowsChanged = buffer;
+    memset(drawRowsChanged, 0x00, SM_BACKGROUND_GFX_ROWS_CHANGED_BYTES(optionFlags, this->matrixWidth, this->matrixHeight));
+
+    unsyncedRows = drawRowsChanged + BACKGROUND_GFX_ROWS_CHANGED_SIZE;
+    for(int i=0; i<3; i++)
+        staleRows[i] = (optionFlags & SM_BACKGROUND_GFX_OPTIONS_TRIPLE_BUFFER) ? drawRowsChanged + ((i + 1) * BACKGROUND_GFX_ROWS_CHANGED_SIZE) : NULL;
+}
+
+// hardware rows y0-y1
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackgroundGFX<RGB, optionFlags>::markDrawRowsChanged(uint16_t y0, uint16_t y1) {
+    for (int i = y0; i <= y1; i++)
+        drawRowsChanged[i / 8] |= (0x01 << (i % 8));
+}
+
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackgroundGFX<RGB, optionFlags>::begin(void) {
 #if defined(ESP32)
@@ -57,27 +81,33 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::begin(void) {
     #define ESPmalloc malloc
     #endif
     if(!backgroundBuffers[0] && !backgroundBuffers[1]) {
-        //printf("largest free block %d: \r\n", heap_caps_get_largest_free_block(MALLOC_CAP_DMA));
-        backgroundBuffers[0] = (RGB *)ESPmalloc(sizeof(RGB) * this->matrixWidth * this->matrixHeight);
-        assert(backgroundBuffers[0] != NULL);
-        //printf("largest free block %d: \r\n", heap_caps_get_largest_free_block(MALLOC_CAP_DMA));
-        backgroundBuffers[1] = (RGB *)ESPmalloc(sizeof(RGB) * this->matrixWidth * this->matrixHeight);
-        assert(backgroundBuffers[1] != NULL);
-        //printf("largest free block %d: \r\n", heap_caps_get_largest_free_block(MALLOC_CAP_DMA));
-        memset(backgroundBuffers[0], 0x00, sizeof(RGB) * this->matrixWidth * this->matrixHeight);
-        memset(backgroundBuffers[1], 0x00, sizeof(RGB) * this->matrixWidth * this->matrixHeight);
+        for(int i=0; i<SM_BACKGROUND_GFX_NUM_BUFFERS(optionFlags); i++) {
+            //printf("largest free block %d: \r\n", heap_caps_get_largest_free_block(MALLOC_CAP_DMA));
+            backgroundBuffers[i] = (RGB *)ESPmalloc(sizeof(RGB) * this->matrixWidth * this->matrixHeight);
+            assert(backgroundBuffers[i] != NULL);
+            memset(backgroundBuffers[i], 0x00, sizeof(RGB) * this->matrixWidth * this->matrixHeight);
+        }
         //printf("largest free block %d: \r\n", heap_caps_get_largest_free_block(MALLOC_CAP_DMA));
     }
-    if(!backgroundColorCorrectionLUT) {
-        backgroundColorCorrectionLUT = (color_chan_t *)malloc(sizeof(color_chan_t) * (sizeof(RGB) <= 3 ? 256 : 4096));
-        assert(backgroundColorCorrectionLUT != NULL);
+    // no need for our own table if sharing another layer's table
+    if(!colorCorrectionLUT->table) {
+        colorCorrectionLUT->table = (color_chan_t *)malloc(sizeof(color_chan_t) * colorCorrectionLUT->size);
+        assert(colorCorrectionLUT->table != NULL);
         //printf("largest free block %d: \r\n", heap_caps_get_largest_free_block(MALLOC_CAP_DMA));
     }
 #endif
+    if(!drawRowsChanged) {
+        uint8_t * rowsChangedBuffer = (uint8_t *)malloc(SM_BACKGROUND_GFX_ROWS_CHANGED_BYTES(optionFlags, this->matrixWidth, this->matrixHeight));
+#ifdef ESP32
+        assert(rowsChangedBuffer != NULL);
+#endif
+        setRowsChangedBuffer(rowsChangedBuffer);
+    }
     
     currentDrawBuffer = 0;
     currentRefreshBuffer = 1;
     swapPending = false;
+    tripleBuffer.init();
 
 #ifdef SM_BACKGROUND_GFX_OLD_DRAWING_FUNCTIONS
     font = (bitmap_font *) &apple3x5;
@@ -89,6 +119,14 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::begin(void) {
 
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackgroundGFX<RGB, optionFlags>::handleBufferSwap(void) {
+    if (optionFlags & SM_BACKGROUND_GFX_OPTIONS_TRIPLE_BUFFER) {
+        if(tripleBuffer.update()) {
+            currentRefreshBuffer = tripleBuffer.getRefreshIndex();
+            currentRefreshBufferPtr = backgroundBuffers[currentRefreshBuffer];
+        }
+        return;
+    }
+
     if (!swapPending)
         return;
 
@@ -107,10 +145,46 @@ template <typename RGB, unsigned int optionFlags>
 void SMLayerBackgroundGFX<RGB, optionFlags>::frameRefreshCallback(void) {
     handleBufferSwap();
 
-    if(sizeof(RGB) > 3)
-        calculate12BitBackgroundLUT(backgroundColorCorrectionLUT, backgroundBrightness);
-    else
-        calculate8BitBackgroundLUT(backgroundColorCorrectionLUT, backgroundBrightness);
+    // the tables are only recalculated after a brightness or correction change, which may come from another layer sharing them
+    updateBackgroundLUT<SM_BACKGROUND_LUT_SIZE(RGB)>(colorCorrectionLUT);
+    colorCorrectionLUTUpdateCount = colorCorrectionLUT->updateCount;
+    redColorCorrectionLUT = colorCorrectionLUT->channelLUT[0];
+    greenColorCorrectionLUT = colorCorrectionLUT->channelLUT[1];
+    blueColorCorrectionLUT = colorCorrectionLUT->channelLUT[2];
+}
+
+template <typename RGB, unsigned int optionFlags>
+INLINE rotationDegrees SMLayerBackgroundGFX<RGB, optionFlags>::drawRotation(void) {
+    return (optionFlags & SM_BACKGROUND_GFX_OPTIONS_LOCAL_STORAGE) ? rotation0 : this->layerRotation;
+}
+
+template <typename RGB, unsigned int optionFlags>
+INLINE uint16_t SMLayerBackgroundGFX<RGB, optionFlags>::bufferWidth(void) {
+    return (optionFlags & SM_BACKGROUND_GFX_OPTIONS_LOCAL_STORAGE) ? this->localWidth : this->matrixWidth;
+}
+
+template <typename RGB, unsigned int optionFlags>
+INLINE uint16_t SMLayerBackgroundGFX<RGB, optionFlags>::bufferHeight(void) {
+    return (optionFlags & SM_BACKGROUND_GFX_OPTIONS_LOCAL_STORAGE) ? this->localHeight : this->matrixHeight;
+}
+
+// returns the first pixel of hardware row hardwareY in the refresh buffer, and the distance to the next pixel in the row
+// with local storage in rotation90/270 the hardware row is a buffer column, see SMLayerBackground::getRefreshRowStart()
+template <typename RGB, unsigned int optionFlags>
+INLINE RGB *SMLayerBackgroundGFX<RGB, optionFlags>::getRefreshRowStart(uint16_t hardwareY, int &step) {
+    if (!(optionFlags & SM_BACKGROUND_GFX_OPTIONS_LOCAL_STORAGE) || this->layerRotation == rotation0) {
+        step = 1;
+        return currentRefreshBufferPtr + (hardwareY * this->matrixWidth);
+    } else if (this->layerRotation == rotation180) {
+        step = -1;
+        return currentRefreshBufferPtr + (((this->matrixHeight - 1) - hardwareY) * this->matrixWidth) + (this->matrixWidth - 1);
+    } else if (this->layerRotation == rotation90) {
+        step = -this->matrixHeight;
+        return currentRefreshBufferPtr + ((this->matrixWidth - 1) * this->matrixHeight) + hardwareY;
+    } else { /* if (layerRotation == rotation270)*/
+        step = this->matrixHeight;
+        return currentRefreshBufferPtr + ((this->matrixHeight - 1) - hardwareY);
+    }
 }
 
 template <typename RGB, unsigned int optionFlags> template <typename RGB_OUT>
@@ -122,12 +196,13 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::fillRefreshRowTemplated(uint16_t ha
     if(((hardwareY - layerYOffset) > (this->matrixHeight - 1)) || ((hardwareY - layerYOffset) < 0))
         return;
 
-    RGB *ptr = currentRefreshBufferPtr + ((hardwareY - layerYOffset) * this->matrixWidth);
+    int step;
+    RGB *ptr = getRefreshRowStart(hardwareY - layerYOffset, step);
 
     int16_t iRangeMin = 0;
     int16_t iRangeMax = this->matrixWidth;
     if(layerXOffset < 0) {
-        ptr -= layerXOffset; // increase ptr by offset
+        ptr -= layerXOffset * step; // increase ptr by offset
         iRangeMax += layerXOffset; // decrease range, with offset on the max end
     }
 
@@ -137,25 +212,37 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::fillRefreshRowTemplated(uint16_t ha
 
     if(this->ccEnabled) {
         for(i=iRangeMin; i<iRangeMax; i++) {
-            currentPixel = *ptr++;
+            currentPixel = *ptr;
+            ptr += step;
             // load background pixel with color correction
-            if(sizeof(RGB) <= 3) {
-                // 24-bit source (8 bits per color channel): backgroundColorCorrectionLUT expects 8-bit value, returns 16-bit value
-                refreshRow[i] = rgb48(backgroundColorCorrectionLUT[currentPixel.red << brightnessShifts],
-                    backgroundColorCorrectionLUT[currentPixel.green << brightnessShifts],
-                    backgroundColorCorrectionLUT[currentPixel.blue << brightnessShifts]);                
+            if(sizeof(RGB) <= 2) {
+                // 16-bit source (5/6/5 bits per color channel): color correction LUTs expect 6-bit value, returns 16-bit value
+                refreshRow[i] = rgb48(redColorCorrectionLUT[smExpand5to6(currentPixel.red) << brightnessShifts],
+                    greenColorCorrectionLUT[currentPixel.green << brightnessShifts],
+                    blueColorCorrectionLUT[smExpand5to6(currentPixel.blue) << brightnessShifts]);
+            } else if(sizeof(RGB) <= 3) {
+                // 24-bit source (8 bits per color channel): color correction LUTs expect 8-bit value, returns 16-bit value
+                refreshRow[i] = rgb48(redColorCorrectionLUT[currentPixel.red << brightnessShifts],
+                    greenColorCorrectionLUT[currentPixel.green << brightnessShifts],
+                    blueColorCorrectionLUT[currentPixel.blue << brightnessShifts]);                
             } else {
-                // 48-bit source (16 bits per color channel): backgroundColorCorrectionLUT expects 12-bit value, returns 16-bit value
-                refreshRow[i] = rgb48(backgroundColorCorrectionLUT[currentPixel.red >> (4 - brightnessShifts)],
-                    backgroundColorCorrectionLUT[currentPixel.green >> (4 - brightnessShifts)],
-                    backgroundColorCorrectionLUT[currentPixel.blue >> (4 - brightnessShifts)]);
+                // 48-bit source (16 bits per color channel): color correction LUTs expect 12-bit value, returns 16-bit value
+                refreshRow[i] = rgb48(redColorCorrectionLUT[currentPixel.red >> (4 - brightnessShifts)],
+                    greenColorCorrectionLUT[currentPixel.green >> (4 - brightnessShifts)],
+                    blueColorCorrectionLUT[currentPixel.blue >> (4 - brightnessShifts)]);
             }
         }
     } else {
         for(i=iRangeMin; i<iRangeMax; i++) {
-            currentPixel = *ptr++;
+            currentPixel = *ptr;
+            ptr += step;
             // load background pixel without color correction
-            if(sizeof(RGB) <= 3) {
+            if(sizeof(RGB) <= 2) {
+                // 16-bit source (5/6/5 bits per color channel)
+                refreshRow[i] = rgb24(cs_scale5to8[currentPixel.red] << brightnessShifts,
+                    cs_scale6to8[currentPixel.green] << brightnessShifts,
+                    cs_scale5to8[currentPixel.blue] << brightnessShifts);
+            } else if(sizeof(RGB) <= 3) {
                 // 24-bit source (8 bits per color channel)
                 refreshRow[i] = rgb24(currentPixel.red << brightnessShifts,
                     currentPixel.green << brightnessShifts,
@@ -170,6 +257,24 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::fillRefreshRowTemplated(uint16_t ha
     }
 }
 
+// every pixel of the layer that lands on the row is drawn, matching the ranges used in fillRefreshRowTemplated()
+template <typename RGB, unsigned int optionFlags>
+SM_RefreshSpan SMLayerBackgroundGFX<RGB, optionFlags>::getRefreshRowSpan(uint16_t hardwareY) {
+    SM_RefreshSpan span = {0, 0, true};
+
+    if(((hardwareY - layerYOffset) > (this->matrixHeight - 1)) || ((hardwareY - layerYOffset) < 0))
+        return span;
+
+    int16_t iRangeMin = max((int)0, (int)layerXOffset);
+    int16_t iRangeMax = min((int)this->matrixWidth, (int)(this->matrixWidth + layerXOffset));
+
+    if(iRangeMin < iRangeMax) {
+        span.x0 = iRangeMin;
+        span.x1 = iRangeMax;
+    }
+    return span;
+}
+
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackgroundGFX<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts) {
     fillRefreshRowTemplated(hardwareY, refreshRow, brightnessShifts);
@@ -182,13 +287,54 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY,
 
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackgroundGFX<RGB, optionFlags>::copyRefreshToDrawing() {
-    memcpy(currentDrawBufferPtr, currentRefreshBufferPtr, sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
+    // with triple buffering the refresh buffer can change at any time, the newest frame is what will be refreshed next
+    if (optionFlags & SM_BACKGROUND_GFX_OPTIONS_TRIPLE_BUFFER) {
+        memcpy(currentDrawBufferPtr, backgroundBuffers[tripleBuffer.getNewestIndex()], sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
+        memset(staleRows[currentDrawBuffer], 0x00, BACKGROUND_GFX_ROWS_CHANGED_SIZE);
+    } else {
+        memcpy(currentDrawBufferPtr, currentRefreshBufferPtr, sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
+        memset(unsyncedRows, 0x00, BACKGROUND_GFX_ROWS_CHANGED_SIZE);
+    }
+    memset(drawRowsChanged, 0x00, BACKGROUND_GFX_ROWS_CHANGED_SIZE);
+    allRowsChangedPending = false;
 }
 
 // waits until previous swap is complete
 // waits until current swap is complete if copy is enabled
+// with SM_BACKGROUND_GFX_OPTIONS_TRIPLE_BUFFER, never waits: copy is from the frame just swapped and not the refresh buffer
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackgroundGFX<RGB, optionFlags>::swapBuffers(bool copy) {
+    if (optionFlags & SM_BACKGROUND_GFX_OPTIONS_TRIPLE_BUFFER) {
+        int newFrame = tripleBuffer.getDrawIndex();
+
+        // the other two buffers now may differ from the newest frame in the rows drawn, and the rows that weren't up to date when drawing started
+        for (int i = 0; i < BACKGROUND_GFX_ROWS_CHANGED_SIZE; i++) {
+            uint8_t rowsChanged = allRowsChangedPending ? 0xFF : (drawRowsChanged[i] | staleRows[newFrame][i]);
+            for (int j = 0; j < 3; j++)
+                staleRows[j][i] = (j == newFrame) ? 0x00 : (staleRows[j][i] | rowsChanged);
+            drawRowsChanged[i] = 0x00;
+        }
+        allRowsChangedPending = false;
+
+        tripleBuffer.publish();
+
+        currentDrawBuffer = tripleBuffer.getDrawIndex();
+        currentDrawBufferPtr = backgroundBuffers[currentDrawBuffer];
+
+        if (copy) {
+            copyRows(currentDrawBufferPtr, backgroundBuffers[newFrame], staleRows[currentDrawBuffer]);
+            memset(staleRows[currentDrawBuffer], 0x00, BACKGROUND_GFX_ROWS_CHANGED_SIZE);
+        }
+        return;
+    }
+
+    // the two buffers differ in rows drawn since the last swap, and rows that weren't copied with previous swaps
+    for (int i = 0; i < BACKGROUND_GFX_ROWS_CHANGED_SIZE; i++) {
+        unsyncedRows[i] |= allRowsChangedPending ? 0xFF : drawRowsChanged[i];
+        drawRowsChanged[i] = 0x00;
+    }
+    allRowsChangedPending = false;
+
     while (swapPending);
 
     swapPending = true;
@@ -198,9 +344,9 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::swapBuffers(bool copy) {
 #if 1
         // workaround for bizarre (optimization) bug - currentDrawBuffer and currentRefreshBuffer are volatile and are changed by an ISR while we're waiting for swapPending here.  They can't be used as parameters to memcpy directly though.  
         if(currentDrawBuffer)
-            memcpy(backgroundBuffers[1], backgroundBuffers[0], sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
+            copyRows(backgroundBuffers[1], backgroundBuffers[0], unsyncedRows);
         else
-            memcpy(backgroundBuffers[0], backgroundBuffers[1], sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
+            copyRows(backgroundBuffers[0], backgroundBuffers[1], unsyncedRows);
 #else
         // Similar code also drawing from volatile variables doesn't work if optimization is turned on: currentDrawBuffer will be equal to currentRefreshBuffer and cause a crash from memcpy copying a buffer to itself.  Why?
         memcpy(backgroundBuffers[currentDrawBuffer], backgroundBuffers[currentRefreshBuffer], sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
@@ -212,6 +358,27 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::swapBuffers(bool copy) {
         //if(currentDrawBuffer != currentRefreshBuffer)     
         //   memcpy(backgroundBuffers[currentDrawBuffer], backgroundBuffers[currentRefreshBuffer], sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
 #endif
+        // the drawing buffer now matches the refresh buffer
+        memset(unsyncedRows, 0x00, BACKGROUND_GFX_ROWS_CHANGED_SIZE);
+    }
+}
+
+// copies each run of consecutive rows with a single memcpy
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackgroundGFX<RGB, optionFlags>::copyRows(RGB * dst, const RGB * src, const uint8_t * rows) {
+    int y = 0;
+
+    while (y < bufferHeight()) {
+        if (!(rows[y / 8] & (0x01 << (y % 8)))) {
+            y++;
+            continue;
+        }
+
+        int firstRow = y;
+        while (y < bufferHeight() && (rows[y / 8] & (0x01 << (y % 8))))
+            y++;
+
+        memcpy(dst + (firstRow * bufferWidth()), src + (firstRow * bufferWidth()), sizeof(RGB) * bufferWidth() * (y - firstRow));
     }
 }
 
@@ -219,7 +386,8 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::swapBuffers(bool copy) {
 
 template <typename RGB, unsigned int optionFlags>
 INLINE void SMLayerBackgroundGFX<RGB, optionFlags>::loadPixelToDrawBuffer(int16_t hwx, int16_t hwy, const RGB& color) {
-    currentDrawBufferPtr[(hwy * this->matrixWidth) + hwx] = color;
+    currentDrawBufferPtr[(hwy * bufferWidth()) + hwx] = color;
+    drawRowsChanged[hwy / 8] |= (0x01 << (hwy % 8));
 }
 
 template <typename RGB, unsigned int optionFlags>
@@ -231,13 +399,13 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::drawPixel(int16_t x, int16_t y, con
         return;
 
     // map pixel into hardware buffer before writing
-    if (this->layerRotation == rotation0) {
+    if (drawRotation() == rotation0) {
         hwx = x;
         hwy = y;
-    } else if (this->layerRotation == rotation180) {
+    } else if (drawRotation() == rotation180) {
         hwx = (this->matrixWidth - 1) - x;
         hwy = (this->matrixHeight - 1) - y;
-    } else if (this->layerRotation == rotation90) {
+    } else if (drawRotation() == rotation90) {
         hwx = (this->matrixWidth - 1) - y;
         hwy = x;
     } else { /* if (layerRotation == rotation270)*/
@@ -259,30 +427,134 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::drawPixel(int16_t x, int16_t y, uin
         drawPixel(x, y, (rgb16)color);
 }
 
-/* RGB Specific SmartMatrix Library 3.0 Backwards Compatibility */
+template <typename RGB, unsigned int optionFlags>
+RGB SMLayerBackgroundGFX<RGB, optionFlags>::colorFromGfx(uint16_t color) {
+    if(passThruColorFlag)
+        return passThruColor;
 
-#ifdef SM_BACKGROUND_GFX_BACKWARDS_COMPATIBILITY
+    return (RGB)(rgb16)color;
+}
 
-// x0, x1, and y must be in bounds (0-this->localWidth/Height-1), x1 > x0
+// like Adafruit_GFX, a negative w draws to the left of x
 template <typename RGB, unsigned int optionFlags>
-void SMLayerBackgroundGFX<RGB, optionFlags>::drawHardwareHLine(uint16_t x0, uint16_t x1, uint16_t y, const RGB& color) {
-    int i;
+void SMLayerBackgroundGFX<RGB, optionFlags>::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    if (w < 0) {
+        x += w + 1;
+        w = -w;
+    }
+    if (w == 0)
+        return;
+
+    fillLocalRect(x, y, x + w - 1, y, colorFromGfx(color));
+}
 
-    for (i = x0; i <= x1; i++) {
-        loadPixelToDrawBuffer(i, y, color);
+// like Adafruit_GFX, a negative h draws above y
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackgroundGFX<RGB, optionFlags>::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    if (h < 0) {
+        y += h + 1;
+        h = -h;
+    }
+    if (h == 0)
+        return;
+
+    fillLocalRect(x, y, x, y + h - 1, colorFromGfx(color));
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackgroundGFX<RGB, optionFlags>::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (w < 0) {
+        x += w + 1;
+        w = -w;
+    }
+    if (h < 0) {
+        y += h + 1;
+        h = -h;
     }
+    if (w == 0 || h == 0)
+        return;
+
+    fillLocalRect(x, y, x + w - 1, y + h - 1, colorFromGfx(color));
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackgroundGFX<RGB, optionFlags>::fillScreen(uint16_t color) {
+    fillLocalRect(0, 0, this->localWidth - 1, this->localHeight - 1, colorFromGfx(color));
+}
+
+// x0, x1, and y must be in bounds (0-this->localWidth/Height-1), x1 > x0
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackgroundGFX<RGB, optionFlags>::drawHardwareHLine(uint16_t x0, uint16_t x1, uint16_t y, const RGB& color) {
+    fillPixels(currentDrawBufferPtr + (y * bufferWidth()) + x0, x1 - x0 + 1, color);
+    drawRowsChanged[y / 8] |= (0x01 << (y % 8));
 }
 
 // x, y0, and y1 must be in bounds (0-this->localWidth/Height-1), y1 > y0
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackgroundGFX<RGB, optionFlags>::drawHardwareVLine(uint16_t x, uint16_t y0, uint16_t y1, const RGB& color) {
-    int i;
+    RGB *ptr = currentDrawBufferPtr + (y0 * bufferWidth()) + x;
+
+    for (int i = y0; i <= y1; i++) {
+        *ptr = color;
+        ptr += bufferWidth();
+    }
+    markDrawRowsChanged(y0, y1);
+}
+
+// hardware coordinates, must be in bounds, x1 >= x0, y1 >= y0
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackgroundGFX<RGB, optionFlags>::fillHardwareRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, const RGB& color) {
+    RGB *firstRow = currentDrawBufferPtr + (y0 * bufferWidth()) + x0;
+    int width = x1 - x0 + 1;
 
-    for (i = y0; i <= y1; i++) {
-        loadPixelToDrawBuffer(x, i, color);
+    if (width == 1) {
+        drawHardwareVLine(x0, y0, y1, color);
+        return;
     }
+
+    if (width == bufferWidth()) {
+        // full rows are contiguous and can be filled as one span
+        fillPixels(firstRow, width * (y1 - y0 + 1), color);
+    } else {
+        fillPixels(firstRow, width, color);
+        for (int i = 1; i <= y1 - y0; i++)
+            memcpy((void *)(firstRow + (i * bufferWidth())), (const void *)firstRow, sizeof(RGB) * width);
+    }
+    markDrawRowsChanged(y0, y1);
 }
 
+// local coordinates, x1 >= x0, y1 >= y0, clipped to the layer, rotation is resolved once for the whole rectangle
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackgroundGFX<RGB, optionFlags>::fillLocalRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color) {
+    // check for completely out of bounds rectangle
+    if (x1 < 0 || x0 >= this->localWidth || y1 < 0 || y0 >= this->localHeight)
+        return;
+
+    // truncate if partially out of bounds
+    if (x0 < 0)
+        x0 = 0;
+    if (y0 < 0)
+        y0 = 0;
+    if (x1 >= this->localWidth)
+        x1 = this->localWidth - 1;
+    if (y1 >= this->localHeight)
+        y1 = this->localHeight - 1;
+
+    if (drawRotation() == rotation0) {
+        fillHardwareRect(x0, y0, x1, y1, color);
+    } else if (drawRotation() == rotation180) {
+        fillHardwareRect((this->matrixWidth - 1) - x1, (this->matrixHeight - 1) - y1, (this->matrixWidth - 1) - x0, (this->matrixHeight - 1) - y0, color);
+    } else if (drawRotation() == rotation90) {
+        fillHardwareRect((this->matrixWidth - 1) - y1, x0, (this->matrixWidth - 1) - y0, x1, color);
+    } else { /* if (layerRotation == rotation270)*/
+        fillHardwareRect(y0, (this->matrixHeight - 1) - x1, y1, (this->matrixHeight - 1) - x0, color);
+    }
+}
+
+/* RGB Specific SmartMatrix Library 3.0 Backwards Compatibility */
+
+#ifdef SM_BACKGROUND_GFX_BACKWARDS_COMPATIBILITY
+
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackgroundGFX<RGB, optionFlags>::drawFastHLine(int16_t x0, int16_t x1, int16_t y, const RGB& color) {
     // make sure line goes from x0 to x1
@@ -301,11 +573,11 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::drawFastHLine(int16_t x0, int16_t x
         x1 = this->localWidth - 1;
 
     // map to hardware drawline function
-    if (this->layerRotation == rotation0) {
+    if (drawRotation() == rotation0) {
         drawHardwareHLine(x0, x1, y, color);
-    } else if (this->layerRotation == rotation180) {
+    } else if (drawRotation() == rotation180) {
         drawHardwareHLine((this->matrixWidth - 1) - x1, (this->matrixWidth - 1) - x0, (this->matrixHeight - 1) - y, color);
-    } else if (this->layerRotation == rotation90) {
+    } else if (drawRotation() == rotation90) {
         drawHardwareVLine((this->matrixWidth - 1) - y, x0, x1, color);
     } else { /* if (rotation == rotation270)*/
         drawHardwareVLine(y, (this->matrixHeight - 1) - x1, (this->matrixHeight - 1) - x0, color);
@@ -330,11 +602,11 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::drawFastVLine(int16_t x, int16_t y0
         y1 = this->localHeight - 1;
 
     // map to hardware drawline function
-    if (this->layerRotation == rotation0) {
+    if (drawRotation() == rotation0) {
         drawHardwareVLine(x, y0, y1, color);
-    } else if (this->layerRotation == rotation180) {
+    } else if (drawRotation() == rotation180) {
         drawHardwareVLine((this->matrixWidth - 1) - x, (this->matrixHeight - 1) - y1, (this->matrixHeight - 1) - y0, color);
-    } else if (this->layerRotation == rotation90) {
+    } else if (drawRotation() == rotation90) {
         drawHardwareHLine((this->matrixWidth - 1) - y1, (this->matrixWidth - 1) - y0, x, color);
     } else { /* if (layerRotation == rotation270)*/
         drawHardwareHLine(y0, y1, (this->matrixHeight - 1) - x, color);
@@ -343,19 +615,14 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::drawFastVLine(int16_t x, int16_t y0
 
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackgroundGFX<RGB, optionFlags>::fillRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color) {
-    int i;
-    // Loop only works if y1 > y0
     if (y0 > y1) {
         SWAPint(y0, y1);
     };
-    // Putting the x coordinates in order saves multiple swaps in drawFastHLine
     if (x0 > x1) {
         SWAPint(x0, x1);
     };
 
-    for (i = y0; i <= y1; i++) {
-        drawFastHLine(x0, x1, i, color);
-    }
+    fillLocalRect(x0, y0, x1, y1, color);
 }
 
 template <typename RGB, unsigned int optionFlags>
@@ -368,7 +635,7 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::fillScreen(const RGB& color) {
 
 template <typename RGB, unsigned int optionFlags>
 INLINE const RGB SMLayerBackgroundGFX<RGB, optionFlags>::readPixelFromDrawBuffer(int16_t hwx, int16_t hwy) {
-    RGB pixel = currentDrawBufferPtr[(hwy * this->matrixWidth) + hwx];
+    RGB pixel = currentDrawBufferPtr[(hwy * bufferWidth()) + hwx];
     return pixel;
 }
 
@@ -382,13 +649,13 @@ const RGB SMLayerBackgroundGFX<RGB, optionFlags>::readPixel(int16_t x, int16_t y
         return (RGB){0, 0, 0};
 
     // map pixel into hardware buffer before reading
-    if (this->layerRotation == rotation0) {
+    if (drawRotation() == rotation0) {
         hwx = x;
         hwy = y;
-    } else if (this->layerRotation == rotation180) {
+    } else if (drawRotation() == rotation180) {
         hwx = (this->matrixWidth - 1) - x;
         hwy = (this->matrixHeight - 1) - y;
-    } else if (this->layerRotation == rotation90) {
+    } else if (drawRotation() == rotation90) {
         hwx = (this->matrixWidth - 1) - y;
         hwy = x;
     } else { /* if (layerRotation == rotation270)*/
@@ -402,20 +669,92 @@ const RGB SMLayerBackgroundGFX<RGB, optionFlags>::readPixel(int16_t x, int16_t y
 // return pointer to start of currentDrawBuffer, so application can do efficient loading of bitmaps
 template <typename RGB, unsigned int optionFlags>
 RGB *SMLayerBackgroundGFX<RGB, optionFlags>::backBuffer(void) {
+    // the application can change any pixel, so the whole buffer needs to be copied with the next swap
+    allRowsChangedPending = true;
     return currentDrawBufferPtr;
 }
 
 template<typename RGB, unsigned int optionFlags>
 void SMLayerBackgroundGFX<RGB, optionFlags>::setBackBuffer(RGB *newBuffer) {
+  allRowsChangedPending = true;
   currentDrawBufferPtr = newBuffer;
 }
 
 
 template<typename RGB, unsigned int optionFlags>
 RGB *SMLayerBackgroundGFX<RGB, optionFlags>::getRealBackBuffer() {
+  allRowsChangedPending = true;
   return backgroundBuffers[currentDrawBuffer];
 }
 
+// x, y, w, h are in layer coordinates, the part of the image outside the layer is skipped
+// the rotation is resolved once: each source row is written along a hardware row or column, with a single memcpy per row when
+// the source format matches and the layer isn't rotated, or a single memcpy for the whole image if it's also full width
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackgroundGFX<RGB, optionFlags>::blit(int16_t x, int16_t y, int16_t w, int16_t h, const void * src, int srcStride, blitFormat srcFormat, const rgb24 * palette) {
+    const uint8_t * srcRow = (const uint8_t *)src;
+    int hwx, hwy, xStep, yStep;
+
+    // clip to layer
+    if (x < 0) {
+        srcRow += -x * blitFormatSize(srcFormat);
+        w += x;
+        x = 0;
+    }
+    if (y < 0) {
+        srcRow += -y * srcStride;
+        h += y;
+        y = 0;
+    }
+    if (x + w > this->localWidth)
+        w = this->localWidth - x;
+    if (y + h > this->localHeight)
+        h = this->localHeight - y;
+    if (w <= 0 || h <= 0)
+        return;
+
+    // hardware position of the first pixel, and how far one step in x or y moves in the hardware buffer
+    if (drawRotation() == rotation0) {
+        hwx = x;
+        hwy = y;
+        xStep = 1;
+        yStep = bufferWidth();
+        markDrawRowsChanged(y, y + h - 1);
+    } else if (drawRotation() == rotation180) {
+        hwx = (this->matrixWidth - 1) - x;
+        hwy = (this->matrixHeight - 1) - y;
+        xStep = -1;
+        yStep = -this->matrixWidth;
+        markDrawRowsChanged(hwy - (h - 1), hwy);
+    } else if (drawRotation() == rotation90) {
+        hwx = (this->matrixWidth - 1) - y;
+        hwy = x;
+        xStep = this->matrixWidth;
+        yStep = -1;
+        markDrawRowsChanged(x, x + w - 1);
+    } else { /* if (layerRotation == rotation270)*/
+        hwx = y;
+        hwy = (this->matrixHeight - 1) - x;
+        xStep = -this->matrixWidth;
+        yStep = 1;
+        markDrawRowsChanged(hwy - (w - 1), hwy);
+    }
+
+    RGB * dst = currentDrawBufferPtr + (hwy * bufferWidth()) + hwx;
+
+    // full width rows with no padding between them are contiguous in both buffers
+    if (xStep == 1 && w == bufferWidth() && srcStride == w * blitFormatSize(srcFormat)) {
+        blitPixels(dst, 1, srcRow, w * h, srcFormat, palette);
+        return;
+    }
+
+    for (int i = 0; i < h; i++) {
+        blitPixels(dst, xStep, srcRow, w, srcFormat, palette);
+        dst += yStep;
+        srcRow += srcStride;
+    }
+}
+
 /* Shared */
 
 // numShifts must be in range of 0-4, otherwise 16-bit to 12-bit conversion code breaks (would be an easy fix, but 4 is enough for APA102 GBC application)
@@ -431,17 +770,20 @@ int SMLayerBackgroundGFX<RGB, optionFlags>::getRequestedBrightnessShifts() {
 
 template <typename RGB, unsigned int optionFlags>
 bool SMLayerBackgroundGFX<RGB, optionFlags>::isLayerChanged() {
-    return swapPending;
+    return isSwapPending() || isBackgroundLUTChanged(colorCorrectionLUT, colorCorrectionLUTUpdateCount);
 }
 
 template <typename RGB, unsigned int optionFlags>
 bool SMLayerBackgroundGFX<RGB, optionFlags>::isSwapPending(void) {
+    if (optionFlags & SM_BACKGROUND_GFX_OPTIONS_TRIPLE_BUFFER)
+        return tripleBuffer.isPending();
+
     return swapPending;
 }
 
 template<typename RGB, unsigned int optionFlags>
 void SMLayerBackgroundGFX<RGB, optionFlags>::setBrightness(uint8_t brightness) {
-    backgroundBrightness = brightness;
+    colorCorrectionLUT->layerBrightness = brightness;
 }
 
 template<typename RGB, unsigned int optionFlags>
@@ -449,6 +791,40 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::enableColorCorrection(bool enabled)
     this->ccEnabled = enabled;
 }
 
+template<typename RGB, unsigned int optionFlags>
+SM_BackgroundLUT * SMLayerBackgroundGFX<RGB, optionFlags>::getColorCorrectionLUT(void) {
+    return colorCorrectionLUT;
+}
+
+// use another background layer's table instead of our own (call before begin() to avoid allocating a table on ESP32)
+// the table holds the brightness, so the layers need the same brightness to share it, and setBrightness() then changes all of them
+// returns false if the table can't be shared
+template<typename RGB, unsigned int optionFlags>
+bool SMLayerBackgroundGFX<RGB, optionFlags>::setColorCorrectionLUT(SM_BackgroundLUT * lut) {
+    // tables are sized for the layer's depth, and can't be shared between layers with different depths
+    if(!lut || lut->size != ownColorCorrectionLUT.size)
+        return false;
+
+    if(lut->layerBrightness != colorCorrectionLUT->layerBrightness)
+        return false;
+
+    colorCorrectionLUT = lut;
+    return true;
+}
+
+// generate the color correction tables with a different gamma and white point, this applies to all layers sharing the tables
+// returns false if there isn't enough memory for the tables, and the default gamma tables are used instead
+template<typename RGB, unsigned int optionFlags>
+bool SMLayerBackgroundGFX<RGB, optionFlags>::setColorCorrection(const SM_ColorCorrection & correction) {
+    return setBackgroundLUTCorrection(colorCorrectionLUT, correction);
+}
+
+// go back to the default gamma tables
+template<typename RGB, unsigned int optionFlags>
+void SMLayerBackgroundGFX<RGB, optionFlags>::resetColorCorrection(void) {
+    clearBackgroundLUTCorrection(colorCorrectionLUT);
+}
+
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackgroundGFX<RGB, optionFlags>::setRotation(rotationDegrees newrotation) {
     this->layerRotation = newrotation;
@@ -23,14 +23,20 @@
 
 #include <stdlib.h>     
 
+#define BACKGROUND_ROWS_CHANGED_SIZE    SM_BACKGROUND_ROWS_CHANGED_SET_SIZE(optionFlags, this->matrixWidth, this->matrixHeight)
+
 // call when backgroundBuffers and backgroundColorCorrectionLUT buffer is allocated outside of class
+// rowsChangedBuffer is SM_BACKGROUND_ROWS_CHANGED_BYTES() long, it's allocated in begin() if not given
 template <typename RGB, unsigned int optionFlags>
-SMLayerBackground<RGB, optionFlags>::SMLayerBackground(RGB * buffer, uint16_t width, uint16_t height, color_chan_t * colorCorrectionLUT) {
+SMLayerBackground<RGB, optionFlags>::SMLayerBackground(RGB * buffer, uint16_t width, uint16_t height, color_chan_t * colorCorrectionLUT, uint8_t * rowsChangedBuffer) {
     backgroundBuffers[0] = buffer;
     backgroundBuffers[1] = buffer + (width * height);
-    backgroundColorCorrectionLUT = colorCorrectionLUT;
+    backgroundBuffers[2] = (optionFlags & SM_BACKGROUND_OPTIONS_TRIPLE_BUFFER) ? buffer + (2 * width * height) : NULL;
+    ownColorCorrectionLUT.table = colorCorrectionLUT;
     this->matrixWidth = width;
     this->matrixHeight = height;
+    if(rowsChangedBuffer)
+        setRowsChangedBuffer(rowsChangedBuffer);
 }
 
 // call this when buffers should be sourced from malloc inside begin()
@@ -40,6 +46,20 @@ SMLayerBackground<RGB, optionFlags>::SMLayerBackground(uint16_t width, uint16_t
     this->matrixHeight = height;
 }
 
+// the six sets of rows after refreshRowsChanged are the frameRowsChanged[] and staleRows[] used with triple buffering
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackground<RGB, optionFlags>::setRowsChangedBuffer(uint8_t * buffer) {
+    drawRowsChanged = buffer;
+    memset(drawRowsChanged, 0x00, SM_BACKGROUND_ROWS_CHANGED_BYTES(optionFlags, this->matrixWidth, this->matrixHeight));
+    unsyncedRows = drawRowsChanged + BACKGROUND_ROWS_CHANGED_SIZE;
+    refreshRowsChanged = unsyncedRows + BACKGROUND_ROWS_CHANGED_SIZE;
+
+    for(int i=0; i<3; i++) {
+        frameRowsChanged[i] = (optionFlags & SM_BACKGROUND_OPTIONS_TRIPLE_BUFFER) ? refreshRowsChanged + ((i + 1) * BACKGROUND_ROWS_CHANGED_SIZE) : NULL;
+        staleRows[i] = (optionFlags & SM_BACKGROUND_OPTIONS_TRIPLE_BUFFER) ? refreshRowsChanged + ((i + 4) * BACKGROUND_ROWS_CHANGED_SIZE) : NULL;
+    }
+}
+
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::begin(void) {
 #if defined(ESP32)
@@ -53,27 +73,34 @@ void SMLayerBackground<RGB, optionFlags>::begin(void) {
     #define ESPmalloc malloc
     #endif
     if(!backgroundBuffers[0] && !backgroundBuffers[1]) {
-        //printf("largest free block %d: \r\n", heap_caps_get_largest_free_block(MALLOC_CAP_DMA));
-        backgroundBuffers[0] = (RGB *)ESPmalloc(sizeof(RGB) * this->matrixWidth * this->matrixHeight);
-        assert(backgroundBuffers[0] != NULL);
-        //printf("largest free block %d: \r\n", heap_caps_get_largest_free_block(MALLOC_CAP_DMA));
-        backgroundBuffers[1] = (RGB *)ESPmalloc(sizeof(RGB) * this->matrixWidth * this->matrixHeight);
-        assert(backgroundBuffers[1] != NULL);
-        //printf("largest free block %d: \r\n", heap_caps_get_largest_free_block(MALLOC_CAP_DMA));
-        memset(backgroundBuffers[0], 0x00, sizeof(RGB) * this->matrixWidth * this->matrixHeight);
-        memset(backgroundBuffers[1], 0x00, sizeof(RGB) * this->matrixWidth * this->matrixHeight);
+        for(int i=0; i<SM_BACKGROUND_NUM_BUFFERS(optionFlags); i++) {
+            //printf("largest free block %d: \r\n", heap_caps_get_largest_free_block(MALLOC_CAP_DMA));
+            backgroundBuffers[i] = (RGB *)ESPmalloc(sizeof(RGB) * this->matrixWidth * this->matrixHeight);
+            assert(backgroundBuffers[i] != NULL);
+            memset(backgroundBuffers[i], 0x00, sizeof(RGB) * this->matrixWidth * this->matrixHeight);
+        }
         //printf("largest free block %d: \r\n", heap_caps_get_largest_free_block(MALLOC_CAP_DMA));
     }
-    if(!backgroundColorCorrectionLUT) {
-        backgroundColorCorrectionLUT = (color_chan_t *)malloc(sizeof(color_chan_t) * (sizeof(RGB) <= 3 ? 256 : 4096));
-        assert(backgroundColorCorrectionLUT != NULL);
+    // no need for our own table if sharing another layer's table
+    if(!colorCorrectionLUT->table) {
+        colorCorrectionLUT->table = (color_chan_t *)malloc(sizeof(color_chan_t) * colorCorrectionLUT->size);
+        assert(colorCorrectionLUT->table != NULL);
         //printf("largest free block %d: \r\n", heap_caps_get_largest_free_block(MALLOC_CAP_DMA));
     }
 #endif
+    if(!drawRowsChanged) {
+        uint8_t * rowsChangedBuffer = (uint8_t *)malloc(SM_BACKGROUND_ROWS_CHANGED_BYTES(optionFlags, this->matrixWidth, this->matrixHeight));
+#ifdef ESP32
+        assert(rowsChangedBuffer != NULL);
+#endif
+        setRowsChangedBuffer(rowsChangedBuffer);
+    }
     
     currentDrawBuffer = 0;
     currentRefreshBuffer = 1;
     swapPending = false;
+    // starts with the same buffers as above, all buffers start out cleared so none of the staleRows are set
+    tripleBuffer.init();
     font = (bitmap_font *) &apple3x5;
 
     currentDrawBufferPtr = backgroundBuffers[0];
@@ -84,10 +111,15 @@ template <typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::frameRefreshCallback(void) {
     handleBufferSwap();
 
-    if(sizeof(RGB) > 3)
-        calculate12BitBackgroundLUT(backgroundColorCorrectionLUT, backgroundBrightness);
-    else
-        calculate8BitBackgroundLUT(backgroundColorCorrectionLUT, backgroundBrightness);
+    // the tables are only recalculated after a brightness or correction change, which may come from another layer sharing them
+    updateBackgroundLUT<SM_BACKGROUND_LUT_SIZE(RGB)>(colorCorrectionLUT);
+    if(colorCorrectionLUT->updateCount != colorCorrectionLUTUpdateCount) {
+        colorCorrectionLUTUpdateCount = colorCorrectionLUT->updateCount;
+        memset(refreshRowsChanged, 0xFF, BACKGROUND_ROWS_CHANGED_SIZE);
+    }
+    redColorCorrectionLUT = colorCorrectionLUT->channelLUT[0];
+    greenColorCorrectionLUT = colorCorrectionLUT->channelLUT[1];
+    blueColorCorrectionLUT = colorCorrectionLUT->channelLUT[2];
 }
 
 template <typename RGB, unsigned int optionFlags>
@@ -97,7 +129,38 @@ int SMLayerBackground<RGB, optionFlags>::getRequestedBrightnessShifts() {
 
 template <typename RGB, unsigned int optionFlags>
 bool SMLayerBackground<RGB, optionFlags>::isLayerChanged() {
-    return swapPending;
+    return isSwapPending() || isBackgroundLUTChanged(colorCorrectionLUT, colorCorrectionLUTUpdateCount);
+}
+
+template <typename RGB, unsigned int optionFlags>
+bool SMLayerBackground<RGB, optionFlags>::isRefreshRowChanged(uint16_t hardwareY) {
+    if (optionFlags & SM_BACKGROUND_OPTIONS_LOCAL_STORAGE) {
+        if (this->layerRotation == rotation180) {
+            hardwareY = (this->matrixHeight - 1) - hardwareY;
+        } else if (this->layerRotation != rotation0) {
+            // each hardware row has a pixel from every buffer row
+            for (int i = 0; i < BACKGROUND_ROWS_CHANGED_SIZE; i++) {
+                if (refreshRowsChanged[i])
+                    return true;
+            }
+            return false;
+        }
+    }
+
+    return refreshRowsChanged[hardwareY / 8] & (0x01 << (hardwareY % 8));
+}
+
+// used when the drawing buffer may have been changed outside of loadPixelToDrawBuffer(), or all pixels need to be recalculated
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackground<RGB, optionFlags>::markAllDrawRowsChanged(void) {
+    allRowsChangedPending = true;
+}
+
+// hardware rows y0-y1
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackground<RGB, optionFlags>::markDrawRowsChanged(uint16_t y0, uint16_t y1) {
+    for (int i = y0; i <= y1; i++)
+        drawRowsChanged[i / 8] |= (0x01 << (i % 8));
 }
 
 // numShifts must be in range of 0-4, otherwise 16-bit to 12-bit conversion code breaks (would be an easy fix, but 4 is enough for APA102 GBC application)
@@ -111,29 +174,42 @@ void SMLayerBackground<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb
     RGB currentPixel;
     int i;
 
-    RGB *ptr = currentRefreshBufferPtr + (hardwareY * this->matrixWidth);
+    int step;
+    RGB *ptr = getRefreshRowStart(hardwareY, step);
 
     if(this->ccEnabled) {
         for(i=0; i<this->matrixWidth; i++) {
-            currentPixel = *ptr++;
+            currentPixel = *ptr;
+            ptr += step;
             // load background pixel with color correction
-            if(sizeof(RGB) <= 3) {
-                // 24-bit source (8 bits per color channel): backgroundColorCorrectionLUT expects 8-bit value, returns 16-bit value
-                refreshRow[i] = rgb48(backgroundColorCorrectionLUT[currentPixel.red << brightnessShifts],
-                    backgroundColorCorrectionLUT[currentPixel.green << brightnessShifts],
-                    backgroundColorCorrectionLUT[currentPixel.blue << brightnessShifts]);                
+            if(sizeof(RGB) <= 2) {
+                // 16-bit source (5/6/5 bits per color channel): color correction LUTs expect 6-bit value, returns 16-bit value
+                refreshRow[i] = rgb48(redColorCorrectionLUT[smExpand5to6(currentPixel.red) << brightnessShifts],
+                    greenColorCorrectionLUT[currentPixel.green << brightnessShifts],
+                    blueColorCorrectionLUT[smExpand5to6(currentPixel.blue) << brightnessShifts]);
+            } else if(sizeof(RGB) <= 3) {
+                // 24-bit source (8 bits per color channel): color correction LUTs expect 8-bit value, returns 16-bit value
+                refreshRow[i] = rgb48(redColorCorrectionLUT[currentPixel.red << brightnessShifts],
+                    greenColorCorrectionLUT[currentPixel.green << brightnessShifts],
+                    blueColorCorrectionLUT[currentPixel.blue << brightnessShifts]);                
             } else {
-                // 48-bit source (16 bits per color channel): backgroundColorCorrectionLUT expects 12-bit value, returns 16-bit value
-                refreshRow[i] = rgb48(backgroundColorCorrectionLUT[currentPixel.red >> (4 - brightnessShifts)],
-                    backgroundColorCorrectionLUT[currentPixel.green >> (4 - brightnessShifts)],
-                    backgroundColorCorrectionLUT[currentPixel.blue >> (4 - brightnessShifts)]);
+                // 48-bit source (16 bits per color channel): color correction LUTs expect 12-bit value, returns 16-bit value
+                refreshRow[i] = rgb48(redColorCorrectionLUT[currentPixel.red >> (4 - brightnessShifts)],
+                    greenColorCorrectionLUT[currentPixel.green >> (4 - brightnessShifts)],
+                    blueColorCorrectionLUT[currentPixel.blue >> (4 - brightnessShifts)]);
             }
         }
     } else {
         for(i=0; i<this->matrixWidth; i++) {
-            currentPixel = *ptr++;
+            currentPixel = *ptr;
+            ptr += step;
             // load background pixel without color correction
-            if(sizeof(RGB) <= 3) {
+            if(sizeof(RGB) <= 2) {
+                // 16-bit source (5/6/5 bits per color channel): expand to 16-bit color channel
+                refreshRow[i] = rgb48(cs_scale5to16[currentPixel.red] << brightnessShifts,
+                    cs_scale6to16[currentPixel.green] << brightnessShifts,
+                    cs_scale5to16[currentPixel.blue] << brightnessShifts);
+            } else if(sizeof(RGB) <= 3) {
                 // 24-bit source (8 bits per color channel): shift to fit in 16-bit color channel
                 refreshRow[i] = rgb48(currentPixel.red << (brightnessShifts + 8),
                     currentPixel.green << (brightnessShifts + 8),
@@ -153,29 +229,41 @@ void SMLayerBackground<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb
     RGB currentPixel;
     int i;
 
-    RGB *ptr = currentRefreshBufferPtr + (hardwareY * this->matrixWidth);
+    int step;
+    RGB *ptr = getRefreshRowStart(hardwareY, step);
 
     if(this->ccEnabled) {
         for(i=0; i<this->matrixWidth; i++) {
-            currentPixel = *ptr++;
+            currentPixel = *ptr;
+            ptr += step;
             // load background pixel with color correction
-            if(sizeof(RGB) <= 3) {
-                // 24-bit source (8 bits per color channel): backgroundColorCorrectionLUT expects 8-bit value, returns 16-bit value
-                refreshRow[i] = rgb48(backgroundColorCorrectionLUT[currentPixel.red << brightnessShifts],
-                    backgroundColorCorrectionLUT[currentPixel.green << brightnessShifts],
-                    backgroundColorCorrectionLUT[currentPixel.blue << brightnessShifts]);                
+            if(sizeof(RGB) <= 2) {
+                // 16-bit source (5/6/5 bits per color channel): color correction LUTs expect 6-bit value, returns 16-bit value
+                refreshRow[i] = rgb48(redColorCorrectionLUT[smExpand5to6(currentPixel.red) << brightnessShifts],
+                    greenColorCorrectionLUT[currentPixel.green << brightnessShifts],
+                    blueColorCorrectionLUT[smExpand5to6(currentPixel.blue) << brightnessShifts]);
+            } else if(sizeof(RGB) <= 3) {
+                // 24-bit source (8 bits per color channel): color correction LUTs expect 8-bit value, returns 16-bit value
+                refreshRow[i] = rgb48(redColorCorrectionLUT[currentPixel.red << brightnessShifts],
+                    greenColorCorrectionLUT[currentPixel.green << brightnessShifts],
+                    blueColorCorrectionLUT[currentPixel.blue << brightnessShifts]);                
             } else {
-                // 48-bit source (16 bits per color channel): backgroundColorCorrectionLUT expects 12-bit value, returns 16-bit value
-                refreshRow[i] = rgb48(backgroundColorCorrectionLUT[currentPixel.red >> (4 - brightnessShifts)],
-                    backgroundColorCorrectionLUT[currentPixel.green >> (4 - brightnessShifts)],
-                    backgroundColorCorrectionLUT[currentPixel.blue >> (4 - brightnessShifts)]);
+                // 48-bit source (16 bits per color channel): color correction LUTs expect 12-bit value, returns 16-bit value
+                refreshRow[i] = rgb48(redColorCorrectionLUT[currentPixel.red >> (4 - brightnessShifts)],
+                    greenColorCorrectionLUT[currentPixel.green >> (4 - brightnessShifts)],
+                    blueColorCorrectionLUT[currentPixel.blue >> (4 - brightnessShifts)]);
             }
         }
     } else {
         for(i=0; i<this->matrixWidth; i++) {
-            currentPixel = *ptr++;
+            currentPixel = *ptr;
+            ptr += step;
             // load background pixel without color correction
-            if(sizeof(RGB) <= 3) {
+            if(sizeof(RGB) <= 2) {
+                refreshRow[i] = rgb24(cs_scale5to8[currentPixel.red] << brightnessShifts,
+                    cs_scale6to8[currentPixel.green] << brightnessShifts,
+                    cs_scale5to8[currentPixel.blue] << brightnessShifts);
+            } else if(sizeof(RGB) <= 3) {
                 refreshRow[i] = rgb24(currentPixel.red << brightnessShifts,
                     currentPixel.green << brightnessShifts,
                     currentPixel.blue << brightnessShifts);
@@ -188,19 +276,64 @@ void SMLayerBackground<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb
     }
 }
 
+// every pixel in the row is drawn, the layers below are never visible
+template <typename RGB, unsigned int optionFlags>
+SM_RefreshSpan SMLayerBackground<RGB, optionFlags>::getRefreshRowSpan(uint16_t hardwareY) {
+    SM_RefreshSpan span = {0, this->matrixWidth, true};
+    return span;
+}
+
 extern volatile int totalFramesToInterpolate;
 extern volatile int framesInterpolated;
 
 #define INLINE __attribute__( ( always_inline ) ) inline
 
+template <typename RGB, unsigned int optionFlags>
+INLINE rotationDegrees SMLayerBackground<RGB, optionFlags>::drawRotation(void) {
+    return (optionFlags & SM_BACKGROUND_OPTIONS_LOCAL_STORAGE) ? rotation0 : this->layerRotation;
+}
+
+template <typename RGB, unsigned int optionFlags>
+INLINE uint16_t SMLayerBackground<RGB, optionFlags>::bufferWidth(void) {
+    return (optionFlags & SM_BACKGROUND_OPTIONS_LOCAL_STORAGE) ? this->localWidth : this->matrixWidth;
+}
+
+template <typename RGB, unsigned int optionFlags>
+INLINE uint16_t SMLayerBackground<RGB, optionFlags>::bufferHeight(void) {
+    return (optionFlags & SM_BACKGROUND_OPTIONS_LOCAL_STORAGE) ? this->localHeight : this->matrixHeight;
+}
+
+// returns the first pixel of hardware row hardwareY in the refresh buffer, and the distance to the next pixel in the row
+// with local storage in rotation90/270 the hardware row is a buffer column, read with a stride of one buffer row: the refresh
+// reads nearby hardware rows one after another, so the buffer rows they share stay in the cache on parts that have one
+template <typename RGB, unsigned int optionFlags>
+INLINE RGB *SMLayerBackground<RGB, optionFlags>::getRefreshRowStart(uint16_t hardwareY, int &step) {
+    if (!(optionFlags & SM_BACKGROUND_OPTIONS_LOCAL_STORAGE) || this->layerRotation == rotation0) {
+        step = 1;
+        return currentRefreshBufferPtr + (hardwareY * this->matrixWidth);
+    } else if (this->layerRotation == rotation180) {
+        step = -1;
+        return currentRefreshBufferPtr + (((this->matrixHeight - 1) - hardwareY) * this->matrixWidth) + (this->matrixWidth - 1);
+    } else if (this->layerRotation == rotation90) {
+        // buffer is matrixHeight pixels wide, hardware x is (matrixWidth - 1) - local y
+        step = -this->matrixHeight;
+        return currentRefreshBufferPtr + ((this->matrixWidth - 1) * this->matrixHeight) + hardwareY;
+    } else { /* if (layerRotation == rotation270)*/
+        // hardware x is local y
+        step = this->matrixHeight;
+        return currentRefreshBufferPtr + ((this->matrixHeight - 1) - hardwareY);
+    }
+}
+
 template <typename RGB, unsigned int optionFlags>
 INLINE void SMLayerBackground<RGB, optionFlags>::loadPixelToDrawBuffer(int16_t hwx, int16_t hwy, const RGB& color) {
-    currentDrawBufferPtr[(hwy * this->matrixWidth) + hwx] = color;
+    currentDrawBufferPtr[(hwy * bufferWidth()) + hwx] = color;
+    drawRowsChanged[hwy / 8] |= (0x01 << (hwy % 8));
 }
 
 template <typename RGB, unsigned int optionFlags>
 INLINE const RGB SMLayerBackground<RGB, optionFlags>::readPixelFromDrawBuffer(int16_t hwx, int16_t hwy) {
-    RGB pixel = currentDrawBufferPtr[(hwy * this->matrixWidth) + hwx];
+    RGB pixel = currentDrawBufferPtr[(hwy * bufferWidth()) + hwx];
     return pixel;
 }
 
@@ -213,13 +346,13 @@ void SMLayerBackground<RGB, optionFlags>::drawPixel(int16_t x, int16_t y, const
         return;
 
     // map pixel into hardware buffer before writing
-    if (this->layerRotation == rotation0) {
+    if (drawRotation() == rotation0) {
         hwx = x;
         hwy = y;
-    } else if (this->layerRotation == rotation180) {
+    } else if (drawRotation() == rotation180) {
         hwx = (this->matrixWidth - 1) - x;
         hwy = (this->matrixHeight - 1) - y;
-    } else if (this->layerRotation == rotation90) {
+    } else if (drawRotation() == rotation90) {
         hwx = (this->matrixWidth - 1) - y;
         hwy = x;
     } else { /* if (layerRotation == rotation270)*/
@@ -233,21 +366,42 @@ void SMLayerBackground<RGB, optionFlags>::drawPixel(int16_t x, int16_t y, const
 // x0, x1, and y must be in bounds (0-this->localWidth/Height-1), x1 > x0
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::drawHardwareHLine(uint16_t x0, uint16_t x1, uint16_t y, const RGB& color) {
-    int i;
-
-    for (i = x0; i <= x1; i++) {
-        loadPixelToDrawBuffer(i, y, color);
-    }
+    fillPixels(currentDrawBufferPtr + (y * bufferWidth()) + x0, x1 - x0 + 1, color);
+    drawRowsChanged[y / 8] |= (0x01 << (y % 8));
 }
 
 // x, y0, and y1 must be in bounds (0-this->localWidth/Height-1), y1 > y0
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::drawHardwareVLine(uint16_t x, uint16_t y0, uint16_t y1, const RGB& color) {
-    int i;
+    RGB *ptr = currentDrawBufferPtr + (y0 * bufferWidth()) + x;
+
+    for (int i = y0; i <= y1; i++) {
+        *ptr = color;
+        ptr += bufferWidth();
+    }
+    markDrawRowsChanged(y0, y1);
+}
+
+// hardware coordinates, must be in bounds, x1 >= x0, y1 >= y0
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackground<RGB, optionFlags>::fillHardwareRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, const RGB& color) {
+    RGB *firstRow = currentDrawBufferPtr + (y0 * bufferWidth()) + x0;
+    int width = x1 - x0 + 1;
 
-    for (i = y0; i <= y1; i++) {
-        loadPixelToDrawBuffer(x, i, color);
+    if (width == 1) {
+        drawHardwareVLine(x0, y0, y1, color);
+        return;
     }
+
+    if (width == bufferWidth()) {
+        // full rows are contiguous and can be filled as one span
+        fillPixels(firstRow, width * (y1 - y0 + 1), color);
+    } else {
+        fillPixels(firstRow, width, color);
+        for (int i = 1; i <= y1 - y0; i++)
+            memcpy((void *)(firstRow + (i * bufferWidth())), (const void *)firstRow, sizeof(RGB) * width);
+    }
+    markDrawRowsChanged(y0, y1);
 }
 
 template <typename RGB, unsigned int optionFlags>
@@ -268,11 +422,11 @@ void SMLayerBackground<RGB, optionFlags>::drawFastHLine(int16_t x0, int16_t x1,
         x1 = this->localWidth - 1;
 
     // map to hardware drawline function
-    if (this->layerRotation == rotation0) {
+    if (drawRotation() == rotation0) {
         drawHardwareHLine(x0, x1, y, color);
-    } else if (this->layerRotation == rotation180) {
+    } else if (drawRotation() == rotation180) {
         drawHardwareHLine((this->matrixWidth - 1) - x1, (this->matrixWidth - 1) - x0, (this->matrixHeight - 1) - y, color);
-    } else if (this->layerRotation == rotation90) {
+    } else if (drawRotation() == rotation90) {
         drawHardwareVLine((this->matrixWidth - 1) - y, x0, x1, color);
     } else { /* if (rotation == rotation270)*/
         drawHardwareVLine(y, (this->matrixHeight - 1) - x1, (this->matrixHeight - 1) - x0, color);
@@ -297,11 +451,11 @@ void SMLayerBackground<RGB, optionFlags>::drawFastVLine(int16_t x, int16_t y0, i
         y1 = this->localHeight - 1;
 
     // map to hardware drawline function
-    if (this->layerRotation == rotation0) {
+    if (drawRotation() == rotation0) {
         drawHardwareVLine(x, y0, y1, color);
-    } else if (this->layerRotation == rotation180) {
+    } else if (drawRotation() == rotation180) {
         drawHardwareVLine((this->matrixWidth - 1) - x, (this->matrixHeight - 1) - y1, (this->matrixHeight - 1) - y0, color);
-    } else if (this->layerRotation == rotation90) {
+    } else if (drawRotation() == rotation90) {
         drawHardwareHLine((this->matrixWidth - 1) - y1, (this->matrixWidth - 1) - y0, x, color);
     } else { /* if (layerRotation == rotation270)*/
         drawHardwareHLine(y0, y1, (this->matrixHeight - 1) - x, color);
@@ -842,18 +996,36 @@ void SMLayerBackground<RGB, optionFlags>::drawRectangle(int16_t x0, int16_t y0,
 
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::fillRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color) {
-    int i;
-// Loop only works if y1 > y0
     if (y0 > y1) {
         SWAPint(y0, y1);
     };
-// Putting the x coordinates in order saves multiple swaps in drawFastHLine
     if (x0 > x1) {
         SWAPint(x0, x1);
     };
 
-    for (i = y0; i <= y1; i++) {
-        drawFastHLine(x0, x1, i, color);
+    // check for completely out of bounds rectangle
+    if (x1 < 0 || x0 >= this->localWidth || y1 < 0 || y0 >= this->localHeight)
+        return;
+
+    // truncate if partially out of bounds
+    if (x0 < 0)
+        x0 = 0;
+    if (y0 < 0)
+        y0 = 0;
+    if (x1 >= this->localWidth)
+        x1 = this->localWidth - 1;
+    if (y1 >= this->localHeight)
+        y1 = this->localHeight - 1;
+
+    // map to hardware coordinates once for the whole rectangle
+    if (drawRotation() == rotation0) {
+        fillHardwareRect(x0, y0, x1, y1, color);
+    } else if (drawRotation() == rotation180) {
+        fillHardwareRect((this->matrixWidth - 1) - x1, (this->matrixHeight - 1) - y1, (this->matrixWidth - 1) - x0, (this->matrixHeight - 1) - y0, color);
+    } else if (drawRotation() == rotation90) {
+        fillHardwareRect((this->matrixWidth - 1) - y1, x0, (this->matrixWidth - 1) - y0, x1, color);
+    } else { /* if (layerRotation == rotation270)*/
+        fillHardwareRect(y0, (this->matrixHeight - 1) - x1, y1, (this->matrixHeight - 1) - x0, color);
     }
 }
 
@@ -939,11 +1111,28 @@ void SMLayerBackground<RGB, optionFlags>::drawMonoBitmap(int16_t x, int16_t y, u
 
 template <typename RGB, unsigned int optionFlags>
 bool SMLayerBackground<RGB, optionFlags>::isSwapPending(void) {
+    if(optionFlags & SM_BACKGROUND_OPTIONS_TRIPLE_BUFFER)
+        return tripleBuffer.isPending();
+
     return swapPending;
 }
 
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::handleBufferSwap(void) {
+    if (optionFlags & SM_BACKGROUND_OPTIONS_TRIPLE_BUFFER) {
+        uint32_t framesSwapped = tripleBuffer.update();
+        if(!framesSwapped)
+            return;
+
+        currentRefreshBuffer = tripleBuffer.getRefreshIndex();
+        currentRefreshBufferPtr = backgroundBuffers[currentRefreshBuffer];
+
+        // the rows changed are relative to the previous frame, if frames were dropped all rows need to be recalculated
+        for (int i = 0; i < BACKGROUND_ROWS_CHANGED_SIZE; i++)
+            refreshRowsChanged[i] = (framesSwapped == 1) ? frameRowsChanged[currentRefreshBuffer][i] : 0xFF;
+        return;
+    }
+
     if (!swapPending)
         return;
 
@@ -955,13 +1144,48 @@ void SMLayerBackground<RGB, optionFlags>::handleBufferSwap(void) {
     currentRefreshBufferPtr = backgroundBuffers[currentRefreshBuffer];
     currentDrawBufferPtr = backgroundBuffers[currentDrawBuffer];
 
+    // the new refresh buffer differs from the old one in rows drawn since the last swap, and rows drawn into either buffer since they were last copied
+    for (int i = 0; i < BACKGROUND_ROWS_CHANGED_SIZE; i++) {
+        unsyncedRows[i] |= allRowsChangedPending ? 0xFF : drawRowsChanged[i];
+        refreshRowsChanged[i] = unsyncedRows[i];
+        drawRowsChanged[i] = 0x00;
+    }
+    allRowsChangedPending = false;
+
     swapPending = false;
 }
 
 // waits until previous swap is complete
 // waits until current swap is complete if copy is enabled
+// with SM_BACKGROUND_OPTIONS_TRIPLE_BUFFER, never waits: copy is from the frame just swapped and not the refresh buffer
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::swapBuffers(bool copy) {
+    if (optionFlags & SM_BACKGROUND_OPTIONS_TRIPLE_BUFFER) {
+        int newFrame = tripleBuffer.getDrawIndex();
+
+        // the new frame differs from the previous frame in rows drawn, and rows that weren't up to date when drawing started
+        // the other two buffers now may differ from the newest frame in those rows as well
+        for (int i = 0; i < BACKGROUND_ROWS_CHANGED_SIZE; i++) {
+            uint8_t rowsChanged = allRowsChangedPending ? 0xFF : (drawRowsChanged[i] | staleRows[newFrame][i]);
+            frameRowsChanged[newFrame][i] = rowsChanged;
+            for (int j = 0; j < 3; j++)
+                staleRows[j][i] = (j == newFrame) ? 0x00 : (staleRows[j][i] | rowsChanged);
+            drawRowsChanged[i] = 0x00;
+        }
+        allRowsChangedPending = false;
+
+        tripleBuffer.publish();
+
+        currentDrawBuffer = tripleBuffer.getDrawIndex();
+        currentDrawBufferPtr = backgroundBuffers[currentDrawBuffer];
+
+        if (copy) {
+            copyRows(currentDrawBufferPtr, backgroundBuffers[newFrame], staleRows[currentDrawBuffer]);
+            memset(staleRows[currentDrawBuffer], 0x00, BACKGROUND_ROWS_CHANGED_SIZE);
+        }
+        return;
+    }
+
     while (swapPending);
 
     swapPending = true;
@@ -970,10 +1194,11 @@ void SMLayerBackground<RGB, optionFlags>::swapBuffers(bool copy) {
         while (swapPending);
 #if 1
         // workaround for bizarre (optimization) bug - currentDrawBuffer and currentRefreshBuffer are volatile and are changed by an ISR while we're waiting for swapPending here.  They can't be used as parameters to memcpy directly though.  
+        // the buffers only differ in unsyncedRows, so only those rows are copied
         if(currentDrawBuffer)
-            memcpy(backgroundBuffers[1], backgroundBuffers[0], sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
+            copyRows(backgroundBuffers[1], backgroundBuffers[0], unsyncedRows);
         else
-            memcpy(backgroundBuffers[0], backgroundBuffers[1], sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
+            copyRows(backgroundBuffers[0], backgroundBuffers[1], unsyncedRows);
 #else
         // Similar code also drawing from volatile variables doesn't work if optimization is turned on: currentDrawBuffer will be equal to currentRefreshBuffer and cause a crash from memcpy copying a buffer to itself.  Why?
         memcpy(backgroundBuffers[currentDrawBuffer], backgroundBuffers[currentRefreshBuffer], sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
@@ -985,35 +1210,106 @@ void SMLayerBackground<RGB, optionFlags>::swapBuffers(bool copy) {
         //if(currentDrawBuffer != currentRefreshBuffer)     
         //   memcpy(backgroundBuffers[currentDrawBuffer], backgroundBuffers[currentRefreshBuffer], sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
 #endif
+        // the drawing buffer now matches the refresh buffer
+        memset(unsyncedRows, 0x00, BACKGROUND_ROWS_CHANGED_SIZE);
+    }
+}
+
+// copies each run of consecutive rows with a single memcpy
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackground<RGB, optionFlags>::copyRows(RGB * dst, const RGB * src, const uint8_t * rows) {
+    int y = 0;
+
+    while (y < bufferHeight()) {
+        if (!(rows[y / 8] & (0x01 << (y % 8)))) {
+            y++;
+            continue;
+        }
+
+        int firstRow = y;
+        while (y < bufferHeight() && (rows[y / 8] & (0x01 << (y % 8))))
+            y++;
+
+        memcpy(dst + (firstRow * bufferWidth()), src + (firstRow * bufferWidth()), sizeof(RGB) * bufferWidth() * (y - firstRow));
     }
 }
 
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::copyRefreshToDrawing() {
-    memcpy(currentDrawBufferPtr, currentRefreshBufferPtr, sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
+    if (optionFlags & SM_BACKGROUND_OPTIONS_TRIPLE_BUFFER) {
+        // the refresh buffer can change at any time, the newest frame is what will be refreshed next
+        memcpy(currentDrawBufferPtr, backgroundBuffers[tripleBuffer.getNewestIndex()], sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
+        memset(staleRows[currentDrawBuffer], 0x00, BACKGROUND_ROWS_CHANGED_SIZE);
+    } else {
+        memcpy(currentDrawBufferPtr, currentRefreshBufferPtr, sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
+    }
+    memset(drawRowsChanged, 0x00, BACKGROUND_ROWS_CHANGED_SIZE);
+    memset(unsyncedRows, 0x00, BACKGROUND_ROWS_CHANGED_SIZE);
+    allRowsChangedPending = false;
 }
 
 // return pointer to start of currentDrawBuffer, so application can do efficient loading of bitmaps
 template <typename RGB, unsigned int optionFlags>
 RGB *SMLayerBackground<RGB, optionFlags>::backBuffer(void) {
+    markAllDrawRowsChanged();
     return currentDrawBufferPtr;
 }
 
 template<typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::setBackBuffer(RGB *newBuffer) {
+  markAllDrawRowsChanged();
   currentDrawBufferPtr = newBuffer;
 }
 
 template<typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::setBrightness(uint8_t brightness) {
-    backgroundBrightness = brightness;
+    // the new tables mark every refresh row changed in frameRefreshCallback(), the buffers themselves don't change
+    colorCorrectionLUT->layerBrightness = brightness;
 }
 
 template<typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::enableColorCorrection(bool enabled) {
+    markAllDrawRowsChanged();
     this->ccEnabled = enabled;
 }
 
+template<typename RGB, unsigned int optionFlags>
+SM_BackgroundLUT * SMLayerBackground<RGB, optionFlags>::getColorCorrectionLUT(void) {
+    return colorCorrectionLUT;
+}
+
+// use another background layer's table instead of our own (call before begin() to avoid allocating a table on ESP32)
+// the table holds the brightness, so the layers need the same brightness to share it, and setBrightness() then changes all of them
+// returns false if the table can't be shared
+template<typename RGB, unsigned int optionFlags>
+bool SMLayerBackground<RGB, optionFlags>::setColorCorrectionLUT(SM_BackgroundLUT * lut) {
+    // tables are sized for the layer's depth, and can't be shared between layers with different depths
+    if(!lut || lut->size != ownColorCorrectionLUT.size)
+        return false;
+
+    if(lut->layerBrightness != colorCorrectionLUT->layerBrightness)
+        return false;
+
+    markAllDrawRowsChanged();
+    colorCorrectionLUT = lut;
+    return true;
+}
+
+// generate the color correction tables with a different gamma and white point, this applies to all layers sharing the tables
+// returns false if there isn't enough memory for the tables, and the default gamma tables are used instead
+template<typename RGB, unsigned int optionFlags>
+bool SMLayerBackground<RGB, optionFlags>::setColorCorrection(const SM_ColorCorrection & correction) {
+    markAllDrawRowsChanged();
+    return setBackgroundLUTCorrection(colorCorrectionLUT, correction);
+}
+
+// go back to the default gamma tables
+template<typename RGB, unsigned int optionFlags>
+void SMLayerBackground<RGB, optionFlags>::resetColorCorrection(void) {
+    markAllDrawRowsChanged();
+    clearBackgroundLUTCorrection(colorCorrectionLUT);
+}
+
 // reads pixel from drawing buffer, not refresh buffer
 template<typename RGB, unsigned int optionFlags>
 const RGB SMLayerBackground<RGB, optionFlags>::readPixel(int16_t x, int16_t y) {
@@ -1024,13 +1320,13 @@ const RGB SMLayerBackground<RGB, optionFlags>::readPixel(int16_t x, int16_t y) {
         return (RGB){0, 0, 0};
 
     // map pixel into hardware buffer before reading
-    if (this->layerRotation == rotation0) {
+    if (drawRotation() == rotation0) {
         hwx = x;
         hwy = y;
-    } else if (this->layerRotation == rotation180) {
+    } else if (drawRotation() == rotation180) {
         hwx = (this->matrixWidth - 1) - x;
         hwy = (this->matrixHeight - 1) - y;
-    } else if (this->layerRotation == rotation90) {
+    } else if (drawRotation() == rotation90) {
         hwx = (this->matrixWidth - 1) - y;
         hwy = x;
     } else { /* if (layerRotation == rotation270)*/
@@ -1043,10 +1339,79 @@ const RGB SMLayerBackground<RGB, optionFlags>::readPixel(int16_t x, int16_t y) {
 
 template<typename RGB, unsigned int optionFlags>
 RGB *SMLayerBackground<RGB, optionFlags>::getRealBackBuffer() {
+  markAllDrawRowsChanged();
   return backgroundBuffers[currentDrawBuffer];
 }
 
+// x, y, w, h are in layer coordinates, the part of the image outside the layer is skipped
+// the rotation is resolved once: each source row is written along a hardware row or column, with a single memcpy per row when
+// the source format matches and the layer isn't rotated, or a single memcpy for the whole image if it's also full width
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackground<RGB, optionFlags>::blit(int16_t x, int16_t y, int16_t w, int16_t h, const void * src, int srcStride, blitFormat srcFormat, const rgb24 * palette) {
+    const uint8_t * srcRow = (const uint8_t *)src;
+    int hwx, hwy, xStep, yStep;
+
+    // clip to layer
+    if (x < 0) {
+        srcRow += -x * blitFormatSize(srcFormat);
+        w += x;
+        x = 0;
+    }
+    if (y < 0) {
+        srcRow += -y * srcStride;
+        h += y;
+        y = 0;
+    }
+    if (x + w > this->localWidth)
+        w = this->localWidth - x;
+    if (y + h > this->localHeight)
+        h = this->localHeight - y;
+    if (w <= 0 || h <= 0)
+        return;
+
+    // hardware position of the first pixel, and how far one step in x or y moves in the hardware buffer
+    if (drawRotation() == rotation0) {
+        hwx = x;
+        hwy = y;
+        xStep = 1;
+        yStep = bufferWidth();
+        markDrawRowsChanged(y, y + h - 1);
+    } else if (drawRotation() == rotation180) {
+        hwx = (this->matrixWidth - 1) - x;
+        hwy = (this->matrixHeight - 1) - y;
+        xStep = -1;
+        yStep = -this->matrixWidth;
+        markDrawRowsChanged(hwy - (h - 1), hwy);
+    } else if (drawRotation() == rotation90) {
+        hwx = (this->matrixWidth - 1) - y;
+        hwy = x;
+        xStep = this->matrixWidth;
+        yStep = -1;
+        markDrawRowsChanged(x, x + w - 1);
+    } else { /* if (layerRotation == rotation270)*/
+        hwx = y;
+        hwy = (this->matrixHeight - 1) - x;
+        xStep = -this->matrixWidth;
+        yStep = 1;
+        markDrawRowsChanged(hwy - (w - 1), hwy);
+    }
+
+    RGB * dst = currentDrawBufferPtr + (hwy * bufferWidth()) + hwx;
+
+    // full width rows with no padding between them are contiguous in both buffers
+    if (xStep == 1 && w == bufferWidth() && srcStride == w * blitFormatSize(srcFormat)) {
+        blitPixels(dst, 1, srcRow, w * h, srcFormat, palette);
+        return;
+    }
+
+    for (int i = 0; i < h; i++) {
+        blitPixels(dst, xStep, srcRow, w, srcFormat, palette);
+        dst += yStep;
+        srcRow += srcStride;
+    }
+}
+
 template<typename RGB, unsigned int optionFlags>
 RGB *SMLayerBackground<RGB, optionFlags>::getCurrentRefreshRow(uint16_t y) {
-  return &currentRefreshBufferPtr[y*this->matrixWidth];
+  return &currentRefreshBufferPtr[y*bufferWidth()];
 }
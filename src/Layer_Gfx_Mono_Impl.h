@@ -167,6 +167,26 @@ void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::fillRefreshRowTemplated(
     }
 }
 
+// the layer only covers the rows and columns swept in fillRefreshRowTemplated(), and is opaque there unless transparency is enabled
+template <typename RGB_API, typename RGB_STORAGE, unsigned int optionFlags>
+SM_RefreshSpan SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::getRefreshRowSpan(uint16_t hardwareY) {
+    SM_RefreshSpan span = {0, 0, !transparencyEnabled};
+
+    int16_t layerY = hardwareY - layerYOffset;
+
+    if((layerY > (this->layerHeight - 1)) || (layerY < 0))
+        return span;
+
+    int16_t iRangeMin = max((int)0, (int)layerXOffset);
+    int16_t iRangeMax = min((int)this->matrixWidth, (int)(this->layerWidth + layerXOffset));
+
+    if(iRangeMin < iRangeMax) {
+        span.x0 = iRangeMin;
+        span.x1 = iRangeMax;
+    }
+    return span;
+}
+
 template <typename RGB_API, typename RGB_STORAGE, unsigned int optionFlags>
 void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts) {
     fillRefreshRowTemplated(hardwareY, refreshRow, brightnessShifts);
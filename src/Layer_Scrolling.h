@@ -44,6 +44,10 @@ class SMLayerScrolling : public SM_Layer {
         void frameRefreshCallback();
         void fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts = 0);
         void fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts = 0);
+        SM_RefreshSpan getRefreshRowSpan(uint16_t hardwareY);
+        bool isRefreshRowChanged(uint16_t hardwareY);
+        void fillRefreshSpan(uint16_t hardwareY, const SM_RefreshSpan & span, rgb48 refreshRow[], int brightnessShifts = 0);
+        void fillRefreshSpan(uint16_t hardwareY, const SM_RefreshSpan & span, rgb24 refreshRow[], int brightnessShifts = 0);
 
         void setRefreshRate(uint8_t newRefreshRate);
 
@@ -84,6 +88,8 @@ class SMLayerScrolling : public SM_Layer {
         int fontTopOffset = 1;
         int fontLeftOffset = 1;
         bool majorScrollFontChange = false;
+        // set for the frame when the text band moves or changes size, and rows outside the current band may have changed
+        bool allRowsChanged = true;
 
         bool ccEnabled = sizeof(RGB) <= 3 ? true : false;
         ScrollMode scrollmode = bounceForward;
@@ -54,9 +54,20 @@ void SMLayerScrolling<RGB, optionFlags>::begin(void) {
 
 template <typename RGB, unsigned int optionFlags>
 void SMLayerScrolling<RGB, optionFlags>::frameRefreshCallback(void) {
+    allRowsChanged = majorScrollFontChange;
     updateScrollingText();
 }
 
+// only rows with text change unless the band moved, see getRefreshRowSpan()
+template <typename RGB, unsigned int optionFlags>
+bool SMLayerScrolling<RGB, optionFlags>::isRefreshRowChanged(uint16_t hardwareY) {
+    if(allRowsChanged)
+        return true;
+
+    SM_RefreshSpan span = getRefreshRowSpan(hardwareY);
+    return (span.x0 < span.x1);
+}
+
 // returns true and copies color to xyPixel if pixel is opaque, returns false if not
 template<typename RGB, unsigned int optionFlags> template <typename RGB_OUT>
 bool SMLayerScrolling<RGB, optionFlags>::getPixel(uint16_t hardwareX, uint16_t hardwareY, RGB_OUT &xyPixel) {
@@ -131,8 +142,44 @@ bool SMLayerScrolling<RGB, optionFlags>::getPixel(uint16_t hardwareX, uint16_t h
     return false;
 }
 
+// text is only drawn in the band of local rows used by the font (see redrawScrollingText()), which after rotation is
+// either a band of hardware rows, or a band of hardware columns present in every row
 template <typename RGB, unsigned int optionFlags>
-void SMLayerScrolling<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts) {
+SM_RefreshSpan SMLayerScrolling<RGB, optionFlags>::getRefreshRowSpan(uint16_t hardwareY) {
+    SM_RefreshSpan span = {0, 0, false};
+
+    int bandMin = max(0, fontTopOffset);
+    int bandMax = min((int)this->localHeight, fontTopOffset + scrollFont->Height);
+
+    if(bandMin >= bandMax)
+        return span;
+
+    switch( this->layerRotation ) {
+      case rotation0 :
+        if(hardwareY >= bandMin && hardwareY < bandMax)
+            span.x1 = this->matrixWidth;
+        break;
+      case rotation180 :
+        if((this->matrixHeight - 1) - hardwareY >= bandMin && (this->matrixHeight - 1) - hardwareY < bandMax)
+            span.x1 = this->matrixWidth;
+        break;
+      case rotation90 :
+        span.x0 = this->matrixWidth - bandMax;
+        span.x1 = this->matrixWidth - bandMin;
+        break;
+      case rotation270 :
+        span.x0 = bandMin;
+        span.x1 = bandMax;
+        break;
+      default:
+        break;
+    };
+
+    return span;
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerScrolling<RGB, optionFlags>::fillRefreshSpan(uint16_t hardwareY, const SM_RefreshSpan & span, rgb48 refreshRow[], int brightnessShifts) {
     rgb48 currentPixel;
     int i;
 
@@ -141,7 +188,7 @@ void SMLayerScrolling<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb4
     else
         currentPixel = textcolor;
 
-    for(i=0; i<this->matrixWidth; i++) {
+    for(i=span.x0; i<span.x1; i++) {
         if(!getPixel(i, hardwareY))
             continue;
 
@@ -150,7 +197,7 @@ void SMLayerScrolling<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb4
 }
 
 template <typename RGB, unsigned int optionFlags>
-void SMLayerScrolling<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts) {
+void SMLayerScrolling<RGB, optionFlags>::fillRefreshSpan(uint16_t hardwareY, const SM_RefreshSpan & span, rgb24 refreshRow[], int brightnessShifts) {
     rgb24 currentPixel;
     int i;
 
@@ -159,7 +206,7 @@ void SMLayerScrolling<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb2
     else
         currentPixel = textcolor;
 
-    for(i=0; i<this->matrixWidth; i++) {
+    for(i=span.x0; i<span.x1; i++) {
         if(!getPixel(i, hardwareY))
             continue;
 
@@ -167,6 +214,16 @@ void SMLayerScrolling<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb2
     }
 }
 
+template <typename RGB, unsigned int optionFlags>
+void SMLayerScrolling<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts) {
+    fillRefreshSpan(hardwareY, getRefreshRowSpan(hardwareY), refreshRow, brightnessShifts);
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerScrolling<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts) {
+    fillRefreshSpan(hardwareY, getRefreshRowSpan(hardwareY), refreshRow, brightnessShifts);
+}
+
 template<typename RGB, unsigned int optionFlags>
 void SMLayerScrolling<RGB, optionFlags>::setColor(const RGB & newColor) {
     textcolor = newColor;
@@ -331,6 +388,7 @@ void SMLayerScrolling<RGB, optionFlags>::setSpeed(unsigned char pixels_per_secon
 template <typename RGB, unsigned int optionFlags>
 void SMLayerScrolling<RGB, optionFlags>::setFont(fontChoices newFont) {
     scrollFont = fontLookup(newFont);
+    majorScrollFontChange = true;
 }
 
 template <typename RGB, unsigned int optionFlags>
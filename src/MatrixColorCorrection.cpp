@@ -0,0 +1,151 @@
+/*
+ * SmartMatrix Library - Color Correction Table Generator
+ *
+ * Copyright (c) 2020 Louis Beaudoin (Pixelmatix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "MatrixCommon.h"
+
+// 2^(-2^-k) for k = 1-16, in 2.30 fixed point
+static const uint32_t negativeExp2Fractions[16] = {
+    759250125, 902905651, 984625594, 1028218693, 1050733751, 1062175491, 1067942999, 1070838486,
+    1072289173, 1073015252, 1073378477, 1073560135, 1073650976, 1073696399, 1073719111, 1073730468
+};
+
+// returns log2(x / 65536) in 16.16 fixed point, x must be in the range 1-65536, so the result is always <= 0
+static int32_t log2Fixed16(uint32_t x) {
+    int msb = 31;
+    while(!(x & (1UL << msb)))
+        msb--;
+
+    int32_t result = (int32_t)(msb - 16) << 16;
+
+    // normalize to 1.0-2.0 in 2.30 fixed point, then get each fractional bit by squaring
+    uint64_t m = (msb >= 30) ? (x >> (msb - 30)) : ((uint64_t)x << (30 - msb));
+    for(int k = 1; k <= 16; k++) {
+        m = (m * m) >> 30;
+        if(m >= (2ULL << 30)) {
+            m >>= 1;
+            result += 1L << (16 - k);
+        }
+    }
+    return result;
+}
+
+// returns 2^(-x) in 2.30 fixed point, x in 16.16 fixed point and >= 0
+static uint32_t negativeExp2Fixed16(uint32_t x) {
+    int integerPart = x >> 16;
+    if(integerPart >= 30)
+        return 0;
+
+    uint64_t result = 1UL << 30;
+    for(int k = 1; k <= 16; k++) {
+        if(x & (1UL << (16 - k)))
+            result = (result * negativeExp2Fractions[k - 1]) >> 30;
+    }
+    return (uint32_t)(result >> integerPart);
+}
+
+// integer only, so it's fast enough to run without an FPU: a 4096 entry table takes a few ms on Teensy 3, too slow for the refresh
+// interrupt, so this only runs from setBackgroundLUTCorrection() and brightness is applied separately
+void calculateColorCorrectionLUT(color_chan_t * lut, int size, uint16_t gamma, uint8_t channelScale) {
+    // 8-bit tables map 0-255 to 0.0-1.0, 12-bit tables are indexed with the top 12 bits of a 16-bit value, so 4096 would be 1.0
+    int divisor = (size > 256) ? size : (size - 1);
+
+    lut[0] = 0;
+
+    for(int i=1; i<size; i++) {
+        // x = i/divisor, y = x^gamma = 2^(gamma * log2(x))
+        uint32_t x = (((uint32_t)i << 16) + (divisor / 2)) / divisor;
+        int64_t exponent = -((int64_t)log2Fixed16(x) * gamma) >> 8;
+        uint32_t y = negativeExp2Fixed16((uint32_t)exponent);
+
+        // scale from 2.30 to 16 bits, rounding to nearest, then apply white point
+        uint32_t value = (uint32_t)(((uint64_t)y * 0xffff + (1UL << 29)) >> 30);
+        lut[i] = (value * channelScale) / 255;
+    }
+}
+
+static bool isSingleTableCorrection(const SM_ColorCorrection & correction) {
+    return correction.redScale == correction.greenScale && correction.redScale == correction.blueScale;
+}
+
+// the tables are allocated the first time they're needed and never freed or moved, as the refresh (on the other core on ESP32) may
+// still be reading them, and correctionEnabled is cleared while they're rewritten so the refresh uses the default tables meanwhile
+bool setBackgroundLUTCorrection(SM_BackgroundLUT * lut, const SM_ColorCorrection & correction) {
+    int numTables = isSingleTableCorrection(correction) ? 1 : 3;
+
+    lut->correctionEnabled = false;
+    __sync_synchronize();
+    lut->correctionChanged = true;
+
+    // room for all three channels, so a later correction with different channel scales doesn't need a larger buffer
+    if(!lut->correctedTables) {
+        lut->correctedTables = (color_chan_t *)malloc(sizeof(color_chan_t) * lut->size * 3);
+        if(!lut->correctedTables)
+            return false;
+    }
+
+    // separate tables with brightness applied are only needed when the channels are scaled differently
+    if(numTables > 1 && !lut->channelTables) {
+        lut->channelTables = (color_chan_t *)malloc(sizeof(color_chan_t) * lut->size * 3);
+        if(!lut->channelTables)
+            return false;
+    }
+
+    const uint8_t scales[3] = {correction.redScale, correction.greenScale, correction.blueScale};
+    for(int i=0; i<numTables; i++)
+        calculateColorCorrectionLUT(lut->correctedTables + (i * lut->size), lut->size, correction.gamma, scales[i]);
+
+    lut->correction = correction;
+
+    // the tables and correction have to be written before the refresh can see correctionEnabled
+    __sync_synchronize();
+    lut->correctionEnabled = true;
+    lut->correctionChanged = true;
+    return true;
+}
+
+void clearBackgroundLUTCorrection(SM_BackgroundLUT * lut) {
+    lut->correctionEnabled = false;
+    __sync_synchronize();
+    lut->correctionChanged = true;
+}
+
+// applies brightness the same way as calculate12BitBackgroundLUT(), so this is as fast as updating the default tables
+void calculateCorrectedBackgroundLUT(SM_BackgroundLUT * lut, uint8_t backgroundBrightness) {
+    if(isSingleTableCorrection(lut->correction)) {
+        for(int i=0; i<lut->size; i++)
+            lut->table[i] = (lut->correctedTables[i] * backgroundBrightness) / 256;
+
+        lut->channelLUT[0] = lut->channelLUT[1] = lut->channelLUT[2] = lut->table;
+    } else {
+        for(int channel=0; channel<3; channel++) {
+            const color_chan_t * corrected = lut->correctedTables + (channel * lut->size);
+            color_chan_t * table = lut->channelTables + (channel * lut->size);
+
+            for(int i=0; i<lut->size; i++)
+                table[i] = (corrected[i] * backgroundBrightness) / 256;
+
+            lut->channelLUT[channel] = table;
+        }
+    }
+}
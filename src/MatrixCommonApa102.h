@@ -39,4 +39,18 @@
 #define SM_APA102_OPTIONS_COLOR_ORDER_BRG      (0x5 << 2)
 #define SM_APA102_OPTIONS_COLOR_ORDER_MASK     (0x7 << 2)
 
+// Teensy 4: split the matrix into n (1 or 2) bands of rows, each a separate strip with its own clock and data pins, refreshed in
+// parallel.  Each strip needs its own FlexIO module with DMA (FlexIO1 or FlexIO2), so the second strip's pins must map to the
+// module SPIFLEX isn't using, and need to be set with setStripPins() before begin()
+#define SM_APA102_OPTIONS_PARALLEL_STRIPS(n)   ((((n) - 1) & 0x7) << 5)
+#define SM_APA102_OPTIONS_PARALLEL_STRIPS_MASK (0x7 << 5)
+
+#define APA102_NUM_STRIPS       (((optionFlags & SM_APA102_OPTIONS_PARALLEL_STRIPS_MASK) >> 5) + 1)
+#define APA102_ROWS_PER_STRIP   (matrixHeight / APA102_NUM_STRIPS)
+// each strip has its own start frame and end frame around the pixel data
+#define APA102_STRIP_BYTES      ((matrixWidth * APA102_ROWS_PER_STRIP * 4) + (4+4))
+
+// one frame is always kept for refreshing while the next is calculated, so at least two are needed
+#define APA102_NUM_FRAME_BUFFERS(bufferRows)    (((bufferRows) < 2) ? 2 : (bufferRows))
+
 #endif
\ No newline at end of file
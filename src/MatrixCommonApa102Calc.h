@@ -41,6 +41,7 @@ public:
     void setBrightness(uint8_t newBrightness);
     void setRefreshRate(uint8_t newRefreshRate);
     void setSpiClockSpeed(uint32_t newClockSpeed);
+    void setStripPins(uint8_t strip, uint8_t clkPin, uint8_t datPin);
 
     // get info
     uint16_t getScreenWidth(void) const;
@@ -51,6 +52,8 @@ public:
 
     // debug
     int countFPS(void);
+    uint32_t getCalcCyclesPerFrame(void);
+    uint32_t getMaxCalcCyclesPerRow(void);
 
     // functions called by ISR
     static void matrixCalculations(bool initial);
@@ -61,9 +64,12 @@ private:
 
     // functions for refreshing
     static void loadMatrixBuffers(frameDataStruct * currentRowDataPtr, unsigned char currentRow);
+    static void calculateGbcLUTs(void);
+    static void markAllRowsStale(void);
 
     // configuration
     static volatile bool rotationChange;
+    static volatile bool brightnessChange;
     static volatile bool dmaBufferUnderrun;
     static int dimmingFactor;
     static const int dimmingMaximum = 255;
@@ -73,6 +79,21 @@ private:
     static bool dmaBufferUnderrunSinceLastCheck;
     static bool refreshRateLowered;
     static bool refreshRateChanged;
+
+    // number of frame buffers that still have old data for each row, rows are only calculated when this is non-zero
+    static uint8_t numFrameBuffers;
+    static uint8_t rowStaleFrames[matrixHeight];
+
+    // GBC values and scale factors for the current brightness, see calculateGbcLUTs()
+    static uint8_t gbcGlobalBrightness;
+    static uint32_t gbcReciprocalLUT[32];
+    static uint8_t gbcSimpleHeaderLUT[17];
+    static uint8_t gbcSimpleShiftLUT[17];
+
+    // profiling
+    static uint32_t calcCyclesPerFrame;
+    static uint32_t calcCyclesCurrentFrame;
+    static uint32_t calcCyclesMaxRow;
 };
 
 #endif
@@ -47,8 +47,36 @@ bool SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, opti
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 bool SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::refreshRateChanged = true;
 
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::numFrameBuffers;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rowStaleFrames[matrixHeight];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::gbcGlobalBrightness;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::gbcReciprocalLUT[32];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::gbcSimpleHeaderLUT[17];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::gbcSimpleShiftLUT[17];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcCyclesPerFrame = 0;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcCyclesCurrentFrame = 0;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcCyclesMaxRow = 0;
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::SmartMatrixApaCalc(uint8_t bufferrows, frameDataStruct * frameDataBuffer) {
+    numFrameBuffers = APA102_NUM_FRAME_BUFFERS(bufferrows);
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -86,6 +114,20 @@ int SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optio
     return ret;
 }
 
+// returns the number of CPU cycles spent filling the refresh buffer with the last complete frame
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getCalcCyclesPerFrame(void) {
+    return calcCyclesPerFrame;
+}
+
+// returns the largest number of cycles spent calculating a single row since the last call
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getMaxCalcCyclesPerRow(void) {
+    uint32_t ret = calcCyclesMaxRow;
+    calcCyclesMaxRow = 0;
+    return ret;
+}
+
 #define MAX_MATRIXCALCULATIONS_LOOPS_WITHOUT_EXIT  5
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -93,6 +135,12 @@ void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, opti
     dmaBufferUnderrun = true;
 }
 
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::markAllRowsStale(void) {
+    for(int i = 0; i < matrixHeight; i++)
+        rowStaleFrames[i] = numFrameBuffers;
+}
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixCalculations(bool initial) {
     static unsigned char currentRow;
@@ -100,6 +148,55 @@ void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, opti
     // TODO: handle underrun, and too high refresh rate
     // only run the loop if there is free space, and fill the entire buffer before returning
     while (SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::isRowBufferFree()) {
+        // do once-per-frame updates
+        if (rotationChange) {
+            SM_Layer * templayer = SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
+            while(templayer) {
+                templayer->setRotation(rotation);
+                templayer = templayer->nextLayer;
+            }
+            rotationChange = false;
+            markAllRowsStale();
+        }
+
+        if (brightnessChange) {
+            calculateGbcLUTs();
+            brightnessChange = false;
+            markAllRowsStale();
+        }
+
+        SM_Layer * templayer = SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
+        while(templayer) {
+            if(refreshRateChanged) {
+                templayer->setRefreshRate(refreshRate);
+            }
+
+            bool layerChanged = templayer->isLayerChanged();
+
+            templayer->frameRefreshCallback();
+
+            // only the rows changed by the layer need to be recalculated, in every frame buffer
+            if(layerChanged) {
+                for(int y = 0; y < matrixHeight; y++) {
+                    if(templayer->isRefreshRowChanged(y))
+                        rowStaleFrames[y] = numFrameBuffers;
+                }
+            }
+
+            templayer = templayer->nextLayer;
+        }
+        refreshRateChanged = false;
+
+        // if every frame buffer is up to date there's no new frame to calculate, and refresh keeps sending the last one
+        bool refreshNeeded = false;
+        for(int y = 0; y < matrixHeight; y++) {
+            if(rowStaleFrames[y])
+                refreshNeeded = true;
+        }
+
+        if(!refreshNeeded)
+            return;
+
         currentRow = 0;
         frameDataStruct * currentRowDataPtr = SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getNextRowBufferPtr();
 
@@ -107,32 +204,18 @@ void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, opti
 #ifdef DEBUG_PINS_ENABLED
 //            digitalWriteFast(DEBUG_PIN_3, HIGH); // oscilloscope trigger
 #endif
-            // do once-per-frame updates
-            if (!currentRow) {
-                if (rotationChange) {
-                    SM_Layer * templayer = SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
-                    while(templayer) {
-                        templayer->setRotation(rotation);
-                        templayer = templayer->nextLayer;
-                    }
-                    rotationChange = false;
-                }
-
-                SM_Layer * templayer = SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
-                while(templayer) {
-                    if(refreshRateChanged) {
-                        templayer->setRefreshRate(refreshRate);
-                    }
-                    templayer->frameRefreshCallback();
-                    templayer = templayer->nextLayer;
-                }
-                refreshRateChanged = false;
-            }
+            // the frame buffers are written in order, so a row only needs to be written if it changed in the last numFrameBuffers frames
+            if(rowStaleFrames[currentRow]) {
+                rowStaleFrames[currentRow]--;
 
-            // do once-per-line updates
-            // none right now
+                uint32_t rowStartCycles = SM_GET_CPU_CYCLE_COUNT();
+                SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers(currentRowDataPtr, currentRow);
+                uint32_t rowCycles = SM_GET_CPU_CYCLE_COUNT() - rowStartCycles;
 
-            SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers(currentRowDataPtr, currentRow);
+                if(rowCycles > calcCyclesMaxRow)
+                    calcCyclesMaxRow = rowCycles;
+                calcCyclesCurrentFrame += rowCycles;
+            }
 
 #ifdef DEBUG_PINS_ENABLED
 //    digitalWriteFast(DEBUG_PIN_3, LOW);
@@ -141,6 +224,8 @@ void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, opti
             // enqueue row
             if (++currentRow >= matrixHeight) {
                 currentRow = 0;
+                calcCyclesPerFrame = calcCyclesCurrentFrame;
+                calcCyclesCurrentFrame = 0;
                 SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::writeRowBuffer(currentRow);
             }
 
@@ -175,11 +260,14 @@ uint16_t SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType,
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 volatile bool SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rotationChange = true;
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+volatile bool SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::brightnessChange = true;
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 rotationDegrees SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rotation = rotation0;
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setBrightness(uint8_t newBrightness) {
     dimmingFactor = dimmingMaximum - newBrightness;
+    brightnessChange = true;
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -198,6 +286,12 @@ void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, opti
     SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setSpiClockSpeed(spiClockSpeed);
 }
 
+// only used with SM_APA102_OPTIONS_PARALLEL_STRIPS, must be called before begin()
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setStripPins(uint8_t strip, uint8_t clkPin, uint8_t datPin) {
+    SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setStripPins(strip, clkPin, datPin);
+}
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 uint8_t SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getRefreshRate(void) {
     return refreshRate;
@@ -230,6 +324,12 @@ void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, opti
         templayer = templayer->nextLayer;
     }
 
+#if defined(KINETISK)
+    // enable the DWT cycle counter used for profiling the calculations, in case it's not enabled already
+    ARM_DEMCR |= ARM_DEMCR_TRCENA;
+    ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+#endif
+
     SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setMatrixCalculationsCallback(matrixCalculations);
     SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setMatrixUnderrunCallback(dmaBufferUnderrunCallback);
     SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::begin();
@@ -239,6 +339,59 @@ void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, opti
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 int SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dimmingFactor = 0;
 
+// Everything in the per-pixel calculations that only depends on the brightness is calculated here once per brightness change, so
+// loadMatrixBuffers() doesn't need to divide or loop.  Divides by a value that's known to be small are replaced by a multiply by a
+// 32-bit reciprocal keeping the top 32 bits of the 64-bit product: the reciprocals are rounded up, and with numerators under 2^16 and
+// denominators under 2^16 the error is too small to change the result, so the output is identical to dividing
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calculateGbcLUTs(void) {
+    int brightness = dimmingMaximum - dimmingFactor;
+
+    // "DEFAULT": gbcReciprocalLUT[value] is (globalbrightness / (value + 1)) >> 8, as a reciprocal
+    if((optionFlags & SM_APA102_OPTIONS_GBC_MODE_MASK) == SM_APA102_OPTIONS_GBC_MODE_DEFAULT) {
+        gbcGlobalBrightness = (0x1F * brightness) / dimmingMaximum;
+
+        for(int value = 0; value < 32; value++)
+            gbcReciprocalLUT[value] = (((uint64_t)gbcGlobalBrightness << 24) + value) / (value + 1);
+    }
+
+    // "SIMPLE": the GBC bits and the shift for each number of leading zeros in the color (16 for black), same as shifting in a loop
+    // until the highest bit of the color is set, or until globalbrightness == 1
+    if((optionFlags & SM_APA102_OPTIONS_GBC_MODE_MASK) == SM_APA102_OPTIONS_GBC_MODE_SIMPLE) {
+        uint8_t globalbrightness = (0x20UL * brightness) / dimmingMaximum;
+
+        if(globalbrightness == 0x20)
+            globalbrightness = 0x1f;
+
+        for(int leadingZeros = 0; leadingZeros <= 16; leadingZeros++) {
+            uint8_t gbc = globalbrightness;
+            uint8_t localshift = 0;
+
+            while(localshift < leadingZeros && gbc > 1) {
+                gbc >>= 1;
+                localshift++;
+            }
+
+            gbcSimpleHeaderLUT[leadingZeros] = 0xE0 | gbc;
+            // shift needs to put 16-bit color value into lowest byte, which will be sent over SPI
+            gbcSimpleShiftLUT[leadingZeros] = 8 - localshift;
+        }
+    }
+
+    if((optionFlags & SM_APA102_OPTIONS_GBC_MODE_MASK) == SM_APA102_OPTIONS_GBC_MODE_BRIGHTONLY) {
+        gbcGlobalBrightness = (0x20UL * brightness) / dimmingMaximum;
+
+        if(gbcGlobalBrightness == 0x20)
+            gbcGlobalBrightness = 0x1f;
+    }
+
+    // "NONE": gbcReciprocalLUT[0] is (brightness / dimmingMaximum) >> 8, as a reciprocal
+    if((optionFlags & SM_APA102_OPTIONS_GBC_MODE_MASK) == SM_APA102_OPTIONS_GBC_MODE_NONE) {
+        uint32_t divisor = dimmingMaximum * 256;
+        gbcReciprocalLUT[0] = (((uint64_t)brightness << 32) + divisor - 1) / divisor;
+    }
+}
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 INLINE void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers(frameDataStruct * currentRowDataPtr, unsigned char currentRow) {
     int i,j;
@@ -246,138 +399,126 @@ INLINE void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelTyp
     // static to avoid putting large buffer on the stack
     static rgb48 tempRow0[matrixWidth];
 
-    // clear buffer to prevent garbage data showing through transparent layers
-    memset(tempRow0, 0x00, sizeof(tempRow0));
+    // get pixel data from layers, the buffer is only cleared if no opaque layer covers the row
+    SM_Layer::fillRefreshRowFromLayers(SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer, currentRow, &tempRow0[0], matrixWidth);
 
-    // get pixel data from layers
-    SM_Layer * templayer = SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
-    while(templayer) {
-        templayer->fillRefreshRow(currentRow, &tempRow0[0]);
-        templayer = templayer->nextLayer;        
-    }
+    // each strip is sent separately, starting with its own first row
+    uint8_t * stripData = &currentRowDataPtr->data[(currentRow / APA102_ROWS_PER_STRIP) * APA102_STRIP_BYTES];
+    int stripRow = currentRow % APA102_ROWS_PER_STRIP;
 
-    if(!currentRow) {
+    if(!stripRow) {
         // fill start and end frame markers
         for(i=0; i<4; i++) {
-            currentRowDataPtr->data[i] = 0;
-            currentRowDataPtr->data[4 + (matrixWidth * matrixHeight * 4) + i] = 0xFF;
+            stripData[i] = 0;
+            stripData[4 + (matrixWidth * APA102_ROWS_PER_STRIP * 4) + i] = 0xFF;
         }
     }
 
-    for (j = 0; j < matrixWidth; j++) {
-        // we send data out in serpentine layout only
-        if(currentRow % 2)
-            i=(matrixWidth-j-1);
-        else
-            i=j;
-
-        uint16_t tempPixel1, tempPixel2, tempPixel3;
-
-        switch(optionFlags & SM_APA102_OPTIONS_COLOR_ORDER_MASK) {
-            case SM_APA102_OPTIONS_COLOR_ORDER_RGB:
-                tempPixel1 = tempRow0[j].red;
-                tempPixel2 = tempRow0[j].green;
-                tempPixel3 = tempRow0[j].blue;
-                break;
-            case SM_APA102_OPTIONS_COLOR_ORDER_RBG:
-                tempPixel1 = tempRow0[j].red;
-                tempPixel2 = tempRow0[j].blue;
-                tempPixel3 = tempRow0[j].green;
-                break;
-                
-            case SM_APA102_OPTIONS_COLOR_ORDER_GRB:
-                tempPixel1 = tempRow0[j].green;
-                tempPixel2 = tempRow0[j].red;
-                tempPixel3 = tempRow0[j].blue;
-                break;
-                
-            case SM_APA102_OPTIONS_COLOR_ORDER_GBR:
-                tempPixel1 = tempRow0[j].green;
-                tempPixel2 = tempRow0[j].blue;
-                tempPixel3 = tempRow0[j].red;
-                break;
-                
-            case SM_APA102_OPTIONS_COLOR_ORDER_BGR:
-                tempPixel1 = tempRow0[j].blue;
-                tempPixel2 = tempRow0[j].green;
-                tempPixel3 = tempRow0[j].red;
-                break;
-                
-            case SM_APA102_OPTIONS_COLOR_ORDER_BRG:
-                tempPixel1 = tempRow0[j].blue;
-                tempPixel2 = tempRow0[j].red;
-                tempPixel3 = tempRow0[j].green;
-                break;
-        }
+    // the color order is set by optionFlags, so this is resolved at compile time
+    uint16_t rgb48::* channel1;
+    uint16_t rgb48::* channel2;
+    uint16_t rgb48::* channel3;
+
+    switch(optionFlags & SM_APA102_OPTIONS_COLOR_ORDER_MASK) {
+        case SM_APA102_OPTIONS_COLOR_ORDER_RGB:
+            channel1 = &rgb48::red;
+            channel2 = &rgb48::green;
+            channel3 = &rgb48::blue;
+            break;
+
+        case SM_APA102_OPTIONS_COLOR_ORDER_RBG:
+            channel1 = &rgb48::red;
+            channel2 = &rgb48::blue;
+            channel3 = &rgb48::green;
+            break;
+
+        case SM_APA102_OPTIONS_COLOR_ORDER_GRB:
+            channel1 = &rgb48::green;
+            channel2 = &rgb48::red;
+            channel3 = &rgb48::blue;
+            break;
+
+        case SM_APA102_OPTIONS_COLOR_ORDER_GBR:
+            channel1 = &rgb48::green;
+            channel2 = &rgb48::blue;
+            channel3 = &rgb48::red;
+            break;
+
+        case SM_APA102_OPTIONS_COLOR_ORDER_BRG:
+            channel1 = &rgb48::blue;
+            channel2 = &rgb48::red;
+            channel3 = &rgb48::green;
+            break;
+
+        case SM_APA102_OPTIONS_COLOR_ORDER_BGR:
+        default:
+            channel1 = &rgb48::blue;
+            channel2 = &rgb48::green;
+            channel3 = &rgb48::red;
+            break;
+    }
+
+    // we send data out in serpentine layout only
+    uint8_t * pixelData = &stripData[4 + (stripRow * matrixWidth * 4)];
+    int pixelStep = 4;
+    if(stripRow % 2) {
+        pixelData += (matrixWidth - 1) * 4;
+        pixelStep = -4;
+    }
+
+    for (j = 0; j < matrixWidth; j++, pixelData += pixelStep) {
+        uint16_t tempPixel1 = tempRow0[j].*channel1;
+        uint16_t tempPixel2 = tempRow0[j].*channel2;
+        uint16_t tempPixel3 = tempRow0[j].*channel3;
 
         // "DEFAULT" mode attempts to get 13-bit color per channel using the full range of GBC bits, this looks better than "SIMPLE" mode, but takes longer, and there are still non-linearity issues
         if((optionFlags & SM_APA102_OPTIONS_GBC_MODE_MASK) == SM_APA102_OPTIONS_GBC_MODE_DEFAULT) {
-            uint8_t globalbrightness = (0x1F * (dimmingMaximum - dimmingFactor)) / dimmingMaximum;
-
             uint16_t maxrgb = max(max(tempPixel1, tempPixel2), tempPixel3);
 
-            uint16_t value  = (maxrgb * 31 * globalbrightness) / 0x10000 / 31;
+            // value is 0-30, the GBC bits are value+1, and each channel is scaled by globalbrightness / (value + 1)
+            uint8_t value = ((uint32_t)maxrgb * gbcGlobalBrightness) >> 16;
+            uint32_t reciprocal = gbcReciprocalLUT[value];
 
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 0] = 0xE0 | (value+1);
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 1] = ((tempPixel1 * globalbrightness) / (value + 1)) >> 8;
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 2] = ((tempPixel2 * globalbrightness) / (value + 1)) >> 8;
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 3] = ((tempPixel3 * globalbrightness) / (value + 1)) >> 8;
+            pixelData[0] = 0xE0 | (value+1);
+            pixelData[1] = ((uint64_t)tempPixel1 * reciprocal) >> 32;
+            pixelData[2] = ((uint64_t)tempPixel2 * reciprocal) >> 32;
+            pixelData[3] = ((uint64_t)tempPixel3 * reciprocal) >> 32;
         }
 
         // "SIMPLE" mode attempts to get 13-bit color per channel by first applying the setBrightness() value to the GBC bits, then dividing by two to attempt to get more bits for dimmer colors, this is not as good as "DEFAULT" mode, but is more efficient
         if((optionFlags & SM_APA102_OPTIONS_GBC_MODE_MASK) == SM_APA102_OPTIONS_GBC_MODE_SIMPLE) {
-            uint8_t globalbrightness = (0x20UL * (dimmingMaximum - dimmingFactor)) / dimmingMaximum;
-            uint8_t localshift = 0;
-
-            if(globalbrightness == 0x20)
-                globalbrightness = 0x1f;
-
-            uint16_t value = tempPixel1 | tempPixel2 | tempPixel3;
-
-            // shift until the highest bit of value is set, or until globalbrightness == 1)
-            while(!((value << localshift) & 0x8000) && (globalbrightness > 1)) {
-                globalbrightness >>= 1;
-                localshift++;
-            }
-
-            // shift needs to put 16-bit color value into lowest byte, which will be sent over SPI
-            localshift = 8 - localshift;
+            // count leading zeros in the 16-bit color, setting bit 15 of the lower half gives 16 for black
+            int leadingZeros = __builtin_clz(((uint32_t)(tempPixel1 | tempPixel2 | tempPixel3) << 16) | 0x8000);
+            uint8_t localshift = gbcSimpleShiftLUT[leadingZeros];
 
             // global brightness
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 0] = 0xE0 | globalbrightness;
+            pixelData[0] = gbcSimpleHeaderLUT[leadingZeros];
 
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 1] = tempPixel1 >> localshift;
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 2] = tempPixel2 >> localshift;
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 3] = tempPixel3 >> localshift;
+            pixelData[1] = tempPixel1 >> localshift;
+            pixelData[2] = tempPixel2 >> localshift;
+            pixelData[3] = tempPixel3 >> localshift;
         }
 
         // "BRIGHTONLY" applies the setBrightness() value to the GBC bits, so the same GBC is used across all LEDs
         if((optionFlags & SM_APA102_OPTIONS_GBC_MODE_MASK) == SM_APA102_OPTIONS_GBC_MODE_BRIGHTONLY) {
-            uint8_t globalbrightness = (0x20UL * (dimmingMaximum - dimmingFactor)) / dimmingMaximum;
-
-            if(globalbrightness == 0x20)
-                globalbrightness = 0x1f;
-
             // global brightness
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 0] = 0xE0 | globalbrightness;
+            pixelData[0] = 0xE0 | gbcGlobalBrightness;
 
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 1] = tempPixel1 >> 8;
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 2] = tempPixel2 >> 8;
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 3] = tempPixel3 >> 8;
+            pixelData[1] = tempPixel1 >> 8;
+            pixelData[2] = tempPixel2 >> 8;
+            pixelData[3] = tempPixel3 >> 8;
         }
 
         // "NONE" mode doesn't use GBC at all, the LED output is 24-bit color
         if((optionFlags & SM_APA102_OPTIONS_GBC_MODE_MASK) == SM_APA102_OPTIONS_GBC_MODE_NONE) {
-            // global brightness
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 0] = 0xFF;
+            uint32_t reciprocal = gbcReciprocalLUT[0];
 
-            tempPixel3 = (tempPixel3 * (dimmingMaximum - dimmingFactor)) / dimmingMaximum;
-            tempPixel2 = (tempPixel2 * (dimmingMaximum - dimmingFactor)) / dimmingMaximum;
-            tempPixel1 = (tempPixel1 * (dimmingMaximum - dimmingFactor)) / dimmingMaximum;
+            // global brightness
+            pixelData[0] = 0xFF;
 
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 1] = tempPixel1 >> 8;
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 2] = tempPixel2 >> 8;
-            currentRowDataPtr->data[4 + ((currentRow * matrixWidth + i) * 4) + 3] = tempPixel3 >> 8;
+            pixelData[1] = ((uint64_t)tempPixel1 * reciprocal) >> 32;
+            pixelData[2] = ((uint64_t)tempPixel2 * reciprocal) >> 32;
+            pixelData[3] = ((uint64_t)tempPixel3 * reciprocal) >> 32;
         }
     }
 }
@@ -24,13 +24,21 @@
 #ifndef SmartMatrixAPA102Refresh_h
 #define SmartMatrixAPA102Refresh_h
 
+#if defined(__IMXRT1062__)
+class FlexIOSPI;
+class EventResponder;
+#endif
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 class SmartMatrixAPA102Refresh {
 public:
+    // the data for each strip is stored one after the other, see APA102_STRIP_BYTES
     struct frameDataStruct {
-        uint8_t data[((matrixWidth*matrixHeight) * 4) + (4+4)];
+        uint8_t data[APA102_NUM_STRIPS * APA102_STRIP_BYTES];
     };
 
+    static_assert(matrixHeight % APA102_NUM_STRIPS == 0, "matrixHeight must be a multiple of the number of SM_APA102_OPTIONS_PARALLEL_STRIPS");
+
     typedef void (*matrix_underrun_callback)(void);
     typedef void (*matrix_calc_callback)(bool initial);
 
@@ -47,6 +55,7 @@ public:
     static bool isRowBufferFree(void);
     static void setRefreshRate(uint8_t newRefreshRate);
     static void setSpiClockSpeed(uint32_t newClockSpeed);
+    static void setStripPins(uint8_t strip, uint8_t clkPin, uint8_t datPin);
     static void setMatrixCalculationsCallback(matrix_calc_callback f);
     static void setMatrixUnderrunCallback(matrix_underrun_callback f);
 
@@ -69,7 +78,16 @@ private:
     static matrix_calc_callback matrixCalcCallback;
     static matrix_underrun_callback matrixUnderrunCallback;
 
-    static CircularBuffer_SM dmaBuffer;
+    // the frame at the front of the ring is refreshing, and is only released once a newer frame is ready
+    static SpscRing_SM dmaBuffer;
+    static volatile uint8_t stripsShifting;
+
+#if defined(__IMXRT1062__)
+    static uint8_t stripClkPins[APA102_NUM_STRIPS];
+    static uint8_t stripDatPins[APA102_NUM_STRIPS];
+    static FlexIOSPI * stripSpi[APA102_NUM_STRIPS];
+    static EventResponder * stripShiftCompleteEvents[APA102_NUM_STRIPS];
+#endif
 };
 
 #endif
@@ -24,6 +24,8 @@
 #ifndef SmartMatrixCommonHUB75_h
 #define SmartMatrixCommonHUB75_h
 
+#include <stdint.h>
+
 #define DEFAULT_PANEL_WIDTH_FOR_LINEAR_PANELS       32
 #define HUB75_RGB_COLOR_CHANNELS_IN_PARALLEL        2
 
@@ -128,6 +130,8 @@
 #define PHYSICAL_ROWS_PER_REFRESH_ROW (MATRIX_PANEL_HEIGHT / MATRIX_SCAN_MOD / HUB75_RGB_COLOR_CHANNELS_IN_PARALLEL)
 #define ROW_PAIR_OFFSET (CONVERT_PANELTYPE_TO_MATRIXROWPAIROFFSET(panelType))
 #define MULTI_ROW_REFRESH_REQUIRED (PHYSICAL_ROWS_PER_REFRESH_ROW > 1)
+// pixels in the temporary row buffers are stored out of order in the refresh buffer, need to use the refresh buffer map
+#define REFRESH_BUFFER_MAP_REQUIRED (MULTI_ROW_REFRESH_REQUIRED || (optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING))
 
 #define PIXELS_PER_LATCH    ((matrixWidth * matrixHeight) / MATRIX_PANEL_HEIGHT * PHYSICAL_ROWS_PER_REFRESH_ROW)
 
@@ -140,6 +144,9 @@
 #define SM_HUB75_OPTIONS_ESP32_CALC_TASK_CORE_1     (1 << 5)
 #define SM_HUB75_OPTIONS_FM6126A_RESET_AT_START     (1 << 6)
 #define SM_HUB75_OPTIONS_T4_CLK_PIN_ALT             (1 << 7)
+#define SM_HUB75_OPTIONS_ESP32_DUAL_CORE_CALC       (1 << 8)
+#define SM_HUB75_OPTIONS_TEMPORAL_DITHER            (1 << 9)    // Teensy 3/4: add an ordered dither that changes every frame before truncating to refreshDepth, see hub75DitherThreshold()
+#define SM_HUB75_OPTIONS_T3_HARDWARE_CLK            (1 << 10)   // Teensy 3.5/3.6: generate CLK with FTM3 instead of DMA, halving the refresh buffer size
 
 // old naming convention kept for compatibility
 #define SMARTMATRIX_OPTIONS_NONE                    SM_HUB75_OPTIONS_NONE                   
@@ -151,7 +158,33 @@
 #define SMARTMATRIX_OPTIONS_ESP32_CALC_TASK_CORE_1  SM_HUB75_OPTIONS_ESP32_CALC_TASK_CORE_1 
 #define SMARTMATRIX_OPTIONS_FM6126A_RESET_AT_START  SM_HUB75_OPTIONS_FM6126A_RESET_AT_START 
 #define SMARTMATRIX_OPTIONS_T4_CLK_PIN_ALT          SM_HUB75_OPTIONS_T4_CLK_PIN_ALT         
+#define SMARTMATRIX_OPTIONS_ESP32_DUAL_CORE_CALC    SM_HUB75_OPTIONS_ESP32_DUAL_CORE_CALC   
+#define SMARTMATRIX_OPTIONS_TEMPORAL_DITHER         SM_HUB75_OPTIONS_TEMPORAL_DITHER        
+#define SMARTMATRIX_OPTIONS_T3_HARDWARE_CLK         SM_HUB75_OPTIONS_T3_HARDWARE_CLK        
+
+// 4x4 Bayer matrix, neighboring pixels get thresholds far apart so the dither pattern has no visible low frequency structure
+static const uint8_t hub75DitherMatrix[4][4] = {
+    { 0,  8,  2, 10},
+    {12,  4, 14,  6},
+    { 3, 11,  1,  9},
+    {15,  7, 13,  5}
+};
+
+// Returns a value to add to each color channel of pixel (x,y) before keeping only the top bits, with truncatedBits being the number
+// of low bits dropped.  The pattern is shifted by one step each frame so every pixel goes through all 16 thresholds every 16 frames,
+// and the average over those frames of the truncated value is close to the full value.  This gives the effect of error diffusion
+// over time without needing to store the error for each pixel.
+static inline uint16_t hub75DitherThreshold(int x, int y, uint8_t frame, uint8_t truncatedBits) {
+    uint32_t step = (hub75DitherMatrix[y & 0x03][x & 0x03] + frame) & 0x0f;
+    // center each step in its 1/16 of the range: (step + 0.5) / 16 of the truncated LSB
+    return (((step << 1) + 1) << truncatedBits) >> 5;
+}
 
+// adds the threshold to a 16-bit color channel without overflowing, full brightness stays at full brightness
+static inline uint16_t hub75DitherChannel(uint16_t value, uint16_t threshold) {
+    uint32_t sum = (uint32_t)value + threshold;
+    return (sum > 0xffff) ? 0xffff : sum;
+}
 
 // defines data bit order from bit 0-7, four times to fit in uint32_t
 #define PACKED_HUB75_WORD_ORDER p0r1:1, p0g1:1, p0b1:1, p0r2:1, p0g2:1, p0b2:1, p1r1:1, p1g1:1, \
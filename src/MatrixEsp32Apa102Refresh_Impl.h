@@ -33,10 +33,10 @@ template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char pan
 void apaRowCalculationISR(void);
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-CircularBuffer_SM SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer;
+SpscRing_SM SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer;
 
-// dmaBufferNumRows = the size of the buffer that DMA pulls from to refresh the display
-// must be minimum 2 rows so one can be updated while the other is refreshed
+// dmaBufferNumRows = the number of frames in the buffer that DMA pulls from to refresh the display
+// minimum 2 frames (see APA102_NUM_FRAME_BUFFERS) so one can be updated while the other is refreshed
 // increase beyond two to give more time for the update routine to complete
 // (increase this number if non-DMA interrupts are causing display problems)
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -54,16 +54,20 @@ uint16_t SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panel
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 typename SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::frameDataStruct * SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateFrame;
 
+// set while a frame is shifting out, cleared by apaRowCalculationISR()
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+volatile uint8_t SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripsShifting;
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::SmartMatrixAPA102Refresh(uint8_t bufferrows, frameDataStruct * frameDataBuffer) {
-    dmaBufferNumRows = bufferrows;
+    dmaBufferNumRows = APA102_NUM_FRAME_BUFFERS(bufferrows);
 
     matrixUpdateFrame = frameDataBuffer;
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 bool SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::isRowBufferFree(void) {
-    if(cbIsFull(&dmaBuffer))
+    if(dmaBuffer.isFull())
         return false;
     else
         return true;
@@ -71,12 +75,12 @@ bool SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 typename SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::frameDataStruct * SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getNextRowBufferPtr(void) {
-    return &(matrixUpdateFrame[cbGetNextWrite(&dmaBuffer)]);
+    return &(matrixUpdateFrame[dmaBuffer.getNextWrite()]);
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::writeRowBuffer(uint8_t currentRow) {
-    cbWrite(&dmaBuffer);
+    dmaBuffer.write();
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -126,7 +130,9 @@ void SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::begin(void) {
-    cbInit(&dmaBuffer, dmaBufferNumRows);
+    static_assert(APA102_NUM_STRIPS == 1, "SM_APA102_OPTIONS_PARALLEL_STRIPS is only supported on Teensy 4");
+
+    dmaBuffer.init(dmaBufferNumRows);
 
     // setup debug output
 #ifdef DEBUG_PINS_ENABLED
@@ -167,9 +173,9 @@ void apaRowCalculationISR(void) {
     gpio_set_level(DEBUG_2_GPIO, 1);
 #endif
 
-    // done with previous row, mark it as read
-    cbRead(&SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer);
+    SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripsShifting = 0;
 
+    // the frame that was just sent stays in the buffer until apaRowShiftCompleteISR() has a newer frame to send
     SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixCalcCallback(false);
 
 #ifdef DEBUG_PINS_ENABLED
@@ -184,18 +190,26 @@ void apaRowShiftCompleteISR(void) {
 #ifdef DEBUG_PINS_ENABLED
     gpio_set_level(DEBUG_1_GPIO, 1);
 #endif
-    int currentRow = cbGetNextRead(&SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer);
+    // the last frame is still shifting out, skip this refresh instead of restarting the transfer
+    // until the calc has written its first frame, the buffer at getNextRead() is the one being calculated, so there's nothing to send
+    if(SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripsShifting || !SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.getNumElements()) {
+#ifdef DEBUG_PINS_ENABLED
+        gpio_set_level(DEBUG_1_GPIO, 0);
+#endif
+        return;
+    }
+
+    // release the frame that was refreshed last if there's a newer frame, otherwise refresh the same frame again
+    if(SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.getNumElements() > 1)
+        SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.read();
 
-    // TODO: if underrun
-        // set flag so other ISR can enable DMA again when data is ready
-        //SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBufferUnderrun = true;
-    // else, start SPI
+    int currentRow = SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.getNextRead();
 
     // SPIFLEX.transfer calls arm_dcache_flush() which can take 10s of microseconds to complete - this is why this ISR has low priority
     // TODO: modify FlexIOSPI to allow for calling arm_dcache_flush() from less time sensitive location
 #if 0
     SPIFLEX.transfer(SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateFrame[currentRow].data,
-        NULL, ((matrixWidth * matrixHeight)*4) + (4+4), apa102ShiftCompleteEvent);
+        NULL, APA102_STRIP_BYTES, apa102ShiftCompleteEvent);
 #endif
 
 #ifdef DEBUG_PINS_ENABLED
@@ -24,6 +24,10 @@
 #ifndef SmartMatrixHUB75Calc_h
 #define SmartMatrixHUB75Calc_h
 
+// with SM_HUB75_OPTIONS_ESP32_DUAL_CORE_CALC the refresh rows are split between calcTask and a worker task on the other core
+#define ESP32_MAX_CALC_TASKS    2
+#define ESP32_NUM_CALC_TASKS    ((optionFlags & SM_HUB75_OPTIONS_ESP32_DUAL_CORE_CALC) ? 2 : 1)
+
 extern SemaphoreHandle_t calcTaskSemaphore;
 extern void matrixCalculationsSignal(void);
 
@@ -54,6 +58,9 @@ public:
 
     // debug
     int countFPS(void);
+    uint32_t getCalcCyclesPerFrame(void);
+    uint32_t getCalcElapsedCyclesPerFrame(void);
+    uint32_t getMaxCalcCyclesPerRow(void);
 
     // functions called by ISR
     static void matrixCalculations(void);
@@ -62,16 +69,22 @@ public:
     static uint8_t getCalcRefreshRateDivider(void);
 
 private:
+    // compares the frame buffer built with calculateControlBitTemplates() with the old per-pixel code, see extras/host/ControlBitTest_Esp32.cpp
+    friend struct SmartMatrixControlBitTest;
+
     static SM_Layer * baseLayer;
 
-    static void * tempRow0Ptr;
-    static void * tempRow1Ptr;
+    // each calc task needs its own temporary rows
+    static void * tempRow0Ptr[ESP32_MAX_CALC_TASKS];
+    static void * tempRow1Ptr[ESP32_MAX_CALC_TASKS];
 
     // functions for refreshing
     static void loadMatrixBuffers(int lsbMsbTransitionBit, int numBrightnessShifts = 0);
-    static void loadMatrixBuffers48(frameStruct * currentFrameDataPtr, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts = 0);
-    static void loadMatrixBuffers24(frameStruct * currentFrameDataPtr, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts = 0);
+    static void loadMatrixBufferRows(int calcTaskIndex);
+    static void loadMatrixBuffers48(frameStruct * currentFrameDataPtr, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts = 0, int calcTaskIndex = 0);
+    static void loadMatrixBuffers24(frameStruct * currentFrameDataPtr, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts = 0, int calcTaskIndex = 0);
     static void calcTask(void* pvParameters);
+    static void calcWorkerTask(void* pvParameters);
     static void resetMultiRowRefreshMapPosition(void);
     static void resetMultiRowRefreshMapPositionPixelGroupToStartOfRow(void);
     static void advanceMultiRowRefreshMapToNextRow(void);
@@ -79,6 +92,10 @@ private:
     static int getMultiRowRefreshRowOffset(void);
     static int getMultiRowRefreshNumPixelsToMap(void);
     static int getMultiRowRefreshPixelGroupOffset(void);
+    static void calculateRefreshBufferMap(void);
+    static void calculatePanelStackRowLUT(void);
+    static void markAllRefreshRowsChanged(void);
+    static void calculateControlBitTemplates(void);
     
     // configuration
     static volatile bool brightnessChange;
@@ -95,11 +112,42 @@ private:
     static bool refreshRateChanged;
     static uint8_t lsbMsbTransitionBit;
     static TaskHandle_t calcTaskHandle;
+    static TaskHandle_t calcWorkerTaskHandle;
+    static SemaphoreHandle_t calcWorkerStartSemaphore;
+    static SemaphoreHandle_t calcWorkerDoneSemaphore;
+
+    // the frame being calculated, shared with the worker task: rows are chosen by calcTask before the worker starts
+    static frameStruct * calcFrameBufferPtr;
+    static uint8_t calcRows[MATRIX_SCAN_MOD];
+    static int calcNumRows;
+    static int calcLsbMsbTransitionBit;
+    static int calcBrightnessShifts;
+
+    // profiling
+    static uint32_t calcCyclesPerFrame;
+    static uint32_t calcCyclesElapsedPerFrame;
+    static uint32_t calcCyclesMaxRow;
+    static uint32_t calcTaskCycles[ESP32_MAX_CALC_TASKS];
+    static uint32_t calcTaskCyclesMaxRow[ESP32_MAX_CALC_TASKS];
     
     static int multiRowRefresh_mapIndex_CurrentRowGroups;
     static int multiRowRefresh_mapIndex_CurrentPixelGroup;
     static int multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped;
     static int multiRowRefresh_NumPanelsAlreadyMapped;
+
+    // position in the refresh buffer for each pixel in the temporary row buffers, and row offset for each temporary row
+    static uint16_t refreshBufferMap[REFRESH_BUFFER_MAP_REQUIRED ? PIXELS_PER_LATCH : 1];
+    static int refreshBufferMapRowOffsets[PHYSICAL_ROWS_PER_REFRESH_ROW];
+
+    // rows to load from the layers for each stack of panels, for each refresh row and each temporary row
+    static PanelStackRows panelStackRowLUT[MATRIX_SCAN_MOD][PHYSICAL_ROWS_PER_REFRESH_ROW][MATRIX_STACK_HEIGHT];
+
+    // refresh row containing each hardware row, and the number of frame buffers each refresh row still needs to be recalculated in
+    static uint8_t hardwareRowToRefreshRow[matrixHeight];
+    static uint8_t refreshRowStaleFrames[MATRIX_SCAN_MOD];
+
+    // OE and LAT bits for each position in each bitplane, only changing with brightness and lsbMsbTransitionBit
+    static MATRIX_DATA_STORAGE_TYPE controlBitTemplates[COLOR_DEPTH_BITS][PIXELS_PER_LATCH];
 };
 
 #endif
@@ -40,10 +40,10 @@ template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char pan
 SM_Layer * SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-void * SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::tempRow0Ptr;
+void * SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::tempRow0Ptr[ESP32_MAX_CALC_TASKS];
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-void * SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::tempRow1Ptr;
+void * SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::tempRow1Ptr[ESP32_MAX_CALC_TASKS];
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 volatile bool SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBufferUnderrun = false;
@@ -61,6 +61,36 @@ bool SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 uint8_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::lsbMsbTransitionBit;
 
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcCyclesPerFrame = 0;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcCyclesElapsedPerFrame = 0;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcCyclesMaxRow = 0;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcTaskCycles[ESP32_MAX_CALC_TASKS];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcTaskCyclesMaxRow[ESP32_MAX_CALC_TASKS];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+typename SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::frameStruct * SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcFrameBufferPtr;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcRows[MATRIX_SCAN_MOD];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcNumRows;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcLsbMsbTransitionBit;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcBrightnessShifts;
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::multiRowRefresh_mapIndex_CurrentRowGroups = 0;
 
@@ -73,6 +103,24 @@ int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, opt
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::multiRowRefresh_NumPanelsAlreadyMapped = 0;
 
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint16_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::refreshBufferMap[REFRESH_BUFFER_MAP_REQUIRED ? PIXELS_PER_LATCH : 1];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::refreshBufferMapRowOffsets[PHYSICAL_ROWS_PER_REFRESH_ROW];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+PanelStackRows SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::panelStackRowLUT[MATRIX_SCAN_MOD][PHYSICAL_ROWS_PER_REFRESH_ROW][MATRIX_STACK_HEIGHT];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::hardwareRowToRefreshRow[matrixHeight];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::refreshRowStaleFrames[MATRIX_SCAN_MOD];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+MATRIX_DATA_STORAGE_TYPE SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::controlBitTemplates[COLOR_DEPTH_BITS][PIXELS_PER_LATCH];
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::SmartMatrixHub75Calc(void) {
 }
@@ -109,6 +157,27 @@ int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, opt
     return ret;
 }
 
+// returns the number of CPU cycles spent filling the last frame buffer (all MATRIX_SCAN_MOD rows)
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getCalcCyclesPerFrame(void) {
+    return calcCyclesPerFrame;
+}
+
+// returns the number of CPU cycles from the start to the end of filling the last frame buffer, with dual core calculations
+// this is close to half of getCalcCyclesPerFrame(), which adds up the cycles spent by both cores
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getCalcElapsedCyclesPerFrame(void) {
+    return calcCyclesElapsedPerFrame;
+}
+
+// returns the largest number of cycles spent calculating a single row since the last call
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getMaxCalcCyclesPerRow(void) {
+    uint32_t ret = calcCyclesMaxRow;
+    calcCyclesMaxRow = 0;
+    return ret;
+}
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBufferUnderrunCallback(void) {
     dmaBufferUnderrun = true;
@@ -121,6 +190,8 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
     static int refreshFramesSinceLastCalculation = 0;
     SM_Layer * templayer;
     static bool firstRun = true;
+    static int lastBrightnessShifts = 0;
+    static int lastLsbMsbTransitionBit = -1;
 
     if(++refreshFramesSinceLastCalculation < calc_refreshRateDivider)
         return;
@@ -152,6 +223,9 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
     if(!refreshNeeded && !firstRun)
         return;
 
+    if(firstRun)
+        markAllRefreshRowsChanged();
+
     firstRun = false;
 
     // now we know we're actually going to update the frame, keep track of the time we started updating
@@ -165,6 +239,7 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
             templayer = templayer->nextLayer;
         }
         rotationChange = false;
+        markAllRefreshRowsChanged();
     }
 
     int largestRequestedBrightnessShifts = 0;
@@ -175,8 +250,18 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
             templayer->setRefreshRate(calc_refreshRate);
         }
 
+        bool layerChanged = templayer->isLayerChanged();
+
         templayer->frameRefreshCallback();
 
+        // only the refresh rows containing hardware rows changed by the layer need to be recalculated
+        if(layerChanged) {
+            for(int y = 0; y < matrixHeight; y++) {
+                if(templayer->isRefreshRowChanged(y))
+                    refreshRowStaleFrames[hardwareRowToRefreshRow[y]] = ESP32_NUM_FRAME_BUFFERS;
+            }
+        }
+
         int tempval = templayer->getRequestedBrightnessShifts();
         if(tempval > largestRequestedBrightnessShifts)
             largestRequestedBrightnessShifts = tempval;
@@ -193,6 +278,14 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
         brightnessChange = true;
     }
 
+    if (brightnessChange || largestRequestedBrightnessShifts != lastBrightnessShifts || lsbMsbTransitionBit != lastLsbMsbTransitionBit) {
+        // the OE bits and pixel data in every refresh row depend on the brightness
+        calculateControlBitTemplates();
+        markAllRefreshRowsChanged();
+        lastBrightnessShifts = largestRequestedBrightnessShifts;
+        lastLsbMsbTransitionBit = lsbMsbTransitionBit;
+    }
+
     if (brightnessChange) {
         SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setBrightness(shiftedBrightness);
         brightnessChange = false;
@@ -307,6 +400,15 @@ bool SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 TaskHandle_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcTaskHandle;
 
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+TaskHandle_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcWorkerTaskHandle;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+SemaphoreHandle_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcWorkerStartSemaphore;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+SemaphoreHandle_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcWorkerDoneSemaphore;
+
 /* Task2 with priority 2 */
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcTask(void* pvParameters)
@@ -337,6 +439,18 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
     }
 }
 
+// calculates the rows handed to it by calcTask on the other core, layers are only read from here, frameRefreshCallback() is still called only by calcTask
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcWorkerTask(void* pvParameters)
+{
+    while(1) {
+        if( xSemaphoreTake(calcWorkerStartSemaphore, portMAX_DELAY) == pdTRUE ) {
+            loadMatrixBufferRows(1);
+            xSemaphoreGive(calcWorkerDoneSemaphore);
+        }
+    }
+}
+
 #define MATRIX_CALC_TASK_DEFAULT_PRIORITY   2
 #define MATRIX_CALC_TASK_LOW_PRIORITY      1
 
@@ -352,6 +466,9 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
         templayer = templayer->nextLayer;
     }
 
+    calculateRefreshBufferMap();
+    calculatePanelStackRowLUT();
+
     calcTaskSemaphore = xSemaphoreCreateBinary();
 
     int taskPriority = MATRIX_CALC_TASK_DEFAULT_PRIORITY;
@@ -366,6 +483,12 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
     // TODO: fine tune stack size: 1000 works with 64x64/32-24bit, 500 doesn't, does it change based on matrix size, depth?
     xTaskCreatePinnedToCore(calcTask, "SmartMatrixCalc", 1000, NULL, taskPriority, &calcTaskHandle, calcTaskCore);
 
+    if(ESP32_NUM_CALC_TASKS > 1) {
+        calcWorkerStartSemaphore = xSemaphoreCreateBinary();
+        calcWorkerDoneSemaphore = xSemaphoreCreateBinary();
+        xTaskCreatePinnedToCore(calcWorkerTask, "SmartMatrixCalc1", 1000, NULL, taskPriority, &calcWorkerTaskHandle, !calcTaskCore);
+    }
+
     printf("SmartMatrix Layers Allocated from Heap:\r\n");
     show_esp32_heap_mem();
 
@@ -373,16 +496,18 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
     // malloc temporary buffers needed for loadMatrixBuffers
     int numPixelsPerTempRow = PIXELS_PER_LATCH/PHYSICAL_ROWS_PER_REFRESH_ROW;
 
-    if((COLOR_DEPTH_BITS == 12) || (COLOR_DEPTH_BITS == 16)){
-        tempRow0Ptr = malloc(sizeof(rgb48) * numPixelsPerTempRow);
-        tempRow1Ptr = malloc(sizeof(rgb48) * numPixelsPerTempRow);
-    } else {
-        tempRow0Ptr = malloc(sizeof(rgb24) * numPixelsPerTempRow);
-        tempRow1Ptr = malloc(sizeof(rgb24) * numPixelsPerTempRow);
-    }
+    for(int i=0; i<ESP32_NUM_CALC_TASKS; i++) {
+        if((COLOR_DEPTH_BITS == 12) || (COLOR_DEPTH_BITS == 16)){
+            tempRow0Ptr[i] = malloc(sizeof(rgb48) * numPixelsPerTempRow);
+            tempRow1Ptr[i] = malloc(sizeof(rgb48) * numPixelsPerTempRow);
+        } else {
+            tempRow0Ptr[i] = malloc(sizeof(rgb24) * numPixelsPerTempRow);
+            tempRow1Ptr[i] = malloc(sizeof(rgb24) * numPixelsPerTempRow);
+        }
 
-    assert(tempRow0Ptr != NULL);
-    assert(tempRow1Ptr != NULL);
+        assert(tempRow0Ptr[i] != NULL);
+        assert(tempRow1Ptr[i] != NULL);
+    }
 #endif
 
     SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setMatrixCalculationsCallback(matrixCalculationsSignal);
@@ -483,15 +608,182 @@ int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, opt
     return map[multiRowRefresh_mapIndex_CurrentPixelGroup].bufferOffset + multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped;
 }
 
+// Walk through the panel map once and store the refresh buffer position for every pixel in the temporary row buffers, so
+// loadMatrixBuffers48/24() can read the temporary rows in order and scatter pixels to the refresh buffer with a single lookup.
+// The map covers reversed pixel blocks, the offset of each panel in the chain, and upside down stacks with C-shape stacking
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calculateRefreshBufferMap(void) {
+    const int numPixelsPerTempRow = PIXELS_PER_LATCH/PHYSICAL_ROWS_PER_REFRESH_ROW;
+    int multiRowRefreshRowOffset = 0;
+
+    if(MULTI_ROW_REFRESH_REQUIRED) { 
+        resetMultiRowRefreshMapPosition();
+    }
+
+    // go through this process for each physical row that is contained in the refresh row
+    for(int physicalRow = 0; physicalRow < PHYSICAL_ROWS_PER_REFRESH_ROW; physicalRow++) {
+        refreshBufferMapRowOffsets[physicalRow] = multiRowRefreshRowOffset;
+
+        if(!REFRESH_BUFFER_MAP_REQUIRED)
+            break;
+
+        int i=0;
+
+        while(i < numPixelsPerTempRow) {
+            int numPixelsToMap;
+            int currentMapOffset;
+            bool reversePixelBlock = false;
+
+            if(MULTI_ROW_REFRESH_REQUIRED) { 
+                // get number of pixels to go through with current pass
+                numPixelsToMap = getMultiRowRefreshNumPixelsToMap();
+
+                if(numPixelsToMap < 0) {
+                    reversePixelBlock = true;
+                    numPixelsToMap = abs(numPixelsToMap);
+                }
+
+                // get offset where pixels are written in the refresh buffer
+                currentMapOffset = getMultiRowRefreshPixelGroupOffset();
+            } else {
+                numPixelsToMap = matrixWidth;
+                currentMapOffset = i;
+            }
+
+            // record where each pixel in this group is written in the refresh buffer
+            for(int k=0; k < numPixelsToMap; k++) {
+                int ind;
+
+                // for upside down stacks, flip order
+                int currentStack = i/matrixWidth;
+                if(isPanelStackReversed(currentStack, MATRIX_STACK_HEIGHT, optionFlags)) {
+                    // reverse order of this stack's data if it's reversed (if currentStack is the last stack, or an even number of stacks away from the last stack)
+                    ind = (currentStack*matrixWidth) + (matrixWidth-1) - ((i+k)%matrixWidth);
+                } else {
+                    // load data to buffer in normal order
+                    ind = i+k;
+                }
+
+                refreshBufferMap[(physicalRow * numPixelsPerTempRow) + ind] = reversePixelBlock ? (currentMapOffset - k) : (currentMapOffset + k);
+            }
+            i += numPixelsToMap; // keep track of current position on this temp buffer
+            if(MULTI_ROW_REFRESH_REQUIRED) { 
+                advanceMultiRowRefreshMapToNextPixelGroup();
+            }
+        }
+
+        if(MULTI_ROW_REFRESH_REQUIRED) { 
+            advanceMultiRowRefreshMapToNextRow();
+            multiRowRefreshRowOffset = getMultiRowRefreshRowOffset();
+        }
+    }
+}
+
+// Store the rows of the image to load for each stack of panels, for every refresh row and multi-row refresh offset, so
+// loadMatrixBuffers48/24() doesn't need to work out the stacking and orientation of each panel while refreshing
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calculatePanelStackRowLUT(void) {
+    // ESP32 loads Z-shape stacks in the opposite order from Teensy: with bottom to top stacking the bottom panel is loaded first
+    uint32_t stackingOptions = optionFlags;
+    if(!(optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING))
+        stackingOptions ^= SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING;
+
+    for(int currentRow = 0; currentRow < MATRIX_SCAN_MOD; currentRow++) {
+        for(int physicalRow = 0; physicalRow < PHYSICAL_ROWS_PER_REFRESH_ROW; physicalRow++) {
+            for(int i = 0; i < MATRIX_STACK_HEIGHT; i++) {
+                panelStackRowLUT[currentRow][physicalRow][i] = getPanelStackRows(currentRow + refreshBufferMapRowOffsets[physicalRow], i,
+                    MATRIX_STACK_HEIGHT, MATRIX_PANEL_HEIGHT, ROW_PAIR_OFFSET, stackingOptions);
+
+                hardwareRowToRefreshRow[panelStackRowLUT[currentRow][physicalRow][i].y0] = currentRow;
+                hardwareRowToRefreshRow[panelStackRowLUT[currentRow][physicalRow][i].y1] = currentRow;
+            }
+        }
+    }
+}
+
+// recalculate every refresh row in each of the frame buffers, for changes that affect the whole display
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::markAllRefreshRowsChanged(void) {
+    for(int currentRow = 0; currentRow < MATRIX_SCAN_MOD; currentRow++)
+        refreshRowStaleFrames[currentRow] = ESP32_NUM_FRAME_BUFFERS;
+}
+
 #define REFRESH_PRINTFS 0
 
 //#define OEPWM_TEST_ENABLE // this is likely broken now
 #define OEPWM_THRESHOLD_BIT 1
 
+// the OE and LAT bits only depend on the bitplane and the position in the refresh buffer, not on pixel data or the row being loaded,
+// so calculate them once here when brightness changes, and loadMatrixBuffers48/24() only need to add the address and RGB bits
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calculateControlBitTemplates(void) {
+    for(int j=0; j<COLOR_DEPTH_BITS; j++) {
+        for(int refreshBufferPosition=0; refreshBufferPosition < PIXELS_PER_LATCH; refreshBufferPosition++) {
+            int v=0;
+
+#if (CLKS_DURING_LATCH == 0)
+            // need to disable OE after latch to hide row transition
+            if((refreshBufferPosition) == 0) v|=BIT_OE;
+
+            // drive latch while shifting out last bit of RGB data
+            if((refreshBufferPosition) == PIXELS_PER_LATCH-1) v|=BIT_LAT;
+
+            // experimental FM6126A support on ESP32 without external latch: make LAT pulse 3x clocks wide, matching the FM6126A "DATA_LATCH" command (and not the "RESET_OEN" command)
+            if(optionFlags & SMARTMATRIX_OPTIONS_FM6126A_RESET_AT_START) {
+                if((refreshBufferPosition) == PIXELS_PER_LATCH-2) v|=BIT_LAT;
+                if((refreshBufferPosition) == PIXELS_PER_LATCH-3) v|=BIT_LAT;
+            }
+#endif
+
+            // turn off OE after brightness value is reached when displaying MSBs
+            // MSBs always output normal brightness
+            // LSB (!j) outputs normal brightness as MSB from previous row is being displayed
+            if((j > lsbMsbTransitionBit || !j) && ((refreshBufferPosition) >= shiftedBrightness)) v|=BIT_OE;
+
+#ifndef OEPWM_TEST_ENABLE
+            // special case for the bits *after* LSB through (lsbMsbTransitionBit) - OE is output after data is shifted, so need to set OE to fractional brightness
+            if(j && j <= lsbMsbTransitionBit) {
+                // divide brightness in half for each bit below lsbMsbTransitionBit
+                int lsbBrightness = shiftedBrightness >> (lsbMsbTransitionBit - j + 1);
+                if((refreshBufferPosition) >= lsbBrightness) v|=BIT_OE;
+            }
+#else
+            // TODO: this is probably not working after adding support for multi-row refresh panels
+            // special case for the bits *after* LSB through (lsbMsbTransitionBit) - OE is output after data is shifted, so need to set OE to fractional brightness
+            if(j && j <= lsbMsbTransitionBit) {
+                // all bits through OEPWM_THRESHOLD_BIT we handle by toggling short PWM pulses smaller than one clock cycle
+                if(j >= 1 && j <= OEPWM_THRESHOLD_BIT) {
+                    // width of pwm OE pulse is ~1/2 the width of a DMA OE pulse (so shift lsbPwmBrightnessPulses one fewer times than lsbBrightness)
+                    int lsbPwmBrightnessPulses = (shiftedBrightness) >> (lsbMsbTransitionBit - j + 1 - 1);
+                    // now setting brightness for LSB, use PWM OE
+                    if((refreshBufferPosition%2) || refreshBufferPosition >= (2 * lsbPwmBrightnessPulses)) v|=BIT_OE;
+                } else {
+                    // divide brightness in half for each bit below lsbMsbTransitionBit
+                    int lsbBrightness = shiftedBrightness >> (lsbMsbTransitionBit - j + 1);
+                    if((refreshBufferPosition) >= lsbBrightness) v|=BIT_OE;
+                }
+            }
+#endif
+
+            // need to turn off OE one clock before latch, otherwise can get ghosting
+#if (CLKS_DURING_LATCH > 0)
+            if((refreshBufferPosition)==PIXELS_PER_LATCH-1) v|=BIT_OE;
+#else
+            if((refreshBufferPosition)>=PIXELS_PER_LATCH-2) v|=BIT_OE;
+#endif
+
+            // HUB12 format inverts the OE signal
+            if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE)
+                v ^= BIT_OE;
+
+            controlBitTemplates[j][refreshBufferPosition] = v;
+        }
+    }
+}
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers48(frameStruct * frameBuffer, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts) {
+INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers48(frameStruct * frameBuffer, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts, int calcTaskIndex) {
     int i;
-    int multiRowRefreshRowOffset = 0;
     int numPixelsPerTempRow = PIXELS_PER_LATCH/PHYSICAL_ROWS_PER_REFRESH_ROW;
 
 #if (REFRESH_PRINTFS >= 1)
@@ -500,68 +792,26 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
 
 #if defined(ESP32)
     // use buffers malloc'd previously
-    rgb48 * tempRow0 = (rgb48*)tempRow0Ptr;
-    rgb48 * tempRow1 = (rgb48*)tempRow1Ptr;
+    rgb48 * tempRow0 = (rgb48*)tempRow0Ptr[calcTaskIndex];
+    rgb48 * tempRow1 = (rgb48*)tempRow1Ptr[calcTaskIndex];
 #else
     // static to avoid putting large buffer on the stack
     static rgb48 tempRow0[numPixelsPerTempRow];
     static rgb48 tempRow1[numPixelsPerTempRow];
 #endif
 
-    int c = 0;
-    resetMultiRowRefreshMapPosition();
-
     // go through this process for each physical row that is contained in the refresh row
-    do {
-        // clear buffer to prevent garbage data showing through transparent layers
-        memset(tempRow0, 0x00, sizeof(rgb48) * numPixelsPerTempRow);
-        memset(tempRow1, 0x00, sizeof(rgb48) * numPixelsPerTempRow);
-
+    for(int physicalRow = 0; physicalRow < PHYSICAL_ROWS_PER_REFRESH_ROW; physicalRow++) {
 #if (REFRESH_PRINTFS >= 1)
-        printf("multiRowRefreshRowOffset = %d\r\n", multiRowRefreshRowOffset);
+        printf("multiRowRefreshRowOffset = %d\r\n", refreshBufferMapRowOffsets[physicalRow]);
 #endif
 
-        // get a row of physical pixel data (HUB75 paired) from the layers
-        SM_Layer * templayer = SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
-        while(templayer) {
-            for(i=0; i<MATRIX_STACK_HEIGHT; i++) {
-                // Z-shape, bottom to top
-                if(!(optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
-                    (optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    // fill data from bottom to top, so bottom panel is the one closest to Teensy
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
-                // Z-shape, top to bottom
-                } else if(!(optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
-                    !(optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    // fill data from top to bottom, so top panel is the one closest to Teensy
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + i*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + i*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
-                // C-shape, bottom to top
-                } else if((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
-                    (optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    // alternate direction of filling (or loading) for each matrixwidth
-                    // swap row order from top to bottom for each stack (tempRow1 filled with top half of panel, tempRow0 filled with bottom half)
-                    if((MATRIX_STACK_HEIGHT-i+1)%2) {
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + ROW_PAIR_OFFSET + (i)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + (i)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
-                    } else {
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + (i)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (i)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
-                    }
-                // C-shape, top to bottom
-                } else if((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) && 
-                    !(optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    if((MATRIX_STACK_HEIGHT-i)%2) {
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
-                    } else {
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
-                    }
-                }
-            }
-            templayer = templayer->nextLayer;        
+        // get a row of physical pixel data (HUB75 paired) from the layers, loading a row from each stack of panels, see calculatePanelStackRowLUT()
+        // the buffers are only cleared where no opaque layer covers the row, see SM_Layer::fillRefreshRowFromLayers()
+        const PanelStackRows * stackRows = panelStackRowLUT[currentRow][physicalRow];
+        for(i=0; i<MATRIX_STACK_HEIGHT; i++) {
+            SM_Layer::fillRefreshRowFromLayers(SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer, stackRows[i].y0, &tempRow0[i*matrixWidth], matrixWidth, numBrightnessShifts);
+            SM_Layer::fillRefreshRowFromLayers(SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer, stackRows[i].y1, &tempRow1[i*matrixWidth], matrixWidth, numBrightnessShifts);
         }
 
         for(int j=0; j<COLOR_DEPTH_BITS; j++) {
@@ -577,181 +827,88 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
             
             SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rowBitStruct *p=&(frameBuffer->rowdata[currentRow].rowbits[j]); //bitplane location to write to
             
-            int i=0;
-
-            // reset pixel map offset so we start filling from the first panel again
-            resetMultiRowRefreshMapPositionPixelGroupToStartOfRow();
-
-            while(i < numPixelsPerTempRow) {
-                // get number of pixels to go through with current pass
-                int numPixelsToMap = getMultiRowRefreshNumPixelsToMap();
+            // position in the refresh buffer for each pixel in the temp buffer, see calculateRefreshBufferMap()
+            const uint16_t * rowMap = &refreshBufferMap[REFRESH_BUFFER_MAP_REQUIRED ? (physicalRow * numPixelsPerTempRow) : 0];
 
-#if (REFRESH_PRINTFS >= 1)
-                printf("numPixelsToMap = %d\r\n", numPixelsToMap);
-#endif
-
-                bool reversePixelBlock = false;
-                if(numPixelsToMap < 0) {
-                    reversePixelBlock = true;
-                    numPixelsToMap = abs(numPixelsToMap);
+            // ADDX lines output directly to GPIO are the same for every pixel in the bitplane
+            int addressBits = 0;
+#if (CLKS_DURING_LATCH == 0)
+            // if there is no latch to hold address, output ADDX lines directly to GPIO and latch data at end of cycle
+            int gpioRowAddress = currentRow;
+            // normally output current rows ADDX, special case for LSB, output previous row's ADDX (as previous row is being displayed for one latch cycle)
+            if(j == 0)
+                gpioRowAddress = currentRow-1;
+
+            if (panelType != SMARTMATRIX_HUB75_16ROW_32COL_MOD4SCAN_V4) {
+                if (gpioRowAddress & 0x01) addressBits|=BIT_A;
+                if (gpioRowAddress & 0x02) addressBits|=BIT_B;
+                if (gpioRowAddress & 0x04) addressBits|=BIT_C;
+                if (gpioRowAddress & 0x08) addressBits|=BIT_D;
+                if (gpioRowAddress & 0x10) addressBits|=BIT_E;                        
+            } else {
+                if (gpioRowAddress ==-1){
+                    addressBits|= ( (BIT_A) | ( BIT_B) | ( BIT_C) | ( BIT_D) | ( BIT_E) );
                 }
-
-                // get offset where pixels are written in the refresh buffer
-                int currentMapOffset = getMultiRowRefreshPixelGroupOffset();
-
-#if (REFRESH_PRINTFS >= 1)
-                printf("currentMapOffset = %d\r\n", currentMapOffset);
-#endif
-
-                // parse through grouping of pixels, loading from temp buffer and writing to refresh buffer
-                for(int k=0; k < numPixelsToMap; k++) {
-                    int v=0;
-
-                    int refreshBufferPosition;
-                    if(reversePixelBlock) {
-                        refreshBufferPosition = currentMapOffset-k;
-                    } else {
-                        refreshBufferPosition = currentMapOffset+k;
+                else {
+                    switch (gpioRowAddress % 4){
+                        case 0 : addressBits|= ( (!BIT_A) | ( BIT_B) | ( BIT_C) | ( BIT_D)); break;   
+                        case 1 : addressBits|= ( ( BIT_A) | (!BIT_B) | ( BIT_C) | ( BIT_D)); break;
+                        case 2 : addressBits|= ( ( BIT_A) | ( BIT_B) | (!BIT_C) | ( BIT_D)); break;
+                        case 3 : addressBits|= ( ( BIT_A) | ( BIT_B) | ( BIT_C) | (!BIT_D)); break;
                     }
-
-#if (REFRESH_PRINTFS >= 2)
-                printf("j = %02d, i = %03d, c = %03d, k = %03d, pos = %03d\r\n", j, i, c, k, refreshBufferPosition);
+                }
+            }
 #endif
 
-#if (CLKS_DURING_LATCH == 0)
-                    // if there is no latch to hold address, output ADDX lines directly to GPIO and latch data at end of cycle
-                    int gpioRowAddress = currentRow;
-                    // normally output current rows ADDX, special case for LSB, output previous row's ADDX (as previous row is being displayed for one latch cycle)
-                    if(j == 0)
-                        gpioRowAddress = currentRow-1;
-
-                    if (panelType != SMARTMATRIX_HUB75_16ROW_32COL_MOD4SCAN_V4) {
-                        if (gpioRowAddress & 0x01) v|=BIT_A;
-                        if (gpioRowAddress & 0x02) v|=BIT_B;
-                        if (gpioRowAddress & 0x04) v|=BIT_C;
-                        if (gpioRowAddress & 0x08) v|=BIT_D;
-                        if (gpioRowAddress & 0x10) v|=BIT_E;                        
-                    } else {
-                        if (gpioRowAddress ==-1){
-                            v|= ( (BIT_A) | ( BIT_B) | ( BIT_C) | ( BIT_D) | ( BIT_E) );
-                        }
-                        else {
-                            switch (gpioRowAddress % 4){
-                                case 0 : v|= ( (!BIT_A) | ( BIT_B) | ( BIT_C) | ( BIT_D)); break;   
-                                case 1 : v|= ( ( BIT_A) | (!BIT_B) | ( BIT_C) | ( BIT_D)); break;
-                                case 2 : v|= ( ( BIT_A) | ( BIT_B) | (!BIT_C) | ( BIT_D)); break;
-                                case 3 : v|= ( ( BIT_A) | ( BIT_B) | ( BIT_C) | (!BIT_D)); break;
-                            }
-                        }
-                    }
-
-                    // need to disable OE after latch to hide row transition
-                    if((refreshBufferPosition) == 0) v|=BIT_OE;
+            // OE and LAT bits for each position in the bitplane, see calculateControlBitTemplates()
+            const MATRIX_DATA_STORAGE_TYPE * controlBits = controlBitTemplates[j];
 
-                    // drive latch while shifting out last bit of RGB data
-                    if((refreshBufferPosition) == PIXELS_PER_LATCH-1) v|=BIT_LAT;
+            // parse through the temp buffer in order, loading pixels and writing them to the refresh buffer
+            for(int i=0; i < numPixelsPerTempRow; i++) {
+                int refreshBufferPosition = REFRESH_BUFFER_MAP_REQUIRED ? rowMap[i] : i;
 
-                    // experimental FM6126A support on ESP32 without external latch: make LAT pulse 3x clocks wide, matching the FM6126A "DATA_LATCH" command (and not the "RESET_OEN" command)
-                    if(optionFlags & SMARTMATRIX_OPTIONS_FM6126A_RESET_AT_START) {
-                        if((refreshBufferPosition) == PIXELS_PER_LATCH-2) v|=BIT_LAT;
-                        if((refreshBufferPosition) == PIXELS_PER_LATCH-3) v|=BIT_LAT;
-                    }
+#if (REFRESH_PRINTFS >= 2)
+                printf("j = %02d, i = %03d, pos = %03d\r\n", j, i, refreshBufferPosition);
 #endif
 
-                    // turn off OE after brightness value is reached when displaying MSBs
-                    // MSBs always output normal brightness
-                    // LSB (!j) outputs normal brightness as MSB from previous row is being displayed
-                    if((j > lsbMsbTransitionBit || !j) && ((refreshBufferPosition) >= shiftedBrightness)) v|=BIT_OE;
+                int v = controlBits[refreshBufferPosition] | addressBits;
+
+                if (tempRow0[i].red & mask)
+                    v|=BIT_R1;
+                if (tempRow0[i].green & mask)
+                    v|=BIT_G1;
+                if (tempRow0[i].blue & mask)
+                    v|=BIT_B1;
+                if (tempRow1[i].red & mask)
+                    v|=BIT_R2;
+                if (tempRow1[i].green & mask)
+                    v|=BIT_G2;
+                if (tempRow1[i].blue & mask)
+                    v|=BIT_B2;
+
+                // HUB12 format inverts the data (assume we're only using R1 for now), OE is already inverted in the template
+                if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE)
+                    v ^= BIT_R1;
 
-#ifndef OEPWM_TEST_ENABLE
-                    // special case for the bits *after* LSB through (lsbMsbTransitionBit) - OE is output after data is shifted, so need to set OE to fractional brightness
-                    if(j && j <= lsbMsbTransitionBit) {
-                        // divide brightness in half for each bit below lsbMsbTransitionBit
-                        int lsbBrightness = shiftedBrightness >> (lsbMsbTransitionBit - j + 1);
-                        if((refreshBufferPosition) >= lsbBrightness) v|=BIT_OE;
+                if(MATRIX_I2S_MODE == I2S_PARALLEL_BITS_8) {
+                    //Save the calculated value to the bitplane memory in 16-bit reversed order to account for I2S Tx FIFO mode1 ordering
+                    if(refreshBufferPosition%4 == 0){
+                        p->data[(refreshBufferPosition)+2] = v;
+                    } else if(refreshBufferPosition%4 == 1) {
+                        p->data[(refreshBufferPosition)+2] = v;
+                    } else if(refreshBufferPosition%4 == 2) {
+                        p->data[(refreshBufferPosition)-2] = v;
+                    } else { //if(refreshBufferPosition%4 == 3)
+                        p->data[(refreshBufferPosition)-2] = v;
                     }
-#else
-                    // TODO: this is probably not working after adding support for multi-row refresh panels
-                    // special case for the bits *after* LSB through (lsbMsbTransitionBit) - OE is output after data is shifted, so need to set OE to fractional brightness
-                    if(j && j <= lsbMsbTransitionBit) {
-                        // all bits through OEPWM_THRESHOLD_BIT we handle by toggling short PWM pulses smaller than one clock cycle
-                        if(j >= 1 && j <= OEPWM_THRESHOLD_BIT) {
-                            // width of pwm OE pulse is ~1/2 the width of a DMA OE pulse (so shift lsbPwmBrightnessPulses one fewer times than lsbBrightness)
-                            int lsbPwmBrightnessPulses = (shiftedBrightness) >> (lsbMsbTransitionBit - j + 1 - 1);
-                            // now setting brightness for LSB, use PWM OE
-                            if((k%2) || k >= (2 * lsbPwmBrightnessPulses)) v|=BIT_OE;
-                        } else {
-                            // divide brightness in half for each bit below lsbMsbTransitionBit
-                            int lsbBrightness = shiftedBrightness >> (lsbMsbTransitionBit - j + 1);
-                            if((refreshBufferPosition) >= lsbBrightness) v|=BIT_OE;
-                        }
-                    }                
-#endif
-                    
-                    // need to turn off OE one clock before latch, otherwise can get ghosting
-#if (CLKS_DURING_LATCH > 0)
-                    if((refreshBufferPosition)==PIXELS_PER_LATCH-1) v|=BIT_OE;
-#else
-                    if((refreshBufferPosition)>=PIXELS_PER_LATCH-2) v|=BIT_OE;
-#endif
-
-                    if (tempRow0[i+k].red & mask)
-                        v|=BIT_R1;
-                    if (tempRow0[i+k].green & mask)
-                        v|=BIT_G1;
-                    if (tempRow0[i+k].blue & mask)
-                        v|=BIT_B1;
-                    if (tempRow1[i+k].red & mask)
-                        v|=BIT_R2;
-                    if (tempRow1[i+k].green & mask)
-                        v|=BIT_G2;
-                    if (tempRow1[i+k].blue & mask)
-                        v|=BIT_B2;
-
-                    if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE) {
-                        // HUB12 format inverts the data (assume we're only using R1 for now), and OE signals
-
-                        if(v & BIT_OE) {
-                            v = v & ~(BIT_OE);
-                        } else {
-                            v |= BIT_OE;
-                        }
-
-                        if(v & BIT_R1) {
-                            v = v & ~(BIT_R1);
-                        } else {
-                            v |= BIT_R1;
-                        }
-                    }               
-
-                    if((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) && !((i/matrixWidth)%2)) {
-                        //currentRowDataPtr->rowbits[j].data[(((i+matrixWidth-1)-k)*DMA_UPDATES_PER_CLOCK)] = o0.word;
-                        //TODO: support C-shape stacking
+                } else {
+                    //Save the calculated value to the bitplane memory in reverse order to account for I2S Tx FIFO mode1 ordering
+                    if(refreshBufferPosition%2){
+                        p->data[(refreshBufferPosition)-1] = v;
                     } else {
-                        if(MATRIX_I2S_MODE == I2S_PARALLEL_BITS_8) {
-                            //Save the calculated value to the bitplane memory in 16-bit reversed order to account for I2S Tx FIFO mode1 ordering
-                            if(refreshBufferPosition%4 == 0){
-                                p->data[(refreshBufferPosition)+2] = v;
-                            } else if(refreshBufferPosition%4 == 1) {
-                                p->data[(refreshBufferPosition)+2] = v;
-                            } else if(refreshBufferPosition%4 == 2) {
-                                p->data[(refreshBufferPosition)-2] = v;
-                            } else { //if(refreshBufferPosition%4 == 3)
-                                p->data[(refreshBufferPosition)-2] = v;
-                            }
-                        } else {
-                            //Save the calculated value to the bitplane memory in reverse order to account for I2S Tx FIFO mode1 ordering
-                            if(refreshBufferPosition%2){
-                                p->data[(refreshBufferPosition)-1] = v;
-                            } else {
-                                p->data[(refreshBufferPosition)+1] = v;
-                            }
-                        }
+                        p->data[(refreshBufferPosition)+1] = v;
                     }
                 }
-
-                i += numPixelsToMap; // keep track of current position on this temp buffer
-                advanceMultiRowRefreshMapToNextPixelGroup();
             }
 
             // TODO: insert latch data for all color depth bits all at once at the end, saving a few cycles?
@@ -817,80 +974,33 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
             }
 #endif
         }
-
-        c += numPixelsPerTempRow; // keep track of cumulative number of pixels filled in refresh buffer before this temp buffer
-
-        advanceMultiRowRefreshMapToNextRow();
-        multiRowRefreshRowOffset = getMultiRowRefreshRowOffset();
-    } while (multiRowRefreshRowOffset > 0);
+    }
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers24(frameStruct * frameBuffer, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts) {
+INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers24(frameStruct * frameBuffer, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts, int calcTaskIndex) {
     int i;
-    int multiRowRefreshRowOffset = 0;
     int numPixelsPerTempRow = PIXELS_PER_LATCH/PHYSICAL_ROWS_PER_REFRESH_ROW;
 
 #if defined(ESP32)
     // use buffers malloc'd previously
-    rgb24 * tempRow0 = (rgb24*)tempRow0Ptr;
-    rgb24 * tempRow1 = (rgb24*)tempRow1Ptr;
+    rgb24 * tempRow0 = (rgb24*)tempRow0Ptr[calcTaskIndex];
+    rgb24 * tempRow1 = (rgb24*)tempRow1Ptr[calcTaskIndex];
 #else
     // static to avoid putting large buffer on the stack
     static rgb24 tempRow0[numPixelsPerTempRow];
     static rgb24 tempRow1[numPixelsPerTempRow];
 #endif
 
-    int c = 0;
-    resetMultiRowRefreshMapPosition();
-
     // go through this process for each physical row that is contained in the refresh row
-    do {
-        // clear buffer to prevent garbage data showing through transparent layers
-        memset(tempRow0, 0x00, sizeof(rgb24) * numPixelsPerTempRow);
-        memset(tempRow1, 0x00, sizeof(rgb24) * numPixelsPerTempRow);
-
-        // get a row of physical pixel data (HUB75 paired) from the layers
-        SM_Layer * templayer = SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
-        while(templayer) {
-            for(i=0; i<MATRIX_STACK_HEIGHT; i++) {
-                // Z-shape, bottom to top
-                if(!(optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
-                    (optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    // fill data from bottom to top, so bottom panel is the one closest to Teensy
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
-                // Z-shape, top to bottom
-                } else if(!(optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
-                    !(optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    // fill data from top to bottom, so top panel is the one closest to Teensy
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + i*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + i*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
-                // C-shape, bottom to top
-                } else if((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
-                    (optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    // alternate direction of filling (or loading) for each matrixwidth
-                    // swap row order from top to bottom for each stack (tempRow1 filled with top half of panel, tempRow0 filled with bottom half)
-                    if((MATRIX_STACK_HEIGHT-i+1)%2) {
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + ROW_PAIR_OFFSET + (i)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + (i)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
-                    } else {
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + (i)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (i)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
-                    }
-                // C-shape, top to bottom
-                } else if((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) && 
-                    !(optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    if((MATRIX_STACK_HEIGHT-i)%2) {
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
-                    } else {
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
-                    }
-                }
-            }
-            templayer = templayer->nextLayer;        
+    for(int physicalRow = 0; physicalRow < PHYSICAL_ROWS_PER_REFRESH_ROW; physicalRow++) {
+
+        // get a row of physical pixel data (HUB75 paired) from the layers, loading a row from each stack of panels, see calculatePanelStackRowLUT()
+        // the buffers are only cleared where no opaque layer covers the row, see SM_Layer::fillRefreshRowFromLayers()
+        const PanelStackRows * stackRows = panelStackRowLUT[currentRow][physicalRow];
+        for(i=0; i<MATRIX_STACK_HEIGHT; i++) {
+            SM_Layer::fillRefreshRowFromLayers(SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer, stackRows[i].y0, &tempRow0[i*matrixWidth], matrixWidth, numBrightnessShifts);
+            SM_Layer::fillRefreshRowFromLayers(SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer, stackRows[i].y1, &tempRow1[i*matrixWidth], matrixWidth, numBrightnessShifts);
         }
   
         for(int j=0; j<COLOR_DEPTH_BITS; j++) {
@@ -906,153 +1016,86 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
             
             SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rowBitStruct *p=&(frameBuffer->rowdata[currentRow].rowbits[j]); //bitplane location to write to
             
-            int i=0;
-
-            // reset pixel map offset so we start filling from the first panel again
-            resetMultiRowRefreshMapPositionPixelGroupToStartOfRow();
-
-            while(i < numPixelsPerTempRow) {
-                // get number of pixels to go through with current pass
-                int numPixelsToMap = getMultiRowRefreshNumPixelsToMap();
+            // position in the refresh buffer for each pixel in the temp buffer, see calculateRefreshBufferMap()
+            const uint16_t * rowMap = &refreshBufferMap[REFRESH_BUFFER_MAP_REQUIRED ? (physicalRow * numPixelsPerTempRow) : 0];
 
-                bool reversePixelBlock = false;
-                if(numPixelsToMap < 0) {
-                    reversePixelBlock = true;
-                    numPixelsToMap = abs(numPixelsToMap);
+            // ADDX lines output directly to GPIO are the same for every pixel in the bitplane
+            int addressBits = 0;
+#if (CLKS_DURING_LATCH == 0)
+            // if there is no latch to hold address, output ADDX lines directly to GPIO and latch data at end of cycle
+            int gpioRowAddress = currentRow;
+            // normally output current rows ADDX, special case for LSB, output previous row's ADDX (as previous row is being displayed for one latch cycle)
+            if(j == 0)
+                gpioRowAddress = currentRow-1;
+
+
+            // Applied patch from https://community.pixelmatix.com/t/mapping-assistance-32x16-p10/889/23 not fully integrated (ESP32 only)
+            if (panelType != SMARTMATRIX_HUB75_16ROW_32COL_MOD4SCAN_V4) {
+                if (gpioRowAddress & 0x01) addressBits|=BIT_A;
+                if (gpioRowAddress & 0x02) addressBits|=BIT_B;
+                if (gpioRowAddress & 0x04) addressBits|=BIT_C;
+                if (gpioRowAddress & 0x08) addressBits|=BIT_D;
+                if (gpioRowAddress & 0x10) addressBits|=BIT_E;                        
+            } else {
+                if (gpioRowAddress ==-1){
+                    addressBits|= ( (BIT_A) | ( BIT_B) | ( BIT_C) | ( BIT_D) | ( BIT_E) );
                 }
-
-                // get offset where pixels are written in the refresh buffer
-                int currentMapOffset = getMultiRowRefreshPixelGroupOffset();
-
-                // parse through grouping of pixels, loading from temp buffer and writing to refresh buffer
-                for(int k=0; k < numPixelsToMap; k++) {
-                    int v=0;
-
-                    int refreshBufferPosition;
-                    if(reversePixelBlock) {
-                        refreshBufferPosition = currentMapOffset-k;
-                    } else {
-                        refreshBufferPosition = currentMapOffset+k;
+                else {
+                    switch (gpioRowAddress % 4){
+                        case 0 : addressBits|= ( (!BIT_A) | ( BIT_B) | ( BIT_C) | ( BIT_D)); break;   
+                        case 1 : addressBits|= ( ( BIT_A) | (!BIT_B) | ( BIT_C) | ( BIT_D)); break;
+                        case 2 : addressBits|= ( ( BIT_A) | ( BIT_B) | (!BIT_C) | ( BIT_D)); break;
+                        case 3 : addressBits|= ( ( BIT_A) | ( BIT_B) | ( BIT_C) | (!BIT_D)); break;
                     }
+                }
+            }
+#endif
 
-#if (CLKS_DURING_LATCH == 0)
-                    // if there is no latch to hold address, output ADDX lines directly to GPIO and latch data at end of cycle
-                    int gpioRowAddress = currentRow;
-                    // normally output current rows ADDX, special case for LSB, output previous row's ADDX (as previous row is being displayed for one latch cycle)
-                    if(j == 0)
-                        gpioRowAddress = currentRow-1;
-
-
-                    // Applied patch from https://community.pixelmatix.com/t/mapping-assistance-32x16-p10/889/23 not fully integrated (ESP32 only)
-                    if (panelType != SMARTMATRIX_HUB75_16ROW_32COL_MOD4SCAN_V4) {
-                        if (gpioRowAddress & 0x01) v|=BIT_A;
-                        if (gpioRowAddress & 0x02) v|=BIT_B;
-                        if (gpioRowAddress & 0x04) v|=BIT_C;
-                        if (gpioRowAddress & 0x08) v|=BIT_D;
-                        if (gpioRowAddress & 0x10) v|=BIT_E;                        
-                    } else {
-                        if (gpioRowAddress ==-1){
-                            v|= ( (BIT_A) | ( BIT_B) | ( BIT_C) | ( BIT_D) | ( BIT_E) );
-                        }
-                        else {
-                            switch (gpioRowAddress % 4){
-                                case 0 : v|= ( (!BIT_A) | ( BIT_B) | ( BIT_C) | ( BIT_D)); break;   
-                                case 1 : v|= ( ( BIT_A) | (!BIT_B) | ( BIT_C) | ( BIT_D)); break;
-                                case 2 : v|= ( ( BIT_A) | ( BIT_B) | (!BIT_C) | ( BIT_D)); break;
-                                case 3 : v|= ( ( BIT_A) | ( BIT_B) | ( BIT_C) | (!BIT_D)); break;
-                            }
-                        }
-                    }
+            // OE and LAT bits for each position in the bitplane, see calculateControlBitTemplates()
+            const MATRIX_DATA_STORAGE_TYPE * controlBits = controlBitTemplates[j];
 
-                    // need to disable OE after latch to hide row transition
-                    if((refreshBufferPosition) == 0) v|=BIT_OE;
+            // parse through the temp buffer in order, loading pixels and writing them to the refresh buffer
+            for(int i=0; i < numPixelsPerTempRow; i++) {
+                int refreshBufferPosition = REFRESH_BUFFER_MAP_REQUIRED ? rowMap[i] : i;
 
-                    // drive latch while shifting out last bit of RGB data
-                    if((refreshBufferPosition) == PIXELS_PER_LATCH-1) v|=BIT_LAT;
+                int v = controlBits[refreshBufferPosition] | addressBits;
 
-                    // experimental FM6126A support on ESP32 without external latch: make LAT pulse 3x clocks wide, matching the FM6126A "DATA_LATCH" command (and not the "RESET_OEN" command)
-                    if(optionFlags & SMARTMATRIX_OPTIONS_FM6126A_RESET_AT_START) {
-                        if((refreshBufferPosition) == PIXELS_PER_LATCH-2) v|=BIT_LAT;
-                        if((refreshBufferPosition) == PIXELS_PER_LATCH-3) v|=BIT_LAT;
-                    }
-#endif
+                if (tempRow0[i].red & mask)
+                    v|=BIT_R1;
+                if (tempRow0[i].green & mask)
+                    v|=BIT_G1;
+                if (tempRow0[i].blue & mask)
+                    v|=BIT_B1;
+                if (tempRow1[i].red & mask)
+                    v|=BIT_R2;
+                if (tempRow1[i].green & mask)
+                    v|=BIT_G2;
+                if (tempRow1[i].blue & mask)
+                    v|=BIT_B2;
 
-                    // turn off OE after brightness value is reached when displaying MSBs
-                    // MSBs always output normal brightness
-                    // LSB (!j) outputs normal brightness as MSB from previous row is being displayed
-                    if((j > lsbMsbTransitionBit || !j) && ((refreshBufferPosition) >= shiftedBrightness)) v|=BIT_OE;
+                // HUB12 format inverts the data (assume we're only using R1 for now), OE is already inverted in the template
+                if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE)
+                    v ^= BIT_R1;
 
-                    // special case for the bits *after* LSB through (lsbMsbTransitionBit) - OE is output after data is shifted, so need to set OE to fractional brightness
-                    if(j && j <= lsbMsbTransitionBit) {
-                        // divide brightness in half for each bit below lsbMsbTransitionBit
-                        int lsbBrightness = shiftedBrightness >> (lsbMsbTransitionBit - j + 1);
-                        if((refreshBufferPosition) >= lsbBrightness) v|=BIT_OE;
+                if(MATRIX_I2S_MODE == I2S_PARALLEL_BITS_8) {
+                    //Save the calculated value to the bitplane memory in 16-bit reversed order to account for I2S Tx FIFO mode1 ordering
+                    if(refreshBufferPosition%4 == 0){
+                        p->data[(refreshBufferPosition)+2] = v;
+                    } else if(refreshBufferPosition%4 == 1) {
+                        p->data[(refreshBufferPosition)+2] = v;
+                    } else if(refreshBufferPosition%4 == 2) {
+                        p->data[(refreshBufferPosition)-2] = v;
+                    } else { //if(refreshBufferPosition%4 == 3)
+                        p->data[(refreshBufferPosition)-2] = v;
                     }
-
-                    // need to turn off OE one clock before latch, otherwise can get ghosting
-#if (CLKS_DURING_LATCH > 0)
-                    if((refreshBufferPosition)==PIXELS_PER_LATCH-1) v|=BIT_OE;
-#else
-                    if((refreshBufferPosition)>=PIXELS_PER_LATCH-2) v|=BIT_OE;
-#endif
-
-                    if (tempRow0[i+k].red & mask)
-                        v|=BIT_R1;
-                    if (tempRow0[i+k].green & mask)
-                        v|=BIT_G1;
-                    if (tempRow0[i+k].blue & mask)
-                        v|=BIT_B1;
-                    if (tempRow1[i+k].red & mask)
-                        v|=BIT_R2;
-                    if (tempRow1[i+k].green & mask)
-                        v|=BIT_G2;
-                    if (tempRow1[i+k].blue & mask)
-                        v|=BIT_B2;
-
-                    if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE) {
-                        // HUB12 format inverts the data (assume we're only using R1 for now), and OE signals
-
-                        if(v & BIT_OE) {
-                            v = v & ~(BIT_OE);
-                        } else {
-                            v |= BIT_OE;
-                        }
-
-                        if(v & BIT_R1) {
-                            v = v & ~(BIT_R1);
-                        } else {
-                            v |= BIT_R1;
-                        }
-                    }               
-
-                    if((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) && !((i/matrixWidth)%2)) {
-                        //currentRowDataPtr->rowbits[j].data[(((i+matrixWidth-1)-k)*DMA_UPDATES_PER_CLOCK)] = o0.word;
-                        //TODO: support C-shape stacking
+                } else {
+                    //Save the calculated value to the bitplane memory in reverse order to account for I2S Tx FIFO mode1 ordering
+                    if(refreshBufferPosition%2){
+                        p->data[(refreshBufferPosition)-1] = v;
                     } else {
-                        if(MATRIX_I2S_MODE == I2S_PARALLEL_BITS_8) {
-                            //Save the calculated value to the bitplane memory in 16-bit reversed order to account for I2S Tx FIFO mode1 ordering
-                            if(refreshBufferPosition%4 == 0){
-                                p->data[(refreshBufferPosition)+2] = v;
-                            } else if(refreshBufferPosition%4 == 1) {
-                                p->data[(refreshBufferPosition)+2] = v;
-                            } else if(refreshBufferPosition%4 == 2) {
-                                p->data[(refreshBufferPosition)-2] = v;
-                            } else { //if(refreshBufferPosition%4 == 3)
-                                p->data[(refreshBufferPosition)-2] = v;
-                            }
-                        } else {
-                            //Save the calculated value to the bitplane memory in reverse order to account for I2S Tx FIFO mode1 ordering
-                            if(refreshBufferPosition%2){
-                                p->data[(refreshBufferPosition)-1] = v;
-                            } else {
-                                p->data[(refreshBufferPosition)+1] = v;
-                            }
-                        }
+                        p->data[(refreshBufferPosition)+1] = v;
                     }
                 }
-
-                i += numPixelsToMap; // keep track of current position on this temp buffer
-                advanceMultiRowRefreshMapToNextPixelGroup();
             }
 
 #if (CLKS_DURING_LATCH > 0)
@@ -1108,29 +1151,73 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
             }
 #endif
         }
+    }
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers(int lsbMsbTransitionBit, int numBrightnessShifts) {
+    calcFrameBufferPtr = SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getNextFrameBufferPtr();
+    calcLsbMsbTransitionBit = lsbMsbTransitionBit;
+    calcBrightnessShifts = numBrightnessShifts;
+
+    // rows that haven't changed since they were last written to this frame buffer are reused in place
+    // the list of rows is made here so the stale counts are only touched by this task
+    calcNumRows = 0;
+    for(int currentRow = 0; currentRow < MATRIX_SCAN_MOD; currentRow++) {
+        if(!refreshRowStaleFrames[currentRow])
+            continue;
+
+        refreshRowStaleFrames[currentRow]--;
+        calcRows[calcNumRows++] = currentRow;
+    }
+
+    uint32_t frameStartCycles = SM_GET_CPU_CYCLE_COUNT();
+
+    // the worker task takes every other row in the list, and we wait for it to finish before the frame buffer is handed to the refresh class
+    if(ESP32_NUM_CALC_TASKS > 1)
+        xSemaphoreGive(calcWorkerStartSemaphore);
+
+    loadMatrixBufferRows(0);
 
-        c += numPixelsPerTempRow; // keep track of cumulative number of pixels filled in refresh buffer before this temp buffer
+    if(ESP32_NUM_CALC_TASKS > 1)
+        xSemaphoreTake(calcWorkerDoneSemaphore, portMAX_DELAY);
 
-        advanceMultiRowRefreshMapToNextRow();
-        multiRowRefreshRowOffset = getMultiRowRefreshRowOffset();
-    } while (multiRowRefreshRowOffset > 0);
+    calcCyclesElapsedPerFrame = SM_GET_CPU_CYCLE_COUNT() - frameStartCycles;
+
+    uint32_t frameCycles = 0;
+    for(int i=0; i<ESP32_NUM_CALC_TASKS; i++) {
+        frameCycles += calcTaskCycles[i];
+        if(calcTaskCyclesMaxRow[i] > calcCyclesMaxRow)
+            calcCyclesMaxRow = calcTaskCyclesMaxRow[i];
+    }
+    calcCyclesPerFrame = frameCycles;
 }
 
+// calculates this task's share of the rows listed by loadMatrixBuffers(), each calc task only writes to its own temporary rows and profiling counters
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers(int lsbMsbTransitionBit, int numBrightnessShifts) {
-#if 1
-    unsigned char currentRow;
+INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBufferRows(int calcTaskIndex) {
+    uint32_t frameCycles = 0;
+    uint32_t maxRowCycles = 0;
+
+    for(int i = calcTaskIndex; i < calcNumRows; i += ESP32_NUM_CALC_TASKS) {
+        int currentRow = calcRows[i];
 
-    frameStruct * currentFrameDataPtr = SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getNextFrameBufferPtr();
+        uint32_t rowStartCycles = SM_GET_CPU_CYCLE_COUNT();
 
-    for(currentRow = 0; currentRow < MATRIX_SCAN_MOD; currentRow++) {
         // TODO: support rgb36/48 with same function, copy function to rgb24
         if(COLOR_DEPTH_BITS == 16)
-            loadMatrixBuffers48(currentFrameDataPtr, currentRow, lsbMsbTransitionBit, numBrightnessShifts);
+            loadMatrixBuffers48(calcFrameBufferPtr, currentRow, calcLsbMsbTransitionBit, calcBrightnessShifts, calcTaskIndex);
         else if(COLOR_DEPTH_BITS == 12)
-            loadMatrixBuffers48(currentFrameDataPtr, currentRow, lsbMsbTransitionBit, numBrightnessShifts);
+            loadMatrixBuffers48(calcFrameBufferPtr, currentRow, calcLsbMsbTransitionBit, calcBrightnessShifts, calcTaskIndex);
         else if(COLOR_DEPTH_BITS == 8)
-            loadMatrixBuffers24(currentFrameDataPtr, currentRow, lsbMsbTransitionBit, numBrightnessShifts);
+            loadMatrixBuffers24(calcFrameBufferPtr, currentRow, calcLsbMsbTransitionBit, calcBrightnessShifts, calcTaskIndex);
+
+        uint32_t rowCycles = SM_GET_CPU_CYCLE_COUNT() - rowStartCycles;
+        if(rowCycles > maxRowCycles)
+            maxRowCycles = rowCycles;
+        frameCycles += rowCycles;
     }
-#endif
+
+    calcTaskCycles[calcTaskIndex] = frameCycles;
+    calcTaskCyclesMaxRow[calcTaskIndex] = maxRowCycles;
 }
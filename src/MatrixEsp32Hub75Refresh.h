@@ -69,7 +69,7 @@ private:
 
     static matrix_calc_callback matrixCalcCallback;
 
-    static CircularBuffer_SM dmaBuffer;
+    static SpscRing_SM dmaBuffer;
 };
 
 #endif
@@ -71,7 +71,7 @@ private:
 
     matrix_calc_callback matrixCalcCallback;
 
-    CircularBuffer_SM dmaBuffer;
+    SpscRing_SM dmaBuffer;
 
     const uint16_t matrixWidth;
     const uint16_t matrixHeight;
@@ -51,7 +51,7 @@ void frameShiftCompleteISR(void);
 
 template <int dummyvar>
 bool SmartMatrixHub75Refresh_NT<dummyvar>::isFrameBufferFree(void) {
-    if(cbIsFull(&dmaBuffer))
+    if(dmaBuffer.isFull())
         return false;
     else
         return true;
@@ -59,14 +59,14 @@ bool SmartMatrixHub75Refresh_NT<dummyvar>::isFrameBufferFree(void) {
 
 template <int dummyvar>
 MATRIX_DATA_STORAGE_TYPE * SmartMatrixHub75Refresh_NT<dummyvar>::getNextFrameBufferPtr(void) {
-    return matrixUpdateFrames[cbGetNextWrite(&dmaBuffer)];
+    return matrixUpdateFrames[dmaBuffer.getNextWrite()];
 }
 
 template <int dummyvar>
 void SmartMatrixHub75Refresh_NT<dummyvar>::writeFrameBuffer(uint8_t currentFrame) {
     //SmartMatrixHub75Refresh_NT<dummyvar>::frameStruct * currentFramePtr = SmartMatrixHub75Refresh_NT<dummyvar>::getNextFrameBufferPtr();
-    i2s_parallel_flip_to_buffer(&I2S1, cbGetNextWrite(&dmaBuffer));
-    cbWrite(&dmaBuffer);
+    i2s_parallel_flip_to_buffer(&I2S1, dmaBuffer.getNextWrite());
+    dmaBuffer.write();
 }
 
 template <int dummyvar>
@@ -100,7 +100,7 @@ uint16_t SmartMatrixHub75Refresh_NT<dummyvar>::getRefreshRate(void) {
 
 template <int dummyvar>
 void SmartMatrixHub75Refresh_NT<dummyvar>::begin(uint32_t dmaRamToKeepFreeBytes) {
-    cbInit(&dmaBuffer, ESP32_NUM_FRAME_BUFFERS);
+    dmaBuffer.init(ESP32_NUM_FRAME_BUFFERS);
 
     printf("Starting SmartMatrix DMA Mallocs\r\n");
 
@@ -460,8 +460,8 @@ void SmartMatrixHub75Refresh_NT<dummyvar>::begin(uint32_t dmaRamToKeepFreeBytes)
 
 template <int dummyvar>
 void SmartMatrixHub75Refresh_NT<dummyvar>::markRefreshComplete(void) {
-    if(!cbIsEmpty(&dmaBuffer))
-        cbRead(&dmaBuffer);
+    if(!dmaBuffer.isEmpty())
+        dmaBuffer.read();
 }
 
 template <int dummyvar>
@@ -47,6 +47,9 @@
 // for now, until DMA sharing complications (brought to light by Teensy 3.6 SDIO) can be worked out, enable DMA Bandwidth Control, which approximately doubles this estimated time
 #define PANEL_32_PIXELDATA_TRANSFER_MAXIMUM_NS  (uint32_t)((2 * 3400 * 96000000.0) / F_CPU)
 
+// CLK period with SM_HUB75_OPTIONS_T3_HARDWARE_CLK, 32 pixels take about as long as PANEL_32_PIXELDATA_TRANSFER_MAXIMUM_NS at 96MHz
+#define HARDWARE_CLK_PERIOD_NS      200
+
 /* this section describes how the microcontroller is attached to the display */
 
 // these defines map the HUB75 signal to PORTD signals - if your panel has non-standard RGB order, swap signals here
@@ -109,6 +112,11 @@
         CORE_PIN4_CONFIG = PORT_PCR_MUX(3) | PORT_PCR_DSE | PORT_PCR_SRE;   \
     }
 
+// output CLK on pin 14 (PORTD.1) from FTM3 channel 1 instead of GPIO, only possible on Teensy 3.5/3.6, see SM_HUB75_OPTIONS_T3_HARDWARE_CLK
+#define ENABLE_HARDWARE_CLK_OUTPUT() {                                  \
+        CORE_PIN14_CONFIG = PORT_PCR_MUX(4) | PORT_PCR_DSE | PORT_PCR_SRE;  \
+    }
+
 // pin 3 (PORTA.12) triggers based on latch signal, on rising edge
 #define ENABLE_LATCH_RISING_EDGE_GPIO_INT() {       \
         CORE_PIN3_CONFIG |= PORT_PCR_IRQC(1);           \
@@ -162,3 +162,30 @@ const PanelMappingEntry * getMultiRowRefreshPanelMap(unsigned char panelType) {
             return defaultPanelMap;            
     }
 }
+
+// C-shaped stacking: alternate direction for each matrixWidth-sized stack, the last stack (closest to the controller) is always
+// right-side up, figure out orientation of other stacks based on that.  Upside down stacks need their pixels loaded in reverse order
+bool isPanelStackReversed(int stack, int stackHeight, uint32_t optionFlags) {
+    return (optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) && ((stack % 2) != ((stackHeight - 1) % 2));
+}
+
+// Get the rows of the image that are loaded for one stack of panels, where stack is the order the stack is loaded into the
+// refresh buffer, and panelRow is the row within the top half of the panel (refresh row plus multi-row refresh offset)
+PanelStackRows getPanelStackRows(int panelRow, int stack, int stackHeight, int panelHeight, int rowPairOffset, uint32_t optionFlags) {
+    PanelStackRows rows;
+
+    // Bottom to Top Stacking: load data buffer with top panels first, bottom panels last, as top panels are at the furthest end of the chain (initial data is shifted out the furthest)
+    // Top to Bottom Stacking: load data buffer with bottom panels first, top panels last, as bottom panels are at the furthest end of the chain
+    int panelIndex = (optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING) ? stack : (stackHeight - stack - 1);
+
+    if(isPanelStackReversed(stack, stackHeight, optionFlags)) {
+        // upside down panel: swap row order from top to bottom (y1 is in the top half of the panel, y0 in the bottom half)
+        rows.y0 = (panelIndex * panelHeight) + (panelHeight - 1 - panelRow);
+        rows.y1 = rows.y0 - rowPairOffset;
+    } else {
+        rows.y0 = (panelIndex * panelHeight) + panelRow;
+        rows.y1 = rows.y0 + rowPairOffset;
+    }
+
+    return rows;
+}
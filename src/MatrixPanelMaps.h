@@ -24,6 +24,8 @@
 #ifndef _PANEL_MAPS_H_
 #define _PANEL_MAPS_H_
 
+#include <stdint.h>
+
 typedef struct PanelMappingEntry {
     int         rowOffset;
     int         bufferOffset;
@@ -32,4 +34,13 @@ typedef struct PanelMappingEntry {
 
 const PanelMappingEntry * getMultiRowRefreshPanelMap(unsigned char panelType);
 
+// rows of the image loaded into the two temporary row buffers (R1/G1/B1 and R2/G2/B2 data) for one stack of panels
+typedef struct PanelStackRows {
+    uint16_t    y0;
+    uint16_t    y1;
+} PanelStackRows;
+
+bool isPanelStackReversed(int stack, int stackHeight, uint32_t optionFlags);
+PanelStackRows getPanelStackRows(int panelRow, int stack, int stackHeight, int panelHeight, int rowPairOffset, uint32_t optionFlags);
+
 #endif
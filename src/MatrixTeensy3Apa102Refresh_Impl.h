@@ -62,10 +62,10 @@ template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char pan
 void apaRowCalculationISR(void);
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-CircularBuffer_SM SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer;
+SpscRing_SM SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer;
 
-// dmaBufferNumRows = the size of the buffer that DMA pulls from to refresh the display
-// must be minimum 2 rows so one can be updated while the other is refreshed
+// dmaBufferNumRows = the number of frames in the buffer that DMA pulls from to refresh the display
+// minimum 2 frames (see APA102_NUM_FRAME_BUFFERS) so one can be updated while the other is refreshed
 // increase beyond two to give more time for the update routine to complete
 // (increase this number if non-DMA interrupts are causing display problems)
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -83,16 +83,20 @@ uint16_t SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panel
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 typename SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::frameDataStruct * SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateFrame;
 
+// set while a frame is shifting out, cleared by apaRowCalculationISR()
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+volatile uint8_t SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripsShifting;
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::SmartMatrixAPA102Refresh(uint8_t bufferrows, frameDataStruct * frameDataBuffer) {
-    dmaBufferNumRows = bufferrows;
+    dmaBufferNumRows = APA102_NUM_FRAME_BUFFERS(bufferrows);
 
     matrixUpdateFrame = frameDataBuffer;
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 bool SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::isRowBufferFree(void) {
-    if(cbIsFull(&dmaBuffer))
+    if(dmaBuffer.isFull())
         return false;
     else
         return true;
@@ -100,12 +104,12 @@ bool SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 typename SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::frameDataStruct * SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getNextRowBufferPtr(void) {
-    return &(matrixUpdateFrame[cbGetNextWrite(&dmaBuffer)]);
+    return &(matrixUpdateFrame[dmaBuffer.getNextWrite()]);
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::writeRowBuffer(uint8_t currentRow) {
-    cbWrite(&dmaBuffer);
+    dmaBuffer.write();
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -158,7 +162,9 @@ void SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::begin(void) {
-    cbInit(&dmaBuffer, dmaBufferNumRows);
+    static_assert(APA102_NUM_STRIPS == 1, "SM_APA102_OPTIONS_PARALLEL_STRIPS is only supported on Teensy 4");
+
+    dmaBuffer.init(dmaBufferNumRows);
 
     // setup debug output
 #ifdef DEBUG_PINS_ENABLED
@@ -226,10 +232,9 @@ void apaRowCalculationISR(void) {
 #endif
 
     dmaClockOutDataApa.clearInterrupt();
+    SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripsShifting = 0;
 
-    // done with previous row, mark it as read
-    cbRead(&SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer);
-
+    // the frame that was just sent stays in the buffer until apaRowShiftCompleteISR() has a newer frame to send
     SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixCalcCallback(false);
 
 #ifdef DEBUG_PINS_ENABLED
@@ -244,24 +249,29 @@ void apaRowShiftCompleteISR(void) {
 #ifdef DEBUG_PINS_ENABLED
     digitalWriteFast(DEBUG_PIN_1, HIGH); // oscilloscope trigger
 #endif
-    int currentRow = cbGetNextRead(&SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer);
-
-    // TODO: if underrun
-        // set flag so other ISR can enable DMA again when data is ready
-        //SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBufferUnderrun = true;
-    // else, start SPI
-    SPI.endTransaction();
-
-    // disable SPI interrupts
-    SPI0_RSER = 0;
-    // clear flags
-    SPI0_SR = SPI_SR_TCF | SPI_SR_EOQF | SPI_SR_TFUF | SPI_SR_TFFF | SPI_SR_RFOF | SPI_SR_RFDF;
-    dmaClockOutDataApa.sourceBuffer(SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateFrame[currentRow].data,
-        ((matrixWidth * matrixHeight)*4) + (4+4));
-    // Enable Transmit Fill DMA Requests
-    SPI0_RSER = SPI_RSER_TFFF_RE | SPI_RSER_TFFF_DIRS;
-    SPI.beginTransaction(SPISettings(SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::spiClockSpeed, MSBFIRST, SPI_MODE0));
-    dmaClockOutDataApa.enable();
+    // the last frame is still shifting out, skip this refresh instead of restarting the transfer
+    // until the calc has written its first frame, the buffer at getNextRead() is the one being calculated, so there's nothing to send
+    if(!SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripsShifting && SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.getNumElements()) {
+        // release the frame that was refreshed last if there's a newer frame, otherwise refresh the same frame again
+        if(SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.getNumElements() > 1)
+            SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.read();
+
+        int currentRow = SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.getNextRead();
+
+        SPI.endTransaction();
+
+        // disable SPI interrupts
+        SPI0_RSER = 0;
+        // clear flags
+        SPI0_SR = SPI_SR_TCF | SPI_SR_EOQF | SPI_SR_TFUF | SPI_SR_TFFF | SPI_SR_RFOF | SPI_SR_RFDF;
+        dmaClockOutDataApa.sourceBuffer(SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateFrame[currentRow].data,
+            APA102_STRIP_BYTES);
+        // Enable Transmit Fill DMA Requests
+        SPI0_RSER = SPI_RSER_TFFF_RE | SPI_RSER_TFFF_DIRS;
+        SPI.beginTransaction(SPISettings(SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::spiClockSpeed, MSBFIRST, SPI_MODE0));
+        SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripsShifting = 1;
+        dmaClockOutDataApa.enable();
+    }
 
 #ifndef USE_INTERVALTIMER_NOT_FTM
     // clear timer overflow bit before leaving ISR
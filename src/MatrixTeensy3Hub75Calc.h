@@ -48,18 +48,26 @@ public:
 
     // debug
     void countFPS(void);
+    uint32_t getCalcCyclesPerFrame(void);
+    uint32_t getMaxCalcCyclesPerRow(void);
 
     // functions called by ISR
     static void matrixCalculations(bool initial);
     static void dmaBufferUnderrunCallback(void);
 
 private:
+    // compares loadMatrixBuffersPacked() with loadMatrixBuffers48(), see extras/host/PackedRowTest_Teensy3.cpp
+    friend struct SmartMatrixPackedRowTest;
+
     static SM_Layer * baseLayer;
 
     // functions for refreshing
     static void loadMatrixBuffers(unsigned char currentRow);
     template <typename RGB_TEMP>
     static void loadMatrixBuffers48(rowDataStruct * currentRowDataPtr, unsigned char currentRow, RGB_TEMP tempBufferType);
+    template <typename RGB_TEMP>
+    static void loadMatrixBuffersPacked(rowDataStruct * currentRowDataPtr, unsigned char currentRow, RGB_TEMP tempBufferType);
+    static void calculateBitplaneLUTs(void);
     static void resetMultiRowRefreshMapPosition(void);
     static void resetMultiRowRefreshMapPositionPixelGroupToStartOfRow(void);
     static void advanceMultiRowRefreshMapToNextRow(void);
@@ -67,6 +75,8 @@ private:
     static int getMultiRowRefreshRowOffset(void);
     static int getMultiRowRefreshNumPixelsToMap(void);
     static int getMultiRowRefreshPixelGroupOffset(void);
+    static void calculateRefreshBufferMap(void);
+    static void calculatePanelStackRowLUT(void);
 
     // configuration
     static volatile bool brightnessChange;
@@ -79,10 +89,29 @@ private:
     static bool refreshRateLowered;
     static bool refreshRateChanged;
 
+    // advanced each frame to move the dither pattern, see hub75DitherThreshold()
+    static uint8_t ditherFrame;
+
+    // lookup tables used by loadMatrixBuffersPacked() to transpose pixel data into bitplanes
+    static uint32_t bitplaneSpreadLUT[16];
+    static uint16_t bitplaneGpioLUT[64];
+
+    // profiling
+    static uint32_t calcCyclesPerFrame;
+    static uint32_t calcCyclesCurrentFrame;
+    static uint32_t calcCyclesMaxRow;
+
     static int multiRowRefresh_mapIndex_CurrentRowGroups;
     static int multiRowRefresh_mapIndex_CurrentPixelGroup;
     static int multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped;
     static int multiRowRefresh_NumPanelsAlreadyMapped;
+
+    // position in the refresh buffer for each pixel in the temporary row buffers, and row offset for each temporary row
+    static uint16_t refreshBufferMap[REFRESH_BUFFER_MAP_REQUIRED ? PIXELS_PER_LATCH : 1];
+    static int refreshBufferMapRowOffsets[PHYSICAL_ROWS_PER_REFRESH_ROW];
+
+    // rows to load from the layers for each stack of panels, for each refresh row and each temporary row
+    static PanelStackRows panelStackRowLUT[MATRIX_SCAN_MOD][PHYSICAL_ROWS_PER_REFRESH_ROW][MATRIX_STACK_HEIGHT];
 };
 
 #endif
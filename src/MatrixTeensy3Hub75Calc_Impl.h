@@ -43,6 +43,24 @@ bool SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 bool SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::refreshRateChanged = true;
 
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::ditherFrame = 0;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::bitplaneSpreadLUT[16];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint16_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::bitplaneGpioLUT[64];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcCyclesPerFrame = 0;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcCyclesCurrentFrame = 0;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcCyclesMaxRow = 0;
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::multiRowRefresh_mapIndex_CurrentRowGroups = 0;
 
@@ -55,6 +73,15 @@ int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, opt
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::multiRowRefresh_NumPanelsAlreadyMapped = 0;
 
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint16_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::refreshBufferMap[REFRESH_BUFFER_MAP_REQUIRED ? PIXELS_PER_LATCH : 1];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::refreshBufferMapRowOffsets[PHYSICAL_ROWS_PER_REFRESH_ROW];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+PanelStackRows SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::panelStackRowLUT[MATRIX_SCAN_MOD][PHYSICAL_ROWS_PER_REFRESH_ROW][MATRIX_STACK_HEIGHT];
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::SmartMatrixHub75Calc(uint8_t bufferrows, rowDataStruct * rowDataBuffer) {
 }
@@ -90,6 +117,20 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
   }
 }
 
+// returns the number of CPU cycles spent filling the refresh buffer with the last complete frame
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getCalcCyclesPerFrame(void) {
+    return calcCyclesPerFrame;
+}
+
+// returns the largest number of cycles spent calculating a single row since the last call
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getMaxCalcCyclesPerRow(void) {
+    uint32_t ret = calcCyclesMaxRow;
+    calcCyclesMaxRow = 0;
+    return ret;
+}
+
 #define MAX_MATRIXCALCULATIONS_LOOPS_WITHOUT_EXIT  5
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -139,6 +180,10 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
                 templayer = templayer->nextLayer;
             }
             refreshRateChanged = false;
+
+            if(optionFlags & SM_HUB75_OPTIONS_TEMPORAL_DITHER)
+                ditherFrame++;
+
             if (brightnessChange) {
                 SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setBrightness(brightness);
                 brightnessChange = false;
@@ -149,11 +194,20 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
         // none right now
 
         // enqueue row
+        uint32_t rowStartCycles = SM_GET_CPU_CYCLE_COUNT();
         SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers(currentRow);
+        uint32_t rowCycles = SM_GET_CPU_CYCLE_COUNT() - rowStartCycles;
         SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::writeRowBuffer(currentRow);
 
-        if (++currentRow >= MATRIX_SCAN_MOD)
+        if(rowCycles > calcCyclesMaxRow)
+            calcCyclesMaxRow = rowCycles;
+        calcCyclesCurrentFrame += rowCycles;
+
+        if (++currentRow >= MATRIX_SCAN_MOD) {
             currentRow = 0;
+            calcCyclesPerFrame = calcCyclesCurrentFrame;
+            calcCyclesCurrentFrame = 0;
+        }
 
         if(dmaBufferUnderrun) {
             // if refreshrate is too high, lower - minimum set to avoid overflowing timer at low refresh rates
@@ -253,11 +307,63 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
         templayer = templayer->nextLayer;
     }
 
+#if defined(KINETISK)
+    // enable the DWT cycle counter used for profiling the calculations, in case it's not enabled already
+    ARM_DEMCR |= ARM_DEMCR_TRCENA;
+    ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+#endif
+
+    calculateBitplaneLUTs();
+    calculateRefreshBufferMap();
+    calculatePanelStackRowLUT();
+
     SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setMatrixCalculationsCallback(matrixCalculations);
     SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setMatrixUnderrunCallback(dmaBufferUnderrunCallback);
     SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::begin();
 }
 
+// Build the tables used by loadMatrixBuffersPacked() to transpose pixels into bitplanes:
+// - bitplaneSpreadLUT moves bit n of a nibble to bit 0 of byte n in a uint32_t, so six color channels shifted by 0-5 and ORed
+//   together give four 6-bit codes, one per bitplane, with bit 0=r0, 1=g0, 2=b0, 3=r1, 4=g1, 5=b1
+// - bitplaneGpioLUT maps each 6-bit code to the bytes DMA writes to the GPIO port for one pixel: just the data with the hardware
+//   clock, otherwise the data with CLK low in the low byte and with CLK high in the high byte
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calculateBitplaneLUTs(void) {
+    for(int i = 0; i < 16; i++) {
+        uint32_t spread = 0;
+        for(int bit = 0; bit < 4; bit++) {
+            if(i & (1 << bit))
+                spread |= 1UL << (bit * 8);
+        }
+        bitplaneSpreadLUT[i] = spread;
+    }
+
+    union {
+        uint8_t word;
+        struct {
+            // order of bits in word matches how GPIO connects to the display
+            uint8_t GPIO_WORD_ORDER_8BIT;
+        };
+    } o0;
+
+    for(int code = 0; code < 64; code++) {
+        o0.word = 0x00;
+        o0.hub75_r0 = (code & 0x01) ? 1 : 0;
+        o0.hub75_g0 = (code & 0x02) ? 1 : 0;
+        o0.hub75_b0 = (code & 0x04) ? 1 : 0;
+        o0.hub75_r1 = (code & 0x08) ? 1 : 0;
+        o0.hub75_g1 = (code & 0x10) ? 1 : 0;
+        o0.hub75_b1 = (code & 0x20) ? 1 : 0;
+
+        uint16_t bytes = o0.word;
+        if(DMA_UPDATES_PER_PIXEL > 1) {
+            o0.hub75_clk = 1;
+            bytes |= o0.word << 8;
+        }
+        bitplaneGpioLUT[code] = bytes;
+    }
+}
+
 #define IS_LAST_PANEL_MAP_ENTRY(x) (!x.rowOffset && !x.bufferOffset && !x.numPixels)
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -343,113 +449,36 @@ int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, opt
     return map[multiRowRefresh_mapIndex_CurrentPixelGroup].bufferOffset + multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped;
 }
 
-template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags> template <typename RGB_TEMP>
-INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers48(rowDataStruct * currentRowDataPtr, unsigned char currentRow, RGB_TEMP tempBufferType) {
-    int i;
-    int multiRowRefreshRowOffset = 0;
+// Walk through the panel map once and store the refresh buffer position for every pixel in the temporary row buffers, so
+// loadMatrixBuffers48() can read the temporary rows in order and scatter pixels to the refresh buffer with a single lookup.
+// The map covers reversed pixel blocks, the offset of each panel in the chain, and upside down stacks with C-shape stacking
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calculateRefreshBufferMap(void) {
     const int numPixelsPerTempRow = PIXELS_PER_LATCH/PHYSICAL_ROWS_PER_REFRESH_ROW;
+    int multiRowRefreshRowOffset = 0;
 
-    // static to avoid putting large buffer on the stack
-    static RGB_TEMP tempRow0[numPixelsPerTempRow];
-    static RGB_TEMP tempRow1[numPixelsPerTempRow];
-
-    int c = 0;
-
-    // multi row refresh isn't very efficient, slowing this function down by ~30% for panels that don't even need multi row refresh.  For now, only enable the code if needed
     if(MULTI_ROW_REFRESH_REQUIRED) { 
         resetMultiRowRefreshMapPosition();
     }
 
     // go through this process for each physical row that is contained in the refresh row
-    do {
-        // clear buffer to prevent garbage data showing through transparent layers
-        memset(tempRow0, 0x00, sizeof(tempRow0));
-        memset(tempRow1, 0x00, sizeof(tempRow1));
-
-        // get pixel data from layers
-        SM_Layer * templayer = SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
-        int y0, y1; // positions of the two rows we need
-        while (templayer) {
-            for (i = 0; i < MATRIX_STACK_HEIGHT; i++) {
-                // Z-shape, bottom to top
-                if (!(optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
-                        (optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    // Bottom to Top Stacking: load data buffer with top panels first, bottom panels last, as top panels are at the furthest end of the chain (initial data is shifted out the furthest)
-                    y0 = currentRow + multiRowRefreshRowOffset + i * MATRIX_PANEL_HEIGHT;
-                    y1 = y0 + ROW_PAIR_OFFSET;
-                // Z-shape, top to bottom
-                } else if (!(optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
-                           !(optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    // Top to Bottom Stacking: load data buffer with bottom panels first, top panels last, as bottom panels are at the furthest end of the chain (initial data is shifted out the furthest)
-                    y0 = currentRow + multiRowRefreshRowOffset + (MATRIX_STACK_HEIGHT - i - 1) * MATRIX_PANEL_HEIGHT;
-                    y1 = y0 + ROW_PAIR_OFFSET;
-                // C-shape, bottom to top
-                } else if ((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
-                           (optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    // C-shaped stacking: alternate direction of filling (or loading) for each matrixwidth-sized stack, stack closest to Teensy is right-side up
-                    //   swap row order from top to bottom for each stack (tempRow1 filled with top half of panel, tempRow0 filled with bottom half when upside down)
-                    //   the last stack is always right-side up, figure out orientation of other stacks based on that
-                    // Bottom to Top Stacking: load data buffer with top panels first, bottom panels last, as top panels are at the furthest end of the chain (initial data is shifted out the furthest)
-
-                    // is i the last stack, or an even number of stacks away from the last stack?
-                    if((i % 2) == ((MATRIX_STACK_HEIGHT - 1) % 2)) {
-                        y0 = currentRow + multiRowRefreshRowOffset + (i) * MATRIX_PANEL_HEIGHT;
-                        y1 = y0 + ROW_PAIR_OFFSET;
-                    } else {
-                        y1 = (MATRIX_SCAN_MOD - currentRow + multiRowRefreshRowOffset - 1) + (i) * MATRIX_PANEL_HEIGHT;
-                        y0 = y1 + ROW_PAIR_OFFSET;
-                    }
-                // C-shape, top to bottom
-                } else if ((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
-                           !(optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    // C-shaped stacking: alternate direction of filling (or loading) for each matrixwidth-sized stack, stack closest to Teensy is right-side up
-                    //   swap row order from top to bottom for each stack (tempRow1 filled with top half of panel, tempRow0 filled with bottom half when upside down)
-                    //   the last stack is always right-side up, figure out orientation of other stacks based on that
-                    // Top to Bottom Stacking: load data buffer with bottom panels first, top panels last, as bottom panels are at the furthest end of the chain (initial data is shifted out the furthest)
-
-                    // is i the last stack, or an even number of stacks away from the last stack?
-                    if((i % 2) == ((MATRIX_STACK_HEIGHT - 1) % 2)) {
-                        y0 = currentRow + multiRowRefreshRowOffset + (MATRIX_STACK_HEIGHT - i - 1) * MATRIX_PANEL_HEIGHT;
-                        y1 = y0 + ROW_PAIR_OFFSET;
-                    } else {
-                        y1 = (MATRIX_SCAN_MOD - currentRow + multiRowRefreshRowOffset - 1) + (MATRIX_STACK_HEIGHT - i - 1) * MATRIX_PANEL_HEIGHT;
-                        y0 = y1 + ROW_PAIR_OFFSET;
-                    }
-                }
-                templayer->fillRefreshRow(y0, &tempRow0[i * matrixWidth]);
-                templayer->fillRefreshRow(y1, &tempRow1[i * matrixWidth]);
-            }
-            templayer = templayer->nextLayer;        
-        }
+    for(int physicalRow = 0; physicalRow < PHYSICAL_ROWS_PER_REFRESH_ROW; physicalRow++) {
+        refreshBufferMapRowOffsets[physicalRow] = multiRowRefreshRowOffset;
 
-        union {
-            uint8_t word;
-            struct {
-                // order of bits in word matches how GPIO connects to the display
-                uint8_t GPIO_WORD_ORDER_8BIT;
-            };
-            struct {
-                uint8_t GPIO_WORD_ORDER_ADDX_8BIT;                
-            };
-        } o0;
-        
-        int i=0;
+        if(!REFRESH_BUFFER_MAP_REQUIRED)
+            break;
 
-        if(MULTI_ROW_REFRESH_REQUIRED) { 
-            // reset pixel map offset so we start filling from the first panel again
-            resetMultiRowRefreshMapPositionPixelGroupToStartOfRow();
-        }
+        int i=0;
 
         while(i < numPixelsPerTempRow) {
             int numPixelsToMap;
             int currentMapOffset;
-            bool reversePixelBlock;
+            bool reversePixelBlock = false;
 
             if(MULTI_ROW_REFRESH_REQUIRED) { 
                 // get number of pixels to go through with current pass
                 numPixelsToMap = getMultiRowRefreshNumPixelsToMap();
 
-                reversePixelBlock = false;
                 if(numPixelsToMap < 0) {
                     reversePixelBlock = true;
                     numPixelsToMap = abs(numPixelsToMap);
@@ -459,115 +488,285 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
                 currentMapOffset = getMultiRowRefreshPixelGroupOffset();
             } else {
                 numPixelsToMap = matrixWidth;
+                currentMapOffset = i;
             }
 
-            // parse through grouping of pixels, loading from temp buffer and writing to refresh buffer
+            // record where each pixel in this group is written in the refresh buffer
             for(int k=0; k < numPixelsToMap; k++) {
-                uint16_t r0, g0, b0, r1, g1, b1;
                 int ind;
 
-                int refreshBufferPosition;
-                if(MULTI_ROW_REFRESH_REQUIRED) { 
-                    if(reversePixelBlock) {
-                        refreshBufferPosition = currentMapOffset-k;
-                    } else {
-                        refreshBufferPosition = currentMapOffset+k;
-                    }
-                } else {
-                    refreshBufferPosition = i+k;
-                }
-
                 // for upside down stacks, flip order
                 int currentStack = i/matrixWidth;
-                if((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) && !((currentStack % 2) == ((MATRIX_STACK_HEIGHT - 1) % 2))) {
+                if(isPanelStackReversed(currentStack, MATRIX_STACK_HEIGHT, optionFlags)) {
                     // reverse order of this stack's data if it's reversed (if currentStack is the last stack, or an even number of stacks away from the last stack)
                     ind = (currentStack*matrixWidth) + (matrixWidth-1) - ((i+k)%matrixWidth);
                 } else {
                     // load data to buffer in normal order
                     ind = i+k;
                 }
-                r0 = tempRow0[ind].red;
-                g0 = tempRow0[ind].green;
-                b0 = tempRow0[ind].blue;
-                r1 = tempRow1[ind].red;
-                g1 = tempRow1[ind].green;
-                b1 = tempRow1[ind].blue;
 
-                // loop through each bitplane in the current pixel's RGB values and format the bits to match the FlexIO pin configuration
-                int sizeOfSourceColor = (sizeof(RGB_TEMP) <= 3) ? 8 : 16;
-                uint8_t shift = (sizeOfSourceColor - COLOR_DEPTH_BITS);
-                uint16_t mask = 1 << shift;
+                refreshBufferMap[(physicalRow * numPixelsPerTempRow) + ind] = reversePixelBlock ? (currentMapOffset - k) : (currentMapOffset + k);
+            }
+            i += numPixelsToMap; // keep track of current position on this temp buffer
+            if(MULTI_ROW_REFRESH_REQUIRED) { 
+                advanceMultiRowRefreshMapToNextPixelGroup();
+            }
+        }
 
-                for (int bitindex = 0; bitindex < COLOR_DEPTH_BITS; bitindex++) {
-                    o0.word = 0x00;
+        if(MULTI_ROW_REFRESH_REQUIRED) { 
+            advanceMultiRowRefreshMapToNextRow();
+            multiRowRefreshRowOffset = getMultiRowRefreshRowOffset();
+        }
+    }
+}
+
+// Store the rows of the image to load for each stack of panels, for every refresh row and multi-row refresh offset, so
+// loadMatrixBuffers48() doesn't need to work out the stacking and orientation of each panel while refreshing
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calculatePanelStackRowLUT(void) {
+    for(int currentRow = 0; currentRow < MATRIX_SCAN_MOD; currentRow++) {
+        for(int physicalRow = 0; physicalRow < PHYSICAL_ROWS_PER_REFRESH_ROW; physicalRow++) {
+            for(int i = 0; i < MATRIX_STACK_HEIGHT; i++) {
+                panelStackRowLUT[currentRow][physicalRow][i] = getPanelStackRows(currentRow + refreshBufferMapRowOffsets[physicalRow], i,
+                    MATRIX_STACK_HEIGHT, MATRIX_PANEL_HEIGHT, ROW_PAIR_OFFSET, optionFlags);
+            }
+        }
+    }
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags> template <typename RGB_TEMP>
+INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers48(rowDataStruct * currentRowDataPtr, unsigned char currentRow, RGB_TEMP tempBufferType) {
+    int i;
+    const int numPixelsPerTempRow = PIXELS_PER_LATCH/PHYSICAL_ROWS_PER_REFRESH_ROW;
+
+    // static to avoid putting large buffer on the stack
+    static RGB_TEMP tempRow0[numPixelsPerTempRow];
+    static RGB_TEMP tempRow1[numPixelsPerTempRow];
 
+    // go through this process for each physical row that is contained in the refresh row
+    for(int physicalRow = 0; physicalRow < PHYSICAL_ROWS_PER_REFRESH_ROW; physicalRow++) {
+        // get pixel data from layers, loading a row from each stack of panels, see calculatePanelStackRowLUT()
+        // the buffers are only cleared where no opaque layer covers the row, see SM_Layer::fillRefreshRowFromLayers()
+        const PanelStackRows * stackRows = panelStackRowLUT[currentRow][physicalRow];
+        for (i = 0; i < MATRIX_STACK_HEIGHT; i++) {
+            SM_Layer::fillRefreshRowFromLayers(SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer, stackRows[i].y0, &tempRow0[i * matrixWidth], matrixWidth);
+            SM_Layer::fillRefreshRowFromLayers(SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer, stackRows[i].y1, &tempRow1[i * matrixWidth], matrixWidth);
+        }
+
+        union {
+            uint8_t word;
+            struct {
+                // order of bits in word matches how GPIO connects to the display
+                uint8_t GPIO_WORD_ORDER_8BIT;
+            };
+            struct {
+                uint8_t GPIO_WORD_ORDER_ADDX_8BIT;                
+            };
+        } o0;
+
+        // position in the refresh buffer for each pixel in the temp buffer, see calculateRefreshBufferMap()
+        const uint16_t * rowMap = &refreshBufferMap[REFRESH_BUFFER_MAP_REQUIRED ? (physicalRow * numPixelsPerTempRow) : 0];
+
+        // parse through the temp buffer in order, loading pixels and writing them to the refresh buffer
+        for(int ind=0; ind < numPixelsPerTempRow; ind++) {
+            uint16_t r0, g0, b0, r1, g1, b1;
+
+            int refreshBufferPosition = REFRESH_BUFFER_MAP_REQUIRED ? rowMap[ind] : ind;
+
+            r0 = tempRow0[ind].red;
+            g0 = tempRow0[ind].green;
+            b0 = tempRow0[ind].blue;
+            r1 = tempRow1[ind].red;
+            g1 = tempRow1[ind].green;
+            b1 = tempRow1[ind].blue;
+
+            // loop through each bitplane in the current pixel's RGB values and format the bits to match the FlexIO pin configuration
+            int sizeOfSourceColor = (sizeof(RGB_TEMP) <= 3) ? 8 : 16;
+            uint8_t shift = (sizeOfSourceColor - COLOR_DEPTH_BITS);
+            uint16_t mask = 1 << shift;
+
+            if(optionFlags & SM_HUB75_OPTIONS_TEMPORAL_DITHER) {
+                // the pattern only needs to be different for neighboring pixels, so the position in the temp row and the physical row
+                // are used instead of screen coordinates, the second row of the pair is offset to not use the same pattern row
+                int ditherY = (currentRow * PHYSICAL_ROWS_PER_REFRESH_ROW) + physicalRow;
+                uint16_t threshold0 = hub75DitherThreshold(ind, ditherY, ditherFrame, shift);
+                uint16_t threshold1 = hub75DitherThreshold(ind, ditherY + 2, ditherFrame, shift);
+                r0 = hub75DitherChannel(r0, threshold0);
+                g0 = hub75DitherChannel(g0, threshold0);
+                b0 = hub75DitherChannel(b0, threshold0);
+                r1 = hub75DitherChannel(r1, threshold1);
+                g1 = hub75DitherChannel(g1, threshold1);
+                b1 = hub75DitherChannel(b1, threshold1);
+            }
+
+            for (int bitindex = 0; bitindex < COLOR_DEPTH_BITS; bitindex++) {
+                o0.word = 0x00;
+
+                if (r0 & mask)
+                    o0.hub75_r0 = 1;
+                if (g0 & mask)
+                    o0.hub75_g0 = 1;
+                if (b0 & mask)
+                    o0.hub75_b0 = 1;
+                if (r1 & mask)
+                    o0.hub75_r1 = 1;
+                if (g1 & mask)
+                    o0.hub75_g1 = 1;
+                if (b1 & mask)
+                    o0.hub75_b1 = 1;
+
+                if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE) {
+                    // HUB12 format inverts the data (assume we're only using R1 for now)
                     if (r0 & mask)
-                        o0.hub75_r0 = 1;
-                    if (g0 & mask)
-                        o0.hub75_g0 = 1;
-                    if (b0 & mask)
-                        o0.hub75_b0 = 1;
-                    if (r1 & mask)
-                        o0.hub75_r1 = 1;
-                    if (g1 & mask)
-                        o0.hub75_g1 = 1;
-                    if (b1 & mask)
-                        o0.hub75_b1 = 1;
-
-                    if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE) {
-                        // HUB12 format inverts the data (assume we're only using R1 for now)
-                        if (r0 & mask)
-                            o0.hub75_r0 = 0;
-                        else
-                            o0.hub75_r0 = 1;                        
-                    }               
-
-                    mask <<= 1;
-
-                    // store these pixel bits in the rowDataBuffer, leaving the initial pixels as padding
-                    currentRowDataPtr->rowbits[bitindex].data[((refreshBufferPosition)*DMA_UPDATES_PER_CLOCK)] = o0.word;
+                        o0.hub75_r0 = 0;
+                    else
+                        o0.hub75_r0 = 1;                        
+                }               
+
+                mask <<= 1;
+
+                // store these pixel bits in the rowDataBuffer, leaving the initial pixels as padding
+                currentRowDataPtr->rowbits[bitindex].data[((refreshBufferPosition)*DMA_UPDATES_PER_PIXEL)] = o0.word;
+                // with the hardware clock the data is written once, otherwise again with CLK high
+                if(DMA_UPDATES_PER_PIXEL > 1) {
                     o0.hub75_clk = 1;
-                    currentRowDataPtr->rowbits[bitindex].data[((refreshBufferPosition)*DMA_UPDATES_PER_CLOCK)+1] = o0.word;
+                    currentRowDataPtr->rowbits[bitindex].data[((refreshBufferPosition)*DMA_UPDATES_PER_PIXEL)+1] = o0.word;
                 }
             }
-            i += numPixelsToMap; // keep track of current position on this temp buffer
-            if(MULTI_ROW_REFRESH_REQUIRED) { 
-                advanceMultiRowRefreshMapToNextPixelGroup();
-            }
         }
+    }
+}
 
-        for (int bitindex = 0; bitindex < COLOR_DEPTH_BITS; bitindex++)
-            currentRowDataPtr->rowbits[bitindex].rowAddress = currentRow;
+// Same output as loadMatrixBuffers48(), for panels where the temporary row is in the same order as the refresh buffer (see
+// REFRESH_BUFFER_MAP_REQUIRED).  Instead of setting the GPIO bits one bitfield at a time for each bitplane, the bitplanes of each
+// pixel are transposed with lookup tables (see calculateBitplaneLUTs()), and consecutive pixels are combined into one 32-bit store
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags> template <typename RGB_TEMP>
+INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffersPacked(rowDataStruct * currentRowDataPtr, unsigned char currentRow, RGB_TEMP tempBufferType) {
+    int i;
+    const int numPixelsPerTempRow = PIXELS_PER_LATCH;
+    const int pixelsPerWord = sizeof(uint32_t) / DMA_UPDATES_PER_PIXEL;
 
-#ifdef ADDX_UPDATE_ON_DATA_PINS
-        o0.word = 0x00000000;
-        o0.hub75_addx0 = (currentRow & 0x01) ? 1 : 0;
-        o0.hub75_addx1 = (currentRow & 0x02) ? 1 : 0;
-        o0.hub75_addx2 = (currentRow & 0x04) ? 1 : 0;
-        o0.hub75_addx3 = (currentRow & 0x08) ? 1 : 0;
-        o0.hub75_addx4 = (currentRow & 0x10) ? 1 : 0;
-
-        for(int bitindex=0; bitindex<COLOR_DEPTH_BITS; bitindex++) {
-            currentRowDataPtr->rowbits[bitindex].rowAddress = o0.word;
+    // static to avoid putting large buffer on the stack
+    static RGB_TEMP tempRow0[numPixelsPerTempRow];
+    static RGB_TEMP tempRow1[numPixelsPerTempRow];
+
+    // get pixel data from layers, loading a row from each stack of panels, see calculatePanelStackRowLUT()
+    // the buffers are only cleared where no opaque layer covers the row, see SM_Layer::fillRefreshRowFromLayers()
+    const PanelStackRows * stackRows = panelStackRowLUT[currentRow][0];
+    for (i = 0; i < MATRIX_STACK_HEIGHT; i++) {
+        SM_Layer::fillRefreshRowFromLayers(SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer, stackRows[i].y0, &tempRow0[i * matrixWidth], matrixWidth);
+        SM_Layer::fillRefreshRowFromLayers(SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer, stackRows[i].y1, &tempRow1[i * matrixWidth], matrixWidth);
+    }
+
+    // bitplane n is bit (shift + n) of each color channel, nibbles below shift aren't needed
+    const int sizeOfSourceColor = (sizeof(RGB_TEMP) <= 3) ? 8 : 16;
+    const int shift = (sizeOfSourceColor - COLOR_DEPTH_BITS);
+    const int firstNibble = shift / 4;
+
+    for(int ind = 0; ind < numPixelsPerTempRow; ind += pixelsPerWord) {
+        int numPixels = numPixelsPerTempRow - ind;
+        if(numPixels > pixelsPerWord)
+            numPixels = pixelsPerWord;
+
+        // codes[n] holds bit n of all six color channels of one pixel
+        union {
+            uint32_t nibbles[4];
+            uint8_t codes[16];
+        } bitplanes[pixelsPerWord];
+
+        for(int p = 0; p < numPixels; p++) {
+            uint16_t r0 = tempRow0[ind + p].red;
+            uint16_t g0 = tempRow0[ind + p].green;
+            uint16_t b0 = tempRow0[ind + p].blue;
+            uint16_t r1 = tempRow1[ind + p].red;
+            uint16_t g1 = tempRow1[ind + p].green;
+            uint16_t b1 = tempRow1[ind + p].blue;
+
+            if(optionFlags & SM_HUB75_OPTIONS_TEMPORAL_DITHER) {
+                int ditherX = ind + p;
+                uint16_t threshold0 = hub75DitherThreshold(ditherX, currentRow, ditherFrame, shift);
+                uint16_t threshold1 = hub75DitherThreshold(ditherX, currentRow + 2, ditherFrame, shift);
+                r0 = hub75DitherChannel(r0, threshold0);
+                g0 = hub75DitherChannel(g0, threshold0);
+                b0 = hub75DitherChannel(b0, threshold0);
+                r1 = hub75DitherChannel(r1, threshold1);
+                g1 = hub75DitherChannel(g1, threshold1);
+                b1 = hub75DitherChannel(b1, threshold1);
+            }
+
+            // HUB12 format inverts the data (assume we're only using R1 for now)
+            if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE)
+                r0 = ~r0;
+
+            for(int nibble = firstNibble; nibble < sizeOfSourceColor / 4; nibble++) {
+                int s = nibble * 4;
+                bitplanes[p].nibbles[nibble] = bitplaneSpreadLUT[(r0 >> s) & 0x0f]        | (bitplaneSpreadLUT[(g0 >> s) & 0x0f] << 1) |
+                                              (bitplaneSpreadLUT[(b0 >> s) & 0x0f] << 2) | (bitplaneSpreadLUT[(r1 >> s) & 0x0f] << 3) |
+                                              (bitplaneSpreadLUT[(g1 >> s) & 0x0f] << 4) | (bitplaneSpreadLUT[(b1 >> s) & 0x0f] << 5);
+            }
         }
-#endif
 
-        if(MULTI_ROW_REFRESH_REQUIRED) { 
-            c += numPixelsPerTempRow; // keep track of cumulative number of pixels filled in refresh buffer before this temp buffer
+        // combine the GPIO bytes for all pixels into one word per bitplane, the byte order in memory is the DMA order
+        for(int bitindex = 0; bitindex < COLOR_DEPTH_BITS; bitindex++) {
+            uint8_t * data = &currentRowDataPtr->rowbits[bitindex].data[ind * DMA_UPDATES_PER_PIXEL];
 
-            advanceMultiRowRefreshMapToNextRow();
-            multiRowRefreshRowOffset = getMultiRowRefreshRowOffset();
+            if(numPixels == pixelsPerWord) {
+                uint32_t word = 0;
+                for(int p = 0; p < pixelsPerWord; p++)
+                    word |= (uint32_t)bitplaneGpioLUT[bitplanes[p].codes[shift + bitindex]] << (p * DMA_UPDATES_PER_PIXEL * 8);
+                // rowBitStruct.data is only 2-byte aligned, Cortex-M4 supports unaligned word stores and memcpy() handles Cortex-M0+
+                memcpy(data, &word, sizeof(word));
+            } else {
+                // the last pixels in rows that aren't a multiple of pixelsPerWord are stored a byte at a time
+                for(int p = 0; p < numPixels; p++) {
+                    uint16_t bytes = bitplaneGpioLUT[bitplanes[p].codes[shift + bitindex]];
+                    for(int j = 0; j < DMA_UPDATES_PER_PIXEL; j++)
+                        data[(p * DMA_UPDATES_PER_PIXEL) + j] = bytes >> (j * 8);
+                }
+            }
         }
-    } while (MULTI_ROW_REFRESH_REQUIRED ? (multiRowRefreshRowOffset > 0) : 0);
+    }
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers(unsigned char currentRow) {
     rowDataStruct * currentRowDataPtr = SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getNextRowBufferPtr();
 
-    // same function supports any refresh depth up to 48, choose between rgb24 and rgb48 for temporary storage to save RAM
-    if(COLOR_DEPTH_BITS <= 8)
-        loadMatrixBuffers48(currentRowDataPtr, currentRow, rgb24(0,0,0));
-    else
-        loadMatrixBuffers48(currentRowDataPtr, currentRow, rgb48(0,0,0));
+    // same functions support any refresh depth up to 48, choose between rgb24 and rgb48 for temporary storage to save RAM
+    // dithering needs the bits below the refresh depth, so always uses rgb48
+    // pixels can only be packed into words if they don't need to be scattered through the refresh buffer
+    if(COLOR_DEPTH_BITS <= 8 && !(optionFlags & SM_HUB75_OPTIONS_TEMPORAL_DITHER)) {
+        if(REFRESH_BUFFER_MAP_REQUIRED)
+            loadMatrixBuffers48(currentRowDataPtr, currentRow, rgb24(0,0,0));
+        else
+            loadMatrixBuffersPacked(currentRowDataPtr, currentRow, rgb24(0,0,0));
+    } else {
+        if(REFRESH_BUFFER_MAP_REQUIRED)
+            loadMatrixBuffers48(currentRowDataPtr, currentRow, rgb48(0,0,0));
+        else
+            loadMatrixBuffersPacked(currentRowDataPtr, currentRow, rgb48(0,0,0));
+    }
+
+    for (int bitindex = 0; bitindex < COLOR_DEPTH_BITS; bitindex++)
+        currentRowDataPtr->rowbits[bitindex].rowAddress = currentRow;
+
+#ifdef ADDX_UPDATE_ON_DATA_PINS
+    union {
+        uint8_t word;
+        struct {
+            uint8_t GPIO_WORD_ORDER_ADDX_8BIT;
+        };
+    } o0;
+
+    o0.word = 0x00000000;
+    o0.hub75_addx0 = (currentRow & 0x01) ? 1 : 0;
+    o0.hub75_addx1 = (currentRow & 0x02) ? 1 : 0;
+    o0.hub75_addx2 = (currentRow & 0x04) ? 1 : 0;
+    o0.hub75_addx3 = (currentRow & 0x08) ? 1 : 0;
+    o0.hub75_addx4 = (currentRow & 0x10) ? 1 : 0;
+
+    for(int bitindex=0; bitindex<COLOR_DEPTH_BITS; bitindex++) {
+        currentRowDataPtr->rowbits[bitindex].rowAddress = o0.word;
+    }
+#endif
 }
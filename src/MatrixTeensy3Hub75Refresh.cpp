@@ -37,4 +37,9 @@
     DMAChannel dmaUpdateTimer(false);
     DMAChannel dmaClockOutData(false);
     DMAChannel dmaClockOutDataApa(false);
+    #if defined(__MK64FX512__) || defined(__MK66FX1M0__)
+        // used with SM_HUB75_OPTIONS_T3_HARDWARE_CLK
+        DMAChannel dmaHardwareClkStart(false);
+        DMAChannel dmaHardwareClkStop(false);
+    #endif
 #endif
@@ -24,8 +24,20 @@
 #ifndef SmartMatrixHUB75Refresh_h
 #define SmartMatrixHUB75Refresh_h
 
+// CLK is on PORTD.1, which can only be driven by a timer on chips with FTM3
+#if defined(__MK64FX512__) || defined(__MK66FX1M0__)
+    #define T3_HARDWARE_CLK_SUPPORTED   1
+#else
+    #define T3_HARDWARE_CLK_SUPPORTED   0
+#endif
+
+// with SM_HUB75_OPTIONS_T3_HARDWARE_CLK, DMA only writes the data for each pixel and the timer generates both clock edges
+#define DMA_UPDATES_PER_PIXEL ((optionFlags & SM_HUB75_OPTIONS_T3_HARDWARE_CLK) ? 1 : DMA_UPDATES_PER_CLOCK)
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 class SmartMatrixHub75Refresh {
+    static_assert(T3_HARDWARE_CLK_SUPPORTED || !(optionFlags & SM_HUB75_OPTIONS_T3_HARDWARE_CLK), "SM_HUB75_OPTIONS_T3_HARDWARE_CLK needs FTM3, only available on Teensy 3.5 and 3.6");
+
 public:
     struct timerpair {
         uint16_t timer_oe;
@@ -46,7 +58,7 @@ public:
 #endif
 
     struct rowBitStruct {
-        uint8_t data[PIXELS_PER_LATCH * DMA_UPDATES_PER_CLOCK];
+        uint8_t data[PIXELS_PER_LATCH * DMA_UPDATES_PER_PIXEL];
         uint8_t rowAddress; // must be directly after data - DMA transfers data[] + rowAddress continuous
         timerpair timerValues;
 #ifndef ADDX_UPDATE_ON_DATA_PINS
@@ -100,6 +112,8 @@ private:
 
     static timerpair timerLUT[LATCHES_PER_ROW];
     static timerpair timerPairIdle;
+    static uint32_t hardwareClkStart;
+    static uint32_t hardwareClkStop;
 #ifndef ADDX_UPDATE_ON_DATA_PINS
     static addresspair addressLUT[MATRIX_SCAN_MOD];
     static gpiopair gpiosync;
@@ -107,7 +121,7 @@ private:
     static matrix_calc_callback matrixCalcCallback;
     static matrix_underrun_callback matrixUnderrunCallback;
 
-    static CircularBuffer_SM dmaBuffer;
+    static SpscRing_SM dmaBuffer;
 };
 
 #endif
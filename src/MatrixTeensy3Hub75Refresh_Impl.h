@@ -46,7 +46,9 @@
 #define LATCH_TIMER_PULSE_WIDTH_TICKS   NS_TO_TICKS(LATCH_TIMER_PULSE_WIDTH_NS)
 #define TICKS_PER_ROW                   (TIMER_FREQUENCY/refreshRate/MATRIX_SCAN_MOD)
 #define IDEAL_MSB_BLOCK_TICKS           (TICKS_PER_ROW/2) * (1<<LATCHES_PER_ROW) / ((1<<LATCHES_PER_ROW) - 1)
-#define MIN_BLOCK_PERIOD_NS             (LATCH_TO_CLK_DELAY_NS + ((PANEL_32_PIXELDATA_TRANSFER_MAXIMUM_NS*PIXELS_PER_LATCH)/32))
+// the hardware clock shifts one extra byte that isn't clocked in, see begin()
+#define PIXELDATA_TRANSFER_MAXIMUM_NS   ((optionFlags & SM_HUB75_OPTIONS_T3_HARDWARE_CLK) ? (HARDWARE_CLK_PERIOD_NS*(PIXELS_PER_LATCH + 1)) : ((PANEL_32_PIXELDATA_TRANSFER_MAXIMUM_NS*PIXELS_PER_LATCH)/32))
+#define MIN_BLOCK_PERIOD_NS             (LATCH_TO_CLK_DELAY_NS + PIXELDATA_TRANSFER_MAXIMUM_NS)
 #define MIN_BLOCK_PERIOD_TICKS          NS_TO_TICKS(MIN_BLOCK_PERIOD_NS)
 
 // slower refresh rates require larger timer values - get the min refresh rate from the largest MSB value that will fit in the timer (round up)
@@ -54,6 +56,11 @@
 
 #define TIMER_REGISTERS_TO_UPDATE   2
 
+// FTM3 runs at F_BUS with no prescale, DMA writes the pixel data early in the period, and CLK rises 3/4 of the way through
+#define HARDWARE_CLK_PERIOD_TICKS       (uint32_t)(F_BUS * (HARDWARE_CLK_PERIOD_NS / 1000000000.0))
+#define HARDWARE_CLK_DATA_TICKS         1
+#define HARDWARE_CLK_RISING_EDGE_TICKS  (HARDWARE_CLK_PERIOD_TICKS * 3 / 4)
+
 #if defined(KINETISL)
     extern DMAChannel dmaClockOutData;
     extern DMAChannel dmaClockOutData2;
@@ -64,6 +71,10 @@
     #endif
     extern DMAChannel dmaUpdateTimer;
     extern DMAChannel dmaClockOutData;
+    #if T3_HARDWARE_CLK_SUPPORTED
+        extern DMAChannel dmaHardwareClkStart;
+        extern DMAChannel dmaHardwareClkStop;
+    #endif
 #endif
 
 #if defined(KINETISL)
@@ -77,7 +88,7 @@ template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char pan
 void rowCalculationISR(void);
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-CircularBuffer_SM SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer;
+SpscRing_SM SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer;
 
 // dmaBufferNumRows = the size of the buffer that DMA pulls from to refresh the display
 // must be minimum 2 rows so one can be updated while the other is refreshed
@@ -105,6 +116,12 @@ typename SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelT
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 typename SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::timerpair SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::timerPairIdle;
 
+// values written to FTM3 by DMA to start and stop the hardware clock
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::hardwareClkStart;
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::hardwareClkStop;
+
 /*
     THIS IS NOW OUT OF DATE: data is now arranged linearly sorted first by pixels, then by color bit
   buffer contains:
@@ -142,7 +159,7 @@ SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, opti
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 bool SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::isRowBufferFree(void) {
-    if(cbIsFull(&dmaBuffer))
+    if(dmaBuffer.isFull())
         return false;
     else
         return true;
@@ -150,7 +167,7 @@ bool SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType,
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 typename SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rowDataStruct * SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getNextRowBufferPtr(void) {
-    return &(matrixUpdateRows[cbGetNextWrite(&dmaBuffer)]);
+    return &(matrixUpdateRows[dmaBuffer.getNextWrite()]);
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -173,7 +190,7 @@ void SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType,
         currentRowDataPtr->rowbits[i].timerValues.timer_oe = timerLUT[i].timer_oe;
     }
 
-    cbWrite(&dmaBuffer);
+    dmaBuffer.write();
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -189,7 +206,7 @@ void SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType,
     FTM1_SC = FTM_SC_CLKS(0) | FTM_SC_PS(LATCH_TIMER_PRESCALE);
 
     // point DMA addresses to the next buffer
-    int currentRow = cbGetNextRead(&dmaBuffer);
+    int currentRow = dmaBuffer.getNextRead();
 #ifndef ADDX_UPDATE_ON_DATA_PINS
     dmaUpdateAddress.TCD->SADDR = &(SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateRows[0].rowbits[0].addressValues);
 #endif
@@ -297,7 +314,7 @@ void SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType,
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::begin(void) {
-    cbInit(&dmaBuffer, dmaBufferNumRows);
+    dmaBuffer.init(dmaBufferNumRows);
 
 #ifndef ADDX_UPDATE_ON_DATA_PINS
     int i;
@@ -457,6 +474,9 @@ void SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType,
     rowBitStructBytesToShift = sizeof(SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateRows[0].rowbits[0].data) + ADDX_UPDATE_BEFORE_LATCH_BYTES;
 #else
     rowBitStructBytesToShift = sizeof(SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateRows[0].rowbits[0].data);
+    // the hardware clock is stopped by the DMA request for the byte after the data, before it gets clocked in, so rowAddress is written to the port but ignored
+    if(optionFlags & SM_HUB75_OPTIONS_T3_HARDWARE_CLK)
+        rowBitStructBytesToShift++;
 #endif
 
 #if defined(KINETISL)
@@ -561,6 +581,12 @@ void SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType,
 #endif
     dmaUpdateTimer.begin(false);
     dmaClockOutData.begin(false);
+#if T3_HARDWARE_CLK_SUPPORTED
+    if(optionFlags & SM_HUB75_OPTIONS_T3_HARDWARE_CLK) {
+        dmaHardwareClkStart.begin(false);
+        dmaHardwareClkStop.begin(false);
+    }
+#endif
 
 #ifndef ADDX_UPDATE_ON_DATA_PINS
 #define ADDRESS_ARRAY_REGISTERS_TO_UPDATE   2
@@ -627,6 +653,11 @@ void SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType,
     dmaUpdateTimer.TCD->BITER_ELINKNO = 1;
     // link dmaClockOutData channel, enable major channel-to-channel linking, don't clear enable after major loop complete
     dmaUpdateTimer.TCD->CSR = (dmaClockOutData.channel << 8) | (1 << 5);
+#if T3_HARDWARE_CLK_SUPPORTED
+    // with the hardware clock, link dmaHardwareClkStart instead, and the clock triggers dmaClockOutData
+    if(optionFlags & SM_HUB75_OPTIONS_T3_HARDWARE_CLK)
+        dmaUpdateTimer.TCD->CSR = (dmaHardwareClkStart.channel << 8) | (1 << 5);
+#endif
     dmaUpdateTimer.triggerAtHardwareEvent(DMAMUX_SOURCE_LATCH_FALLING_EDGE);
 
     // this is the number of bytes in the gap between each sequential rowBitStruct.data arrays
@@ -639,7 +670,7 @@ void SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType,
     dmaClockOutData.TCD->SLAST = 0;
     dmaClockOutData.TCD->ATTR = DMA_TCD_ATTR_SSIZE(0) | DMA_TCD_ATTR_DSIZE(0);
     // after each minor loop, apply no offset to source data, it's pointing to the next buffer already
-    // clock out (PIXELS_PER_LATCH * DMA_UPDATES_PER_CLOCK + ADDX_UPDATE_BEFORE_LATCH_BYTES) number of bytes per loop
+    // clock out (PIXELS_PER_LATCH * DMA_UPDATES_PER_PIXEL + ADDX_UPDATE_BEFORE_LATCH_BYTES) number of bytes per loop
     dmaClockOutData.TCD->NBYTES_MLOFFYES = DMA_TCD_NBYTES_SMLOE |
                                 ((rowBitStructDataOffset << 10) & DMA_TCD_MLOFF_MASK) |
                                 rowBitStructBytesToShift;
@@ -656,8 +687,74 @@ void SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType,
     // also enable for now, until it can be selectively enabled for higher clock speeds (140MHz+) where the data rate is too high for the panel
     dmaClockOutData.TCD->CSR |= (0x02 << 14);
 
+#if T3_HARDWARE_CLK_SUPPORTED
+    if(optionFlags & SM_HUB75_OPTIONS_T3_HARDWARE_CLK) {
+        // dmaClockOutData - instead of a whole latch per minor loop, load one byte into GPIOD_PDOR for each request from FTM3, and skip
+        // the gap to the next rowBitStruct.data array at the end of each major loop.  The last byte is written after the last CLK edge
+        // for the data, and completing the major loop links dmaHardwareClkStop, which stops the clock before that byte is clocked in.
+        // Requests are paced by the clock, so bandwidth control isn't needed
+        dmaClockOutData.TCD->SLAST = rowBitStructDataOffset;
+        dmaClockOutData.TCD->NBYTES_MLOFFNO = 1;
+        dmaClockOutData.TCD->CITER_ELINKNO = rowBitStructBytesToShift;
+        dmaClockOutData.TCD->BITER_ELINKNO = rowBitStructBytesToShift;
+        dmaClockOutData.TCD->CSR = (dmaHardwareClkStop.channel << 8) | (1 << 5);
+        dmaClockOutData.triggerAtHardwareEvent(DMAMUX_SOURCE_FTM3_CH0);
+
+        // dmaHardwareClkStart - linked from dmaUpdateTimer on latch falling edge, start FTM3
+        // only use single major loop, never disable channel
+        hardwareClkStart = FTM_SC_CLKS(1) | FTM_SC_PS(0);
+        dmaHardwareClkStart.TCD->SADDR = &hardwareClkStart;
+        dmaHardwareClkStart.TCD->SOFF = 0;
+        dmaHardwareClkStart.TCD->SLAST = 0;
+        dmaHardwareClkStart.TCD->ATTR = DMA_TCD_ATTR_SSIZE(2) | DMA_TCD_ATTR_DSIZE(2);
+        dmaHardwareClkStart.TCD->NBYTES_MLOFFNO = sizeof(uint32_t);
+        dmaHardwareClkStart.TCD->DADDR = &FTM3_SC;
+        dmaHardwareClkStart.TCD->DOFF = 0;
+        dmaHardwareClkStart.TCD->DLASTSGA = 0;
+        dmaHardwareClkStart.TCD->CITER_ELINKNO = 1;
+        dmaHardwareClkStart.TCD->BITER_ELINKNO = 1;
+        dmaHardwareClkStart.TCD->CSR = 0;
+
+        // dmaHardwareClkStop - linked from dmaClockOutData when a latch's data is done, stop FTM3 and reset its counter (writing any value to CNT resets it)
+        // major loop is one row, int after major loop is complete
+        hardwareClkStop = 0;
+        dmaHardwareClkStop.TCD->SADDR = &hardwareClkStop;
+        dmaHardwareClkStop.TCD->SOFF = 0;
+        dmaHardwareClkStop.TCD->SLAST = 0;
+        dmaHardwareClkStop.TCD->ATTR = DMA_TCD_ATTR_SSIZE(2) | DMA_TCD_ATTR_DSIZE(2);
+        // Destination Minor Loop Offset Enabled - put DADDR back to FTM3_SC after each minor loop
+        dmaHardwareClkStop.TCD->NBYTES_MLOFFYES = DMA_TCD_NBYTES_DMLOE |
+                                    (((2 * ((int)&FTM3_SC - (int)&FTM3_CNT)) << 10) & DMA_TCD_MLOFF_MASK) |
+                                    (2 * sizeof(uint32_t));
+        dmaHardwareClkStop.TCD->DADDR = &FTM3_SC;
+        dmaHardwareClkStop.TCD->DOFF = (int)&FTM3_CNT - (int)&FTM3_SC;
+        dmaHardwareClkStop.TCD->DLASTSGA = 2 * ((int)&FTM3_SC - (int)&FTM3_CNT);
+        dmaHardwareClkStop.TCD->CITER_ELINKNO = LATCHES_PER_ROW;
+        dmaHardwareClkStop.TCD->BITER_ELINKNO = LATCHES_PER_ROW;
+        dmaHardwareClkStop.TCD->CSR = DMA_TCD_CSR_INTMAJOR;
+
+        // enable a done interrupt when all DMA operations are complete
+        dmaHardwareClkStop.attachInterrupt(rowShiftCompleteISR<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>);
+
+        // setup FTM3, this takes over FTM3 from analogWrite()
+        FTM3_SC = 0;
+        FTM3_CNT = 0;
+        FTM3_MOD = HARDWARE_CLK_PERIOD_TICKS - 1;
+
+        // channel 0 is a software compare (no output), requesting DMA early in each period
+        FTM3_C0SC = FTM_CSC_MSA | FTM_CSC_CHIE | FTM_CSC_DMA;
+        FTM3_C0V = HARDWARE_CLK_DATA_TICKS;
+        // channel 1 outputs CLK with low-true edge-aligned PWM: low from the start of each period, rising at the compare
+        FTM3_C1SC = FTM_CSC_MSB | FTM_CSC_ELSA;
+        FTM3_C1V = HARDWARE_CLK_RISING_EDGE_TICKS;
+
+        ENABLE_HARDWARE_CLK_OUTPUT();
+    }
+#endif
+
     // enable a done interrupt when all DMA operations are complete
-    dmaClockOutData.attachInterrupt(rowShiftCompleteISR<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>);
+    if(!(optionFlags & SM_HUB75_OPTIONS_T3_HARDWARE_CLK))
+        dmaClockOutData.attachInterrupt(rowShiftCompleteISR<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>);
 
     // enable additional dma interrupt used as software interrupt
     NVIC_SET_PRIORITY(IRQ_DMA_CH0 + dmaUpdateTimer.channel, ROW_CALCULATION_ISR_PRIORITY);
@@ -702,12 +799,12 @@ void rowBitShiftCompleteISR(void) {
         currentLatchBit = 0;
 
         // done with previous row, mark it as read
-        cbRead(&SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer);
+        SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.read();
     }
 
     if(currentLatchBit == 0) {
         // need new row, see if it is available yet
-        if(cbIsEmpty(&SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer)) {
+        if(SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.isEmpty()) {
             // new row is not available, handle DMA underrun
 #ifdef DEBUG_PINS_ENABLED
             digitalWriteFast(DEBUG_PIN_1, LOW); // oscilloscope trigger
@@ -735,7 +832,7 @@ void rowBitShiftCompleteISR(void) {
 
         } else {
             // get next row to draw to display
-            currentRow = cbGetNextRead(&SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer);
+            currentRow = SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.getNextRead();
         }
     }
 
@@ -791,9 +888,9 @@ void rowShiftCompleteISR(void) {
     digitalWriteFast(DEBUG_PIN_1, HIGH); // oscilloscope trigger
 #endif
     // done with previous row, mark it as read
-    cbRead(&SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer);
+    SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.read();
 
-    if(cbIsEmpty(&SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer)) {
+    if(SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.isEmpty()) {
 #ifdef DEBUG_PINS_ENABLED
         digitalWriteFast(DEBUG_PIN_1, LOW); // oscilloscope trigger
 #endif
@@ -813,7 +910,7 @@ void rowShiftCompleteISR(void) {
 #endif
     } else {
         // get next row to draw to display and update DMA pointers
-        int currentRow = cbGetNextRead(&SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer);
+        int currentRow = SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.getNextRead();
 #ifndef ADDX_UPDATE_ON_DATA_PINS
         dmaUpdateAddress.TCD->SADDR = &(SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateRows[currentRow].rowbits[0].addressValues);
 #endif
@@ -825,7 +922,12 @@ void rowShiftCompleteISR(void) {
     NVIC_SET_PENDING(IRQ_DMA_CH0 + dmaUpdateTimer.channel);
 
     // clear pending int
-    dmaClockOutData.clearInterrupt();
+#if T3_HARDWARE_CLK_SUPPORTED
+    if(optionFlags & SM_HUB75_OPTIONS_T3_HARDWARE_CLK)
+        dmaHardwareClkStop.clearInterrupt();
+    else
+#endif
+        dmaClockOutData.clearInterrupt();
 
 #ifdef DEBUG_PINS_ENABLED
     digitalWriteFast(DEBUG_PIN_1, LOW); // oscilloscope trigger
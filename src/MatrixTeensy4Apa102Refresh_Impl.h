@@ -45,10 +45,10 @@ template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char pan
 void apaRowCalculationISR(void);
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-CircularBuffer_SM SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer;
+SpscRing_SM SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer;
 
-// dmaBufferNumRows = the size of the buffer that DMA pulls from to refresh the display
-// must be minimum 2 rows so one can be updated while the other is refreshed
+// dmaBufferNumRows = the number of frames in the buffer that DMA pulls from to refresh the display
+// minimum 2 frames (see APA102_NUM_FRAME_BUFFERS) so one can be updated while the other is refreshed
 // increase beyond two to give more time for the update routine to complete
 // (increase this number if non-DMA interrupts are causing display problems)
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -66,16 +66,33 @@ uint16_t SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panel
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 typename SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::frameDataStruct * SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateFrame;
 
+// the first strip uses SPIFLEX and apa102ShiftCompleteEvent, others are set up in begin() using pins from setStripPins()
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripClkPins[APA102_NUM_STRIPS];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripDatPins[APA102_NUM_STRIPS];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+FlexIOSPI * SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripSpi[APA102_NUM_STRIPS];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+EventResponder * SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripShiftCompleteEvents[APA102_NUM_STRIPS];
+
+// number of strips started by apaRowShiftCompleteISR() that haven't finished shifting yet
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+volatile uint8_t SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripsShifting;
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::SmartMatrixAPA102Refresh(uint8_t bufferrows, frameDataStruct * frameDataBuffer) {
-    dmaBufferNumRows = bufferrows;
+    dmaBufferNumRows = APA102_NUM_FRAME_BUFFERS(bufferrows);
 
     matrixUpdateFrame = frameDataBuffer;
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 bool SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::isRowBufferFree(void) {
-    if(cbIsFull(&dmaBuffer))
+    if(dmaBuffer.isFull())
         return false;
     else
         return true;
@@ -83,12 +100,12 @@ bool SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 typename SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::frameDataStruct * SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getNextRowBufferPtr(void) {
-    return &(matrixUpdateFrame[cbGetNextWrite(&dmaBuffer)]);
+    return &(matrixUpdateFrame[dmaBuffer.getNextWrite()]);
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::writeRowBuffer(uint8_t currentRow) {
-    cbWrite(&dmaBuffer);
+    dmaBuffer.write();
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -134,9 +151,22 @@ void SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType
     // TODO: update clock speed after begin() called?
 }
 
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setStripPins(uint8_t strip, uint8_t clkPin, uint8_t datPin) {
+    // the first strip always uses SPIFLEX
+    if(strip < 1 || strip >= APA102_NUM_STRIPS)
+        return;
+
+    stripClkPins[strip] = clkPin;
+    stripDatPins[strip] = datPin;
+}
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::begin(void) {
-    cbInit(&dmaBuffer, dmaBufferNumRows);
+    // FlexIOSPI handles DMA complete for one transfer per FlexIO module, and only FlexIO1 and FlexIO2 have DMA
+    static_assert(APA102_NUM_STRIPS <= 2, "SM_APA102_OPTIONS_PARALLEL_STRIPS is limited to 2 strips, one per FlexIO module with DMA");
+
+    dmaBuffer.init(dmaBufferNumRows);
 
     // setup debug output
 #ifdef DEBUG_PINS_ENABLED
@@ -154,13 +184,38 @@ void SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType
     // completely fill buffer with data before enabling DMA
     matrixCalcCallback(true);
 
-    // setup SPI and DMA to feed it
-    SPIFLEX.begin();
-    SPIFLEX.flexIOHandler()->setClockSettings(3, 0, 0); // not exactly sure what this does, but without it the clock seems limited to ~7.5MHz
-    SPIFLEX.beginTransaction(FlexIOSPISettings(spiClockSpeed, MSBFIRST, SPI_MODE0));
+    stripSpi[0] = &SPIFLEX;
+    stripShiftCompleteEvents[0] = &apa102ShiftCompleteEvent;
+
+    // setup SPI and DMA to feed it, a second strip gets its own FlexIOSPI (a shifter and timer on the FlexIO module its pins map to)
+    for(int i = 0; i < APA102_NUM_STRIPS; i++) {
+        if(i > 0) {
+            if(stripClkPins[i] == stripDatPins[i]) {
+                Serial.println("Error: pins for each APA102 strip after the first must be set with setStripPins() before begin()");
+                return;
+            }
+
+            stripSpi[i] = new FlexIOSPI(stripDatPins[i], stripDatPins[i], stripClkPins[i]); /* overlapping MOSI pin on MISO as we don't need MISO */
+            stripShiftCompleteEvents[i] = new EventResponder;
+        }
+
+        if(!stripSpi[i]->begin()) {
+            Serial.println("Error: APA102 strip pins can't be used with FlexIOSPI!");
+            return;
+        }
+
+        int flexIOIndex = stripSpi[i]->flexIOHandler()->FlexIOIndex();
+        if(flexIOIndex > 1 || (i > 0 && flexIOIndex == stripSpi[0]->flexIOHandler()->FlexIOIndex())) {
+            Serial.println("Error: each APA102 strip must use its own FlexIO module, FlexIO1 or FlexIO2!");
+            return;
+        }
 
-    // set interrupt with low priority for long compute time ISR
-    apa102ShiftCompleteEvent.attachInterrupt((EventResponderFunction)&apaRowCalculationISR<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>, ROW_CALC_ISR_PRIORITY);
+        stripSpi[i]->flexIOHandler()->setClockSettings(3, 0, 0); // not exactly sure what this does, but without it the clock seems limited to ~7.5MHz
+        stripSpi[i]->beginTransaction(FlexIOSPISettings(spiClockSpeed, MSBFIRST, SPI_MODE0));
+
+        // set interrupt with low priority for long compute time ISR, with parallel strips it runs once per strip
+        stripShiftCompleteEvents[i]->attachInterrupt((EventResponderFunction)&apaRowCalculationISR<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>, ROW_CALC_ISR_PRIORITY);
+    }
 
     // Give apaRowShiftCompleteISR a low priority, as it can some time (10s of microseconds) to return
     myTimer.priority(SHIFT_COMPLETE_ISR_PRIORITY);
@@ -174,9 +229,15 @@ void apaRowCalculationISR(void) {
     digitalWriteFast(DEBUG_PIN_2, HIGH); // oscilloscope trigger
 #endif
 
-    // done with previous row, mark it as read
-    cbRead(&SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer);
+    // with parallel strips, the buffer is only done after the last strip finishes shifting
+    if(--SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripsShifting) {
+#ifdef DEBUG_PINS_ENABLED
+        digitalWriteFast(DEBUG_PIN_2, LOW);
+#endif
+        return;
+    }
 
+    // the frame that was just sent stays in the buffer until apaRowShiftCompleteISR() has a newer frame to send
     SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixCalcCallback(false);
 
 #ifdef DEBUG_PINS_ENABLED
@@ -191,17 +252,33 @@ void apaRowShiftCompleteISR(void) {
 #ifdef DEBUG_PINS_ENABLED
     digitalWriteFast(DEBUG_PIN_1, HIGH); // oscilloscope trigger
 #endif
-    int currentRow = cbGetNextRead(&SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer);
+    // the last frame is still shifting out, skip this refresh instead of restarting the transfer
+    // until the calc has written its first frame, the buffer at getNextRead() is the one being calculated, so there's nothing to send
+    if(SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripsShifting || !SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.getNumElements()) {
+#ifdef DEBUG_PINS_ENABLED
+        digitalWriteFast(DEBUG_PIN_1, LOW);
+#endif
+        return;
+    }
+
+    // release the frame that was refreshed last if there's a newer frame, otherwise refresh the same frame again
+    if(SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.getNumElements() > 1)
+        SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.read();
 
-    // TODO: if underrun
-        // set flag so other ISR can enable DMA again when data is ready
-        //SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBufferUnderrun = true;
-    // else, start SPI
+    int currentRow = SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.getNextRead();
 
     // SPIFLEX.transfer calls arm_dcache_flush() which can take 10s of microseconds to complete - this is why this ISR has low priority
     // TODO: modify FlexIOSPI to allow for calling arm_dcache_flush() from less time sensitive location
-    SPIFLEX.transfer(SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateFrame[currentRow].data,
-        NULL, ((matrixWidth * matrixHeight)*4) + (4+4), apa102ShiftCompleteEvent);
+    // apaRowCalculationISR() has a lower priority than this ISR, so it can't run for any strip until all strips are started
+    uint8_t * frameData = SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateFrame[currentRow].data;
+    // only strips whose transfer started will call apaRowCalculationISR()
+    uint8_t numStripsStarted = 0;
+    for(int i = 0; i < APA102_NUM_STRIPS; i++) {
+        if(SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripSpi[i]->transfer(&frameData[i * APA102_STRIP_BYTES], NULL, APA102_STRIP_BYTES,
+            *SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripShiftCompleteEvents[i]))
+            numStripsStarted++;
+    }
+    SmartMatrixAPA102Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::stripsShifting = numStripsStarted;
 
 #ifdef DEBUG_PINS_ENABLED
     digitalWriteFast(DEBUG_PIN_1, LOW); // oscilloscope trigger
@@ -48,6 +48,8 @@ class SmartMatrixHub75Calc {
 
         // debug
         int countFPS(void);
+        uint32_t getCalcCyclesPerFrame(void);
+        uint32_t getMaxCalcCyclesPerRow(void);
 
         // functions called by ISR
         static void matrixCalculations(bool initial);
@@ -59,6 +61,7 @@ class SmartMatrixHub75Calc {
         // functions for refreshing
         static void loadMatrixBuffers(unsigned int currentRow);
         static void loadMatrixBuffers48(volatile rowDataStruct * currentRowDataPtr, unsigned int currentRow);
+        static void calculateBitplaneLUTs(void);
         static void resetMultiRowRefreshMapPosition(void);
         static void resetMultiRowRefreshMapPositionPixelGroupToStartOfRow(void);
         static void advanceMultiRowRefreshMapToNextRow(void);
@@ -66,6 +69,8 @@ class SmartMatrixHub75Calc {
         static int getMultiRowRefreshRowOffset(void);
         static int getMultiRowRefreshNumPixelsToMap(void);
         static int getMultiRowRefreshPixelGroupOffset(void);
+        static void calculateRefreshBufferMap(void);
+        static void calculatePanelStackRowLUT(void);
 
         // configuration
         static volatile bool brightnessChange;
@@ -78,10 +83,29 @@ class SmartMatrixHub75Calc {
         static bool refreshRateLowered;
         static bool refreshRateChanged;
 
+        // advanced each frame to move the dither pattern, see hub75DitherThreshold()
+        static uint8_t ditherFrame;
+
+        // lookup tables used to transpose pixel data into FlexIO bitplanes
+        static uint64_t bitplaneSpreadLUT[256];
+        static uint16_t bitplanePinLUT[64];
+
+        // profiling
+        static uint32_t calcCyclesPerFrame;
+        static uint32_t calcCyclesCurrentFrame;
+        static uint32_t calcCyclesMaxRow;
+
         static int multiRowRefresh_mapIndex_CurrentRowGroups;
         static int multiRowRefresh_mapIndex_CurrentPixelGroup;
         static int multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped;
         static int multiRowRefresh_NumPanelsAlreadyMapped;
+
+        // position in the refresh buffer for each pixel in the temporary row buffers, and row offset for each temporary row
+        static uint16_t refreshBufferMap[REFRESH_BUFFER_MAP_REQUIRED ? PIXELS_PER_LATCH : 1];
+        static int refreshBufferMapRowOffsets[PHYSICAL_ROWS_PER_REFRESH_ROW];
+
+        // rows to load from the layers for each stack of panels, for each refresh row and each temporary row
+        static PanelStackRows panelStackRowLUT[MATRIX_SCAN_MOD][PHYSICAL_ROWS_PER_REFRESH_ROW][MATRIX_STACK_HEIGHT];
 };
 
 #endif
@@ -52,6 +52,20 @@ template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char pan
 rotationDegrees SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rotation = rotation0;
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 uint8_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::brightness;
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::ditherFrame = 0;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint64_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::bitplaneSpreadLUT[256];
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint16_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::bitplanePinLUT[64];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcCyclesPerFrame = 0;
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcCyclesCurrentFrame = 0;
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcCyclesMaxRow = 0;
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::multiRowRefresh_mapIndex_CurrentRowGroups = 0;
@@ -65,6 +79,15 @@ int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, opt
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::multiRowRefresh_NumPanelsAlreadyMapped = 0;
 
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint16_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::refreshBufferMap[REFRESH_BUFFER_MAP_REQUIRED ? PIXELS_PER_LATCH : 1];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::refreshBufferMapRowOffsets[PHYSICAL_ROWS_PER_REFRESH_ROW];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+PanelStackRows SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::panelStackRowLUT[MATRIX_SCAN_MOD][PHYSICAL_ROWS_PER_REFRESH_ROW][MATRIX_STACK_HEIGHT];
+
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::SmartMatrixHub75Calc(uint8_t bufferrows, volatile rowDataStruct * rowDataBuf) {
@@ -108,6 +131,21 @@ int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, opt
 }
 
 
+// returns the number of CPU cycles spent filling the refresh buffer with the last complete frame (all MATRIX_SCAN_MOD rows)
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getCalcCyclesPerFrame(void) {
+    return calcCyclesPerFrame;
+}
+
+// returns the largest number of cycles spent calculating a single row since the last call
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getMaxCalcCyclesPerRow(void) {
+    uint32_t ret = calcCyclesMaxRow;
+    calcCyclesMaxRow = 0;
+    return ret;
+}
+
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBufferUnderrunCallback(void) {
     dmaBufferUnderrun = true;
@@ -155,6 +193,9 @@ FASTRUN void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panel
                 templayer = templayer->nextLayer;
             }
             refreshRateChanged = false;
+            if (optionFlags & SM_HUB75_OPTIONS_TEMPORAL_DITHER) {
+                ditherFrame++;
+            }
             if (brightnessChange) {
                 SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setBrightness(brightness);
                 brightnessChange = false;
@@ -165,10 +206,19 @@ FASTRUN void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panel
         // none right now
 
         // enqueue row
+        uint32_t rowStartCycles = SM_GET_CPU_CYCLE_COUNT();
         SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers(currentRow);
+        uint32_t rowCycles = SM_GET_CPU_CYCLE_COUNT() - rowStartCycles;
         SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::writeRowBuffer(currentRow);
 
-        if (++currentRow >= MATRIX_SCAN_MOD) currentRow = 0;
+        if (rowCycles > calcCyclesMaxRow) calcCyclesMaxRow = rowCycles;
+        calcCyclesCurrentFrame += rowCycles;
+
+        if (++currentRow >= MATRIX_SCAN_MOD) {
+            currentRow = 0;
+            calcCyclesPerFrame = calcCyclesCurrentFrame;
+            calcCyclesCurrentFrame = 0;
+        }
 
         if (dmaBufferUnderrun) {
             // if refreshrate is too high, lower - minimum set to avoid overflowing timer at low refresh rates
@@ -267,11 +317,47 @@ FLASHMEM void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, pane
         templayer = templayer->nextLayer;
     }
 
+    // the FlexIO pin configuration is needed to build the bitplane LUTs before the refresh class does the initial buffer fill
+    SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calculateFlexPinConfig();
+    calculateBitplaneLUTs();
+    calculateRefreshBufferMap();
+    calculatePanelStackRowLUT();
+
     SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setMatrixCalculationsCallback(matrixCalculations);
     SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setMatrixUnderrunCallback(dmaBufferUnderrunCallback);
     SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::begin();
 }
 
+// Build the tables used by loadMatrixBuffers48() to transpose pixels into bitplanes:
+// - bitplaneSpreadLUT moves bit n of a byte to bit 0 of byte n in a uint64_t, so six color channels shifted by 0-5 and ORed
+//   together give eight 6-bit codes, one per bitplane, with bit 0=r0, 1=g0, 2=b0, 3=r1, 4=g1, 5=b1
+// - bitplanePinLUT maps each 6-bit code to the FlexIO data word with the color bits on the configured pins
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+FLASHMEM void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calculateBitplaneLUTs(void) {
+    const typename SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::flexPinConfigStruct & pinConfig =
+        SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getFlexPinConfig();
+
+    for (int i = 0; i < 256; i++) {
+        uint64_t spread = 0;
+        for (int bit = 0; bit < 8; bit++) {
+            if (i & (1 << bit))
+                spread |= (uint64_t)1 << (bit * 8);
+        }
+        bitplaneSpreadLUT[i] = spread;
+    }
+
+    for (int code = 0; code < 64; code++) {
+        uint16_t pins = 0;
+        if (code & 0x01) pins |= 1 << pinConfig.r0;
+        if (code & 0x02) pins |= 1 << pinConfig.g0;
+        if (code & 0x04) pins |= 1 << pinConfig.b0;
+        if (code & 0x08) pins |= 1 << pinConfig.r1;
+        if (code & 0x10) pins |= 1 << pinConfig.g1;
+        if (code & 0x20) pins |= 1 << pinConfig.b1;
+        bitplanePinLUT[code] = pins;
+    }
+}
+
 #define IS_LAST_PANEL_MAP_ENTRY(x) (!x.rowOffset && !x.bufferOffset && !x.numPixels)
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -357,109 +443,36 @@ int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, opt
     return map[multiRowRefresh_mapIndex_CurrentPixelGroup].bufferOffset + multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped;
 }
 
+// Walk through the panel map once and store the refresh buffer position for every pixel in the temporary row buffers, so
+// loadMatrixBuffers48() can read the temporary rows in order and scatter pixels to the refresh buffer with a single lookup.
+// The map covers reversed pixel blocks, the offset of each panel in the chain, and upside down stacks with C-shape stacking
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-FASTRUN INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers48(volatile rowDataStruct * currentRowDataPtr, unsigned int currentRow) {
-    /*  Read a new row of pixel data from the layers, extract the bitplanes for each pixel, reformat
-        the data into the format needed for FlexIO, and store that in the rowDataBuffer.
-        Bit depths are supported from 1 bit per color channel (3 bits per pixel) to 16 bits per color channel (48 bits per pixel). */
-
-    int i;
-    int multiRowRefreshRowOffset = 0;
+FLASHMEM void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calculateRefreshBufferMap(void) {
     const int numPixelsPerTempRow = PIXELS_PER_LATCH/PHYSICAL_ROWS_PER_REFRESH_ROW;
+    int multiRowRefreshRowOffset = 0;
 
-    // Temporary buffers to store rgb pixel data for reformatting (static to avoid putting large buffer on the stack)
-    static rgb48 tempRow0[numPixelsPerTempRow];
-    static rgb48 tempRow1[numPixelsPerTempRow];
-
-    int c = 0;
-
-    // multi row refresh isn't very efficient, slowing this function down by ~30% for panels that don't even need multi row refresh.  For now, only enable the code if needed
     if(MULTI_ROW_REFRESH_REQUIRED) { 
         resetMultiRowRefreshMapPosition();
     }
 
     // go through this process for each physical row that is contained in the refresh row
-    do {
-        // clear buffer to prevent garbage data showing
-        memset(tempRow0, 0, sizeof(tempRow0));
-        memset(tempRow1, 0, sizeof(tempRow1));
-
-        // Get pixel data from layers and store in tempRow0 and tempRow1
-        // Scan through the entire chain of panels and extract rows from each one
-        // using the stacking options to get the correct rows (some panels can be upside down).
-        SM_Layer * templayer = SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
-        int y0, y1; // positions of the two rows we need
-        while (templayer) {
-            for (i = 0; i < MATRIX_STACK_HEIGHT; i++) {
-                // Z-shape, bottom to top
-                if (!(optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
-                        (optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    // Bottom to Top Stacking: load data buffer with top panels first, bottom panels last, as top panels are at the furthest end of the chain (initial data is shifted out the furthest)
-                    y0 = currentRow + multiRowRefreshRowOffset + i * MATRIX_PANEL_HEIGHT;
-                    y1 = y0 + ROW_PAIR_OFFSET;
-                // Z-shape, top to bottom
-                } else if (!(optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
-                           !(optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    // Top to Bottom Stacking: load data buffer with bottom panels first, top panels last, as bottom panels are at the furthest end of the chain (initial data is shifted out the furthest)
-                    y0 = currentRow + multiRowRefreshRowOffset + (MATRIX_STACK_HEIGHT - i - 1) * MATRIX_PANEL_HEIGHT;
-                    y1 = y0 + ROW_PAIR_OFFSET;
-                // C-shape, bottom to top
-                } else if ((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
-                           (optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    // C-shaped stacking: alternate direction of filling (or loading) for each matrixwidth-sized stack, stack closest to Teensy is right-side up
-                    //   swap row order from top to bottom for each stack (tempRow1 filled with top half of panel, tempRow0 filled with bottom half when upside down)
-                    //   the last stack is always right-side up, figure out orientation of other stacks based on that
-                    // Bottom to Top Stacking: load data buffer with top panels first, bottom panels last, as top panels are at the furthest end of the chain (initial data is shifted out the furthest)
-
-                    // is i the last stack, or an even number of stacks away from the last stack?
-                    if((i % 2) == ((MATRIX_STACK_HEIGHT - 1) % 2)) {
-                        y0 = currentRow + multiRowRefreshRowOffset + (i) * MATRIX_PANEL_HEIGHT;
-                        y1 = y0 + ROW_PAIR_OFFSET;
-                    } else {
-                        y1 = (MATRIX_SCAN_MOD - currentRow + multiRowRefreshRowOffset - 1) + (i) * MATRIX_PANEL_HEIGHT;
-                        y0 = y1 + ROW_PAIR_OFFSET;
-                    }
-                // C-shape, top to bottom
-                } else if ((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
-                           !(optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
-                    // C-shaped stacking: alternate direction of filling (or loading) for each matrixwidth-sized stack, stack closest to Teensy is right-side up
-                    //   swap row order from top to bottom for each stack (tempRow1 filled with top half of panel, tempRow0 filled with bottom half when upside down)
-                    //   the last stack is always right-side up, figure out orientation of other stacks based on that
-                    // Top to Bottom Stacking: load data buffer with bottom panels first, top panels last, as bottom panels are at the furthest end of the chain (initial data is shifted out the furthest)
-
-                    // is i the last stack, or an even number of stacks away from the last stack?
-                    if((i % 2) == ((MATRIX_STACK_HEIGHT - 1) % 2)) {
-                        y0 = currentRow + multiRowRefreshRowOffset + (MATRIX_STACK_HEIGHT - i - 1) * MATRIX_PANEL_HEIGHT;
-                        y1 = y0 + ROW_PAIR_OFFSET;
-                    } else {
-                        y1 = (MATRIX_SCAN_MOD - currentRow + multiRowRefreshRowOffset - 1) + (MATRIX_STACK_HEIGHT - i - 1) * MATRIX_PANEL_HEIGHT;
-                        y0 = y1 + ROW_PAIR_OFFSET;
-                    }
-                }
-                templayer->fillRefreshRow(y0, &tempRow0[i * matrixWidth]);
-                templayer->fillRefreshRow(y1, &tempRow1[i * matrixWidth]);
-            }
-            templayer = templayer->nextLayer;
-        }
+    for(int physicalRow = 0; physicalRow < PHYSICAL_ROWS_PER_REFRESH_ROW; physicalRow++) {
+        refreshBufferMapRowOffsets[physicalRow] = multiRowRefreshRowOffset;
 
-        i=0;
+        if(!REFRESH_BUFFER_MAP_REQUIRED)
+            break;
 
-        if(MULTI_ROW_REFRESH_REQUIRED) { 
-            // reset pixel map offset so we start filling from the first panel again
-            resetMultiRowRefreshMapPositionPixelGroupToStartOfRow();
-        }
+        int i=0;
 
         while(i < numPixelsPerTempRow) {
-
             int numPixelsToMap;
             int currentMapOffset;
-            bool reversePixelBlock;
+            bool reversePixelBlock = false;
 
             if(MULTI_ROW_REFRESH_REQUIRED) { 
                 // get number of pixels to go through with current pass
                 numPixelsToMap = getMultiRowRefreshNumPixelsToMap();
 
-                reversePixelBlock = false;
                 if(numPixelsToMap < 0) {
                     reversePixelBlock = true;
                     numPixelsToMap = abs(numPixelsToMap);
@@ -469,84 +482,140 @@ FASTRUN INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight
                 currentMapOffset = getMultiRowRefreshPixelGroupOffset();
             } else {
                 numPixelsToMap = matrixWidth;
+                currentMapOffset = i;
             }
 
-            // parse through grouping of pixels, loading from temp buffer and writing to refresh buffer
+            // record where each pixel in this group is written in the refresh buffer
             for(int k=0; k < numPixelsToMap; k++) {
-                uint16_t r0, g0, b0, r1, g1, b1;
                 int ind;
 
-                int refreshBufferPosition;
-                if(MULTI_ROW_REFRESH_REQUIRED) { 
-                    if(reversePixelBlock) {
-                        refreshBufferPosition = currentMapOffset-k;
-                    } else {
-                        refreshBufferPosition = currentMapOffset+k;
-                    }
-                } else {
-                    refreshBufferPosition = i+k;
-                }
-
                 // for upside down stacks, flip order
                 int currentStack = i/matrixWidth;
-                if((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) && !((currentStack % 2) == ((MATRIX_STACK_HEIGHT - 1) % 2))) {
+                if(isPanelStackReversed(currentStack, MATRIX_STACK_HEIGHT, optionFlags)) {
                     // reverse order of this stack's data if it's reversed (if currentStack is the last stack, or an even number of stacks away from the last stack)
                     ind = (currentStack*matrixWidth) + (matrixWidth-1) - ((i+k)%matrixWidth);
                 } else {
                     // load data to buffer in normal order
                     ind = i+k;
                 }
-                r0 = tempRow0[ind].red;
-                g0 = tempRow0[ind].green;
-                b0 = tempRow0[ind].blue;
-                r1 = tempRow1[ind].red;
-                g1 = tempRow1[ind].green;
-                b1 = tempRow1[ind].blue;
-
-                if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE) {
-                    r0 = ~r0;
-                }
 
-                // loop through each bitplane in the current pixel's RGB values and format the bits to match the FlexIO pin configuration
-                uint32_t rgbdata;
-                uint8_t shift = (16 - COLOR_DEPTH_BITS);
-                uint16_t mask = 1 << shift;
-
-                for (int bitindex = 0; bitindex < COLOR_DEPTH_BITS; bitindex++) {
-                    rgbdata  = (r0 & mask) << (SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getFlexPinConfig().r0);
-                    rgbdata |= (g0 & mask) << (SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getFlexPinConfig().g0);
-                    rgbdata |= (b0 & mask) << (SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getFlexPinConfig().b0);
-                    rgbdata |= (r1 & mask) << (SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getFlexPinConfig().r1);
-                    rgbdata |= (g1 & mask) << (SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getFlexPinConfig().g1);
-                    rgbdata |= (b1 & mask) << (SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getFlexPinConfig().b1);
-                    rgbdata >>= shift;
-
-                    shift++;
-                    mask <<= 1;
-
-                    // store these pixel bits in the rowDataBuffer, leaving the initial pixels as padding
-                    currentRowDataPtr->rowbits[bitindex].data[PAD_PIXELS + refreshBufferPosition] = rgbdata;
-                }
+                refreshBufferMap[(physicalRow * numPixelsPerTempRow) + ind] = reversePixelBlock ? (currentMapOffset - k) : (currentMapOffset + k);
             }
             i += numPixelsToMap; // keep track of current position on this temp buffer
             if(MULTI_ROW_REFRESH_REQUIRED) { 
                 advanceMultiRowRefreshMapToNextPixelGroup();
             }
         }
+
+        if(MULTI_ROW_REFRESH_REQUIRED) { 
+            advanceMultiRowRefreshMapToNextRow();
+            multiRowRefreshRowOffset = getMultiRowRefreshRowOffset();
+        }
+    }
+}
+
+// Store the rows of the image to load for each stack of panels, for every refresh row and multi-row refresh offset, so
+// loadMatrixBuffers48() doesn't need to work out the stacking and orientation of each panel while refreshing
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+FLASHMEM void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calculatePanelStackRowLUT(void) {
+    for(int currentRow = 0; currentRow < MATRIX_SCAN_MOD; currentRow++) {
+        for(int physicalRow = 0; physicalRow < PHYSICAL_ROWS_PER_REFRESH_ROW; physicalRow++) {
+            for(int i = 0; i < MATRIX_STACK_HEIGHT; i++) {
+                panelStackRowLUT[currentRow][physicalRow][i] = getPanelStackRows(currentRow + refreshBufferMapRowOffsets[physicalRow], i,
+                    MATRIX_STACK_HEIGHT, MATRIX_PANEL_HEIGHT, ROW_PAIR_OFFSET, optionFlags);
+            }
+        }
+    }
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+FASTRUN INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers48(volatile rowDataStruct * currentRowDataPtr, unsigned int currentRow) {
+    /*  Read a new row of pixel data from the layers, extract the bitplanes for each pixel, reformat
+        the data into the format needed for FlexIO, and store that in the rowDataBuffer.
+        Bit depths are supported from 1 bit per color channel (3 bits per pixel) to 16 bits per color channel (48 bits per pixel). */
+
+    int i;
+    const int numPixelsPerTempRow = PIXELS_PER_LATCH/PHYSICAL_ROWS_PER_REFRESH_ROW;
+
+    // Temporary buffers to store rgb pixel data for reformatting (static to avoid putting large buffer on the stack)
+    static rgb48 tempRow0[numPixelsPerTempRow];
+    static rgb48 tempRow1[numPixelsPerTempRow];
+
+    // go through this process for each physical row that is contained in the refresh row
+    for (int physicalRow = 0; physicalRow < PHYSICAL_ROWS_PER_REFRESH_ROW; physicalRow++) {
+        // Get pixel data from layers and store in tempRow0 and tempRow1
+        // Scan through the entire chain of panels and extract rows from each one
+        // using the stacking options to get the correct rows (some panels can be upside down).
+        // The buffers are only cleared where no opaque layer covers the row, see SM_Layer::fillRefreshRowFromLayers()
+        const PanelStackRows * stackRows = panelStackRowLUT[currentRow][physicalRow];
+        for (i = 0; i < MATRIX_STACK_HEIGHT; i++) {
+            SM_Layer::fillRefreshRowFromLayers(SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer, stackRows[i].y0, &tempRow0[i * matrixWidth], matrixWidth);
+            SM_Layer::fillRefreshRowFromLayers(SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer, stackRows[i].y1, &tempRow1[i * matrixWidth], matrixWidth);
+        }
+
+        // position in the refresh buffer for each pixel in the temp buffer, see calculateRefreshBufferMap()
+        const uint16_t * rowMap = &refreshBufferMap[REFRESH_BUFFER_MAP_REQUIRED ? (physicalRow * numPixelsPerTempRow) : 0];
+
+        // parse through the temp buffer in order, loading pixels and writing them to the refresh buffer
+        for (int ind = 0; ind < numPixelsPerTempRow; ind++) {
+            uint16_t r0, g0, b0, r1, g1, b1;
+
+            int refreshBufferPosition = REFRESH_BUFFER_MAP_REQUIRED ? rowMap[ind] : ind;
+
+            r0 = tempRow0[ind].red;
+            g0 = tempRow0[ind].green;
+            b0 = tempRow0[ind].blue;
+            r1 = tempRow1[ind].red;
+            g1 = tempRow1[ind].green;
+            b1 = tempRow1[ind].blue;
+
+            if (optionFlags & SM_HUB75_OPTIONS_TEMPORAL_DITHER) {
+                // the pattern only needs to be different for neighboring pixels, so the position in the temp row and the physical row
+                // are used instead of screen coordinates, the second row of the pair is offset to not use the same pattern row
+                int ditherY = (currentRow * PHYSICAL_ROWS_PER_REFRESH_ROW) + physicalRow;
+                uint16_t threshold0 = hub75DitherThreshold(ind, ditherY, ditherFrame, 16 - COLOR_DEPTH_BITS);
+                uint16_t threshold1 = hub75DitherThreshold(ind, ditherY + 2, ditherFrame, 16 - COLOR_DEPTH_BITS);
+                r0 = hub75DitherChannel(r0, threshold0);
+                g0 = hub75DitherChannel(g0, threshold0);
+                b0 = hub75DitherChannel(b0, threshold0);
+                r1 = hub75DitherChannel(r1, threshold1);
+                g1 = hub75DitherChannel(g1, threshold1);
+                b1 = hub75DitherChannel(b1, threshold1);
+            }
+
+            if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE) {
+                r0 = ~r0;
+            }
+
+            // transpose the current pixel's RGB values into one 6-bit code per bitplane (see calculateBitplaneLUTs()),
+            // codes[n] holds bit n of all six color channels
+            union {
+                uint64_t lanes[2];
+                uint8_t codes[16];
+            } bitplanes;
+
+            // the low byte is only needed if the refresh depth uses more than the upper 8 bits of each color channel
+            if (COLOR_DEPTH_BITS > 8) {
+                bitplanes.lanes[0] = bitplaneSpreadLUT[r0 & 0xFF]        | (bitplaneSpreadLUT[g0 & 0xFF] << 1) |
+                                    (bitplaneSpreadLUT[b0 & 0xFF] << 2) | (bitplaneSpreadLUT[r1 & 0xFF] << 3) |
+                                    (bitplaneSpreadLUT[g1 & 0xFF] << 4) | (bitplaneSpreadLUT[b1 & 0xFF] << 5);
+            }
+            bitplanes.lanes[1] = bitplaneSpreadLUT[r0 >> 8]        | (bitplaneSpreadLUT[g0 >> 8] << 1) |
+                                (bitplaneSpreadLUT[b0 >> 8] << 2) | (bitplaneSpreadLUT[r1 >> 8] << 3) |
+                                (bitplaneSpreadLUT[g1 >> 8] << 4) | (bitplaneSpreadLUT[b1 >> 8] << 5);
+
+            // map each bitplane's code to the FlexIO pin configuration and store in the rowDataBuffer, leaving the initial pixels as padding
+            for (int bitindex = 0; bitindex < COLOR_DEPTH_BITS; bitindex++) {
+                currentRowDataPtr->rowbits[bitindex].data[PAD_PIXELS + refreshBufferPosition] = bitplanePinLUT[bitplanes.codes[(16 - COLOR_DEPTH_BITS) + bitindex]];
+            }
+        }
         // record the address in the first rowAddress field in the rowBitStruct (other rowAddress fields are unused)
         currentRowDataPtr->rowbits[0].rowAddress = currentRow;
 
         // Applied patch from https://community.pixelmatix.com/t/mapping-assistance-32x16-p10/889/23 not fully integrated (ESP32 only)
         if(panelType == SM_PANELTYPE_HUB75_16ROW_32COL_MOD4SCAN_V4)
             currentRowDataPtr->rowbits[0].rowAddress = ~(0x01 << currentRow);
-
-        if(MULTI_ROW_REFRESH_REQUIRED) { 
-            c += numPixelsPerTempRow; // keep track of cumulative number of pixels filled in refresh buffer before this temp buffer
-
-            advanceMultiRowRefreshMapToNextRow();
-            multiRowRefreshRowOffset = getMultiRowRefreshRowOffset();
-        }
-    } while (MULTI_ROW_REFRESH_REQUIRED ? (multiRowRefreshRowOffset > 0) : 0);
+    }
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -37,6 +37,41 @@
 #define PIXELS_PER_WORD                 2
 #define SHIFTER_PIXELS                  (RGBDATA_SHIFTERS*PIXELS_PER_WORD)
 
+// Compile-time equivalent of FlexIOHandler::mapIOPinToFlexPin() for FlexIO2, which is used for HUB75 output on all of the
+// Teensy 4 hardware configurations.  Returns 0xFF for pins that aren't connected to FlexIO2 (see flex2_hardware in FlexIO_t4.cpp)
+constexpr uint8_t flexIO2PinFromTeensyPin(uint8_t pin) {
+    return (pin == 6) ? 10 : (pin == 7) ? 17 : (pin == 8) ? 16 : (pin == 9) ? 11 : (pin == 10) ? 0 :
+           (pin == 11) ? 2 : (pin == 12) ? 1 : (pin == 13) ? 3 : (pin == 32) ? 12 :
+#if defined(ARDUINO_TEENSY41)
+           (pin == 34) ? 29 : (pin == 35) ? 28 : (pin == 36) ? 18 : (pin == 37) ? 19 :
+#endif
+           0xFF;
+}
+
+constexpr uint8_t flexPinMin(uint8_t a, uint8_t b) { return (a < b) ? a : b; }
+constexpr uint8_t flexPinMax(uint8_t a, uint8_t b) { return (a > b) ? a : b; }
+
+// Bit offsets of the HUB75 signals within the FlexIO data word, calculated at compile time from the pins in the MatrixHardware_Teensy4_*.h file.
+// isValid is false if any of the pins isn't known to flexIO2PinFromTeensyPin(), and then the offsets calculated at runtime are used instead
+template <uint8_t clkPin, uint8_t r0Pin, uint8_t g0Pin, uint8_t b0Pin, uint8_t r1Pin, uint8_t g1Pin, uint8_t b1Pin>
+struct SmartMatrixFlexPinOffsetsT4 {
+    static constexpr bool isValid = (flexIO2PinFromTeensyPin(clkPin) != 0xFF) &&
+        (flexIO2PinFromTeensyPin(r0Pin) != 0xFF) && (flexIO2PinFromTeensyPin(g0Pin) != 0xFF) && (flexIO2PinFromTeensyPin(b0Pin) != 0xFF) &&
+        (flexIO2PinFromTeensyPin(r1Pin) != 0xFF) && (flexIO2PinFromTeensyPin(g1Pin) != 0xFF) && (flexIO2PinFromTeensyPin(b1Pin) != 0xFF);
+
+    static constexpr uint8_t lowestFlexPin = flexPinMin(flexPinMin(flexPinMin(flexIO2PinFromTeensyPin(r0Pin), flexIO2PinFromTeensyPin(g0Pin)),
+        flexPinMin(flexIO2PinFromTeensyPin(b0Pin), flexIO2PinFromTeensyPin(r1Pin))), flexPinMin(flexIO2PinFromTeensyPin(g1Pin), flexIO2PinFromTeensyPin(b1Pin)));
+    static constexpr uint8_t highestFlexPin = flexPinMax(flexPinMax(flexPinMax(flexIO2PinFromTeensyPin(r0Pin), flexIO2PinFromTeensyPin(g0Pin)),
+        flexPinMax(flexIO2PinFromTeensyPin(b0Pin), flexIO2PinFromTeensyPin(r1Pin))), flexPinMax(flexIO2PinFromTeensyPin(g1Pin), flexIO2PinFromTeensyPin(b1Pin)));
+
+    // bit offset of one of the data pins, e.g. offsetOf(R_0_SIGNAL) or offsetOf(ADDX_0_SIGNAL)
+    static constexpr uint8_t offsetOf(uint8_t pin) { return flexIO2PinFromTeensyPin(pin) - lowestFlexPin; }
+
+    static_assert(!isValid || (highestFlexPin < lowestFlexPin + 16), "Incorrect FlexIO pin configuration: data pins must be within 16 contiguous FlexIO pins");
+    static_assert(!isValid || (flexIO2PinFromTeensyPin(clkPin) < lowestFlexPin) || (flexIO2PinFromTeensyPin(clkPin) > highestFlexPin),
+        "Incorrect FlexIO pin configuration: clock pin must be outside the range of data pins");
+};
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 class SmartMatrixRefreshT4 {
     public:
@@ -65,6 +100,11 @@ class SmartMatrixRefreshT4 {
             uint8_t b1;
         };
 
+        // pin offsets known at compile time, used in place of flexPinConfig and addxPinConfig when flexPinOffsets::isValid
+        typedef SmartMatrixFlexPinOffsetsT4<((optionFlags & SMARTMATRIX_OPTIONS_T4_CLK_PIN_ALT) ? FLEXIO_PIN_CLK_TEENSY_PIN_ALT : FLEXIO_PIN_CLK_TEENSY_PIN),
+            FLEXIO_PIN_R0_TEENSY_PIN, FLEXIO_PIN_G0_TEENSY_PIN, FLEXIO_PIN_B0_TEENSY_PIN,
+            FLEXIO_PIN_R1_TEENSY_PIN, FLEXIO_PIN_G1_TEENSY_PIN, FLEXIO_PIN_B1_TEENSY_PIN> flexPinOffsets;
+
         typedef void (*matrix_underrun_callback)(void);
         typedef void (*matrix_calc_callback)(bool initial);
 
@@ -82,6 +122,7 @@ class SmartMatrixRefreshT4 {
         static void setMatrixCalculationsCallback(matrix_calc_callback f);
         static void setMatrixUnderrunCallback(matrix_underrun_callback f);
         static const flexPinConfigStruct & getFlexPinConfig(void);
+        static void calculateFlexPinConfig(void);
         static void setRowAddress(unsigned int row);
 
     private:
@@ -109,7 +150,7 @@ class SmartMatrixRefreshT4 {
         static matrix_calc_callback matrixCalcCallback;
         static matrix_underrun_callback matrixUnderrunCallback;
 
-        static CircularBuffer_SM dmaBuffer;
+        static SpscRing_SM dmaBuffer;
 
         static IMXRT_FLEXIO_t *flexIO;
         static IMXRT_FLEXPWM_t * flexpwm;
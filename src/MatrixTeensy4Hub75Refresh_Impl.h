@@ -69,7 +69,7 @@ void rowShiftCompleteISR(void);
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void rowCalculationISR(void);
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-CircularBuffer_SM SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer;
+SpscRing_SM SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer;
 // dmaBufferNumRows = the size of the buffer that DMA pulls from to refresh the display
 // must be minimum 2 rows so one can be updated while the other is refreshed
 // increase beyond two to give more time for the update routine to complete
@@ -124,7 +124,7 @@ FLASHMEM SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 FASTRUN bool SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::isRowBufferFree(void) {
-    if (cbIsFull(&dmaBuffer))
+    if (dmaBuffer.isFull())
         return false;
     else
         return true;
@@ -133,7 +133,7 @@ FASTRUN bool SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panel
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 FASTRUN INLINE volatile typename SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rowDataStruct * SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getNextRowBufferPtr(void) {
-    return &(matrixUpdateRows[cbGetNextWrite(&dmaBuffer)]);
+    return &(matrixUpdateRows[dmaBuffer.getNextWrite()]);
 }
 
 
@@ -146,7 +146,7 @@ FASTRUN INLINE void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight
     }
     // Now we have refreshed the rowDataStruct for this row and we need to flush cache so that the changes are seen by DMA
     arm_dcache_flush((void*) currentRowDataPtr, sizeof(rowDataStruct));
-    cbWrite(&dmaBuffer); // after cache is flushed, mark this row as ready to be displayed
+    dmaBuffer.write(); // after cache is flushed, mark this row as ready to be displayed
 }
 
 
@@ -156,7 +156,7 @@ FASTRUN void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panel
     flexpwm->MCTRL &= ~FLEXPWM_MCTRL_RUN(1 << submodule);
 
     // point DMA addresses to the next buffer
-    int currentRow = cbGetNextRead(&dmaBuffer);
+    int currentRow = dmaBuffer.getNextRead();
 
     dmaUpdateTimer.TCD->SADDR = &(SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateRows[currentRow].rowbits[0].timerValues.timer_oe);
     dmaClockOutData.TCD->SADDR = SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateRows[currentRow].rowbits[0].data;
@@ -258,7 +258,7 @@ void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, op
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 FLASHMEM void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::begin(void) {
-    cbInit(&dmaBuffer, dmaBufferNumRows);
+    dmaBuffer.init(dmaBufferNumRows);
 
     // set refresh rate and fill timerLUT
     setRefreshRate(refreshRate);
@@ -389,7 +389,7 @@ FLASHMEM void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, pane
     hardwareSetup();
 
     // configure initial row address to send to the panel
-    setRowAddress(cbGetNextRead(&dmaBuffer));
+    setRowAddress(dmaBuffer.getNextRead());
 
     // at the end after everything is set up: enable FlexPWM timer to start display process
     flexpwm->MCTRL |= FLEXPWM_MCTRL_RUN(1 << submodule);
@@ -479,20 +479,8 @@ FLASHMEM void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, pane
         Serial.println("Error: incorrect FlexIO pin configuration!");
     }
 
-    // calculate the bit offsets of the data signals that are output on each pin
-    flexPinConfig.r0 = pFlex->mapIOPinToFlexPin(R_0_SIGNAL) - lowestFlexPin;
-    flexPinConfig.g0 = pFlex->mapIOPinToFlexPin(G_0_SIGNAL) - lowestFlexPin;
-    flexPinConfig.b0 = pFlex->mapIOPinToFlexPin(B_0_SIGNAL) - lowestFlexPin;
-    flexPinConfig.r1 = pFlex->mapIOPinToFlexPin(R_1_SIGNAL) - lowestFlexPin;
-    flexPinConfig.g1 = pFlex->mapIOPinToFlexPin(G_1_SIGNAL) - lowestFlexPin;
-    flexPinConfig.b1 = pFlex->mapIOPinToFlexPin(B_1_SIGNAL) - lowestFlexPin;
-
-    // determine the bit offsets of the address signals
-    addxPinConfig.addx0 = pFlex->mapIOPinToFlexPin(ADDX_0_SIGNAL) - lowestFlexPin;
-    addxPinConfig.addx1 = pFlex->mapIOPinToFlexPin(ADDX_1_SIGNAL) - lowestFlexPin;
-    addxPinConfig.addx2 = pFlex->mapIOPinToFlexPin(ADDX_2_SIGNAL) - lowestFlexPin;
-    addxPinConfig.addx3 = pFlex->mapIOPinToFlexPin(ADDX_3_SIGNAL) - lowestFlexPin;
-    addxPinConfig.addx4 = pFlex->mapIOPinToFlexPin(ADDX_4_SIGNAL) - lowestFlexPin;
+    // calculate the bit offsets of the data and address signals that are output on each pin
+    calculateFlexPinConfig();
 
     // Configure FlexIO Shifters for RGB data buffering:
     // Shifter 0 outputs to the external pins and the other shifters output in sequence.
@@ -776,9 +764,9 @@ FASTRUN void rowShiftCompleteISR(void) {
     dmaClockOutData.clearInterrupt();
 
     if ((dmaEnable.TCD->CITER) == (dmaEnable.TCD->BITER)) {
-        cbRead(&SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer);
+        SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.read();
 
-        if (cbIsEmpty(&SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer)) { // underrun
+        if (SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.isEmpty()) { // underrun
             // point dmaUpdateTimer to repeatedly load from values that set mod to MIN_BLOCK_PERIOD_TICKS and disable OE
             dmaUpdateTimer.TCD->SADDR = &SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::timerPairIdle;
             // set timer increment to repeat timerPairIdle
@@ -790,7 +778,7 @@ FASTRUN void rowShiftCompleteISR(void) {
             SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUnderrunCallback();
         } else {
             // get next row to draw to display and update DMA pointers
-            int currentRow = cbGetNextRead(&SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer);
+            int currentRow = SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBuffer.getNextRead();
             dmaClockOutData.TCD->SADDR = SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateRows[currentRow].rowbits[0].data;
             dmaUpdateTimer.TCD->SADDR = &(SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateRows[currentRow].rowbits[0].timerValues.timer_oe);
             SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setRowAddress(currentRow); // change the row address we send to the panel
@@ -808,6 +796,60 @@ FASTRUN INLINE const typename SmartMatrixRefreshT4<refreshDepth, matrixWidth, ma
 }
 
 
+// Calculates the bit offsets of the data and address signals from the pin definitions, without touching the FlexIO hardware.
+// This is called from hardwareSetup(), and can be called earlier by the calc class, which needs the offsets before the initial buffer fill
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+FLASHMEM void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calculateFlexPinConfig(void) {
+    // use the offsets calculated at compile time if possible
+    if (flexPinOffsets::isValid) {
+        flexPinConfig.r0 = flexPinOffsets::offsetOf(R_0_SIGNAL);
+        flexPinConfig.g0 = flexPinOffsets::offsetOf(G_0_SIGNAL);
+        flexPinConfig.b0 = flexPinOffsets::offsetOf(B_0_SIGNAL);
+        flexPinConfig.r1 = flexPinOffsets::offsetOf(R_1_SIGNAL);
+        flexPinConfig.g1 = flexPinOffsets::offsetOf(G_1_SIGNAL);
+        flexPinConfig.b1 = flexPinOffsets::offsetOf(B_1_SIGNAL);
+
+        addxPinConfig.addx0 = flexPinOffsets::offsetOf(ADDX_0_SIGNAL);
+        addxPinConfig.addx1 = flexPinOffsets::offsetOf(ADDX_1_SIGNAL);
+        addxPinConfig.addx2 = flexPinOffsets::offsetOf(ADDX_2_SIGNAL);
+        addxPinConfig.addx3 = flexPinOffsets::offsetOf(ADDX_3_SIGNAL);
+        addxPinConfig.addx4 = flexPinOffsets::offsetOf(ADDX_4_SIGNAL);
+        return;
+    }
+
+    uint8_t clkFlexPin, lowestFlexPin;
+
+    uint8_t selected_clk_pin = FLEXIO_PIN_CLK_TEENSY_PIN;
+    if (optionFlags & SMARTMATRIX_OPTIONS_T4_CLK_PIN_ALT) {
+        selected_clk_pin = FLEXIO_PIN_CLK_TEENSY_PIN_ALT;
+    }
+
+    FlexIOHandler * pFlex = FlexIOHandler::mapIOPinToFlexIOHandler(selected_clk_pin, clkFlexPin);
+
+    lowestFlexPin = pFlex->mapIOPinToFlexPin(FLEXIO_PIN_B0_TEENSY_PIN);
+    lowestFlexPin = min(lowestFlexPin, pFlex->mapIOPinToFlexPin(FLEXIO_PIN_R0_TEENSY_PIN));
+    lowestFlexPin = min(lowestFlexPin, pFlex->mapIOPinToFlexPin(FLEXIO_PIN_R1_TEENSY_PIN));
+    lowestFlexPin = min(lowestFlexPin, pFlex->mapIOPinToFlexPin(FLEXIO_PIN_G0_TEENSY_PIN));
+    lowestFlexPin = min(lowestFlexPin, pFlex->mapIOPinToFlexPin(FLEXIO_PIN_G1_TEENSY_PIN));
+    lowestFlexPin = min(lowestFlexPin, pFlex->mapIOPinToFlexPin(FLEXIO_PIN_B1_TEENSY_PIN));
+
+    // calculate the bit offsets of the data signals that are output on each pin
+    flexPinConfig.r0 = pFlex->mapIOPinToFlexPin(R_0_SIGNAL) - lowestFlexPin;
+    flexPinConfig.g0 = pFlex->mapIOPinToFlexPin(G_0_SIGNAL) - lowestFlexPin;
+    flexPinConfig.b0 = pFlex->mapIOPinToFlexPin(B_0_SIGNAL) - lowestFlexPin;
+    flexPinConfig.r1 = pFlex->mapIOPinToFlexPin(R_1_SIGNAL) - lowestFlexPin;
+    flexPinConfig.g1 = pFlex->mapIOPinToFlexPin(G_1_SIGNAL) - lowestFlexPin;
+    flexPinConfig.b1 = pFlex->mapIOPinToFlexPin(B_1_SIGNAL) - lowestFlexPin;
+
+    // determine the bit offsets of the address signals
+    addxPinConfig.addx0 = pFlex->mapIOPinToFlexPin(ADDX_0_SIGNAL) - lowestFlexPin;
+    addxPinConfig.addx1 = pFlex->mapIOPinToFlexPin(ADDX_1_SIGNAL) - lowestFlexPin;
+    addxPinConfig.addx2 = pFlex->mapIOPinToFlexPin(ADDX_2_SIGNAL) - lowestFlexPin;
+    addxPinConfig.addx3 = pFlex->mapIOPinToFlexPin(ADDX_3_SIGNAL) - lowestFlexPin;
+    addxPinConfig.addx4 = pFlex->mapIOPinToFlexPin(ADDX_4_SIGNAL) - lowestFlexPin;
+}
+
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 FASTRUN void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setRowAddress(unsigned int row) {
     // Row addressing makes use of the same pins that output RGB color data. This is enabled by additional hardware on the SmartLED Shield.
@@ -817,11 +859,20 @@ FASTRUN void SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panel
     unsigned int currentRowAddress = SmartMatrixRefreshT4<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::matrixUpdateRows[row].rowbits[0].rowAddress;
 
     uint32_t addressData = 0;
-    addressData |= (currentRowAddress & 0x01) ? (1 << addxPinConfig.addx0) : 0;
-    addressData |= (currentRowAddress & 0x02) ? (1 << addxPinConfig.addx1) : 0;
-    addressData |= (currentRowAddress & 0x04) ? (1 << addxPinConfig.addx2) : 0;
-    addressData |= (currentRowAddress & 0x08) ? (1 << addxPinConfig.addx3) : 0;
-    addressData |= (currentRowAddress & 0x10) ? (1 << addxPinConfig.addx4) : 0;
+    if (flexPinOffsets::isValid) {
+        // constant shifts when the pin offsets are known at compile time
+        addressData |= (currentRowAddress & 0x01) ? (1 << flexPinOffsets::offsetOf(ADDX_0_SIGNAL)) : 0;
+        addressData |= (currentRowAddress & 0x02) ? (1 << flexPinOffsets::offsetOf(ADDX_1_SIGNAL)) : 0;
+        addressData |= (currentRowAddress & 0x04) ? (1 << flexPinOffsets::offsetOf(ADDX_2_SIGNAL)) : 0;
+        addressData |= (currentRowAddress & 0x08) ? (1 << flexPinOffsets::offsetOf(ADDX_3_SIGNAL)) : 0;
+        addressData |= (currentRowAddress & 0x10) ? (1 << flexPinOffsets::offsetOf(ADDX_4_SIGNAL)) : 0;
+    } else {
+        addressData |= (currentRowAddress & 0x01) ? (1 << addxPinConfig.addx0) : 0;
+        addressData |= (currentRowAddress & 0x02) ? (1 << addxPinConfig.addx1) : 0;
+        addressData |= (currentRowAddress & 0x04) ? (1 << addxPinConfig.addx2) : 0;
+        addressData |= (currentRowAddress & 0x08) ? (1 << addxPinConfig.addx3) : 0;
+        addressData |= (currentRowAddress & 0x10) ? (1 << addxPinConfig.addx4) : 0;
+    }
 
     volatile uint32_t * addxBuf;
     addxBuf = flexIO->SHIFTBUF + RGBDATA_SHIFTERS;
@@ -48,7 +48,8 @@
 #include "Arduino.h"
 
 #include "MatrixCommon.h"
-#include "CircularBuffer_SM.h"
+#include "SpscRing_SM.h"
+#include "TripleBuffer_SM.h"
 
 #include "Layer_Scrolling.h"
 #include "Layer_Indexed.h"
@@ -110,7 +111,7 @@
             SmartMatrixHub75Refresh<pwm_depth, width, height, panel_type, option_flags> matrix_name##Refresh(buffer_rows, rowsDataBuffer); \
             SmartMatrixHub75Calc<pwm_depth, width, height, panel_type, option_flags> matrix_name(buffer_rows, rowsDataBuffer)
         #define SMARTMATRIX_APA_ALLOCATE_BUFFERS(matrix_name, width, height, pwm_depth, buffer_rows, panel_type, option_flags) \
-            static DMAMEM SmartMatrixAPA102Refresh<pwm_depth, width, height, panel_type, option_flags>::frameDataStruct frameDataBuffer[buffer_rows]; \
+            static DMAMEM SmartMatrixAPA102Refresh<pwm_depth, width, height, panel_type, option_flags>::frameDataStruct frameDataBuffer[APA102_NUM_FRAME_BUFFERS(buffer_rows)]; \
             SmartMatrixAPA102Refresh<pwm_depth, width, height, panel_type, option_flags> matrix_name##Refresh(buffer_rows, frameDataBuffer); \
             SmartMatrixApaCalc<pwm_depth, width, height, panel_type, option_flags> matrix_name(buffer_rows, frameDataBuffer)
     #else   // Teensy 4.x
@@ -120,7 +121,7 @@
             SmartMatrixHub75Calc<pwm_depth, width, height, panel_type, option_flags> matrix_name(buffer_rows, rowsDataBuffer)
         #define SMARTMATRIX_APA_ALLOCATE_BUFFERS(matrix_name, width, height, pwm_depth, buffer_rows, panel_type, option_flags) \
             FlexIOSPI SPIFLEX(FLEXIO_PIN_APA102_DAT, FLEXIO_PIN_APA102_DAT, FLEXIO_PIN_APA102_CLK); /* overlapping MOSI pin on MISO as we don't need MISO */ \
-            static DMAMEM SmartMatrixAPA102Refresh<pwm_depth, width, height, panel_type, option_flags>::frameDataStruct frameDataBuffer[buffer_rows]; \
+            static DMAMEM SmartMatrixAPA102Refresh<pwm_depth, width, height, panel_type, option_flags>::frameDataStruct frameDataBuffer[APA102_NUM_FRAME_BUFFERS(buffer_rows)]; \
             SmartMatrixAPA102Refresh<pwm_depth, width, height, panel_type, option_flags> matrix_name##Refresh(buffer_rows, frameDataBuffer); \
             SmartMatrixApaCalc<pwm_depth, width, height, panel_type, option_flags> matrix_name(buffer_rows, frameDataBuffer)
     #endif
@@ -128,9 +129,10 @@
 #ifdef USE_ADAFRUIT_GFX_LAYERS
         #define SMARTMATRIX_ALLOCATE_BACKGROUND_LAYER(layer_name, width, height, storage_depth, background_options) \
             typedef RGB_TYPE(storage_depth) SM_RGB;                                                                 \
-            static BACKGROUND_MEMSECTION RGB_TYPE(storage_depth) layer_name##Bitmap[2*width*height];                                        \
-            static color_chan_t layer_name##colorCorrectionLUT[sizeof(SM_RGB) <= 3 ? 256 : 4096];                          \
-            static SMLayerBackgroundGFX<RGB_TYPE(storage_depth), background_options> layer_name(layer_name##Bitmap, width, height, layer_name##colorCorrectionLUT)  
+            static BACKGROUND_MEMSECTION RGB_TYPE(storage_depth) layer_name##Bitmap[SM_BACKGROUND_GFX_NUM_BUFFERS(background_options)*width*height]; \
+            static color_chan_t layer_name##colorCorrectionLUT[SM_BACKGROUND_LUT_SIZE(SM_RGB)];                          \
+            static uint8_t layer_name##RowsChanged[SM_BACKGROUND_GFX_ROWS_CHANGED_BYTES(background_options, width, height)]; \
+            static SMLayerBackgroundGFX<RGB_TYPE(storage_depth), background_options> layer_name(layer_name##Bitmap, width, height, layer_name##colorCorrectionLUT, layer_name##RowsChanged)  
 
         #define SMARTMATRIX_ALLOCATE_SCROLLING_LAYER(layer_name, width, height, storage_depth, adafruitgfxlayer_options) \
             typedef RGB_TYPE(storage_depth) SM_RGB;                                                                 \
@@ -149,9 +151,10 @@
 #else
         #define SMARTMATRIX_ALLOCATE_BACKGROUND_LAYER(layer_name, width, height, storage_depth, background_options) \
             typedef RGB_TYPE(storage_depth) SM_RGB;                                                                 \
-            static BACKGROUND_MEMSECTION RGB_TYPE(storage_depth) layer_name##Bitmap[2*width*height];                                        \
-            static color_chan_t layer_name##colorCorrectionLUT[sizeof(SM_RGB) <= 3 ? 256 : 4096];                          \
-            static SMLayerBackground<RGB_TYPE(storage_depth), background_options> layer_name(layer_name##Bitmap, width, height, layer_name##colorCorrectionLUT)  
+            static BACKGROUND_MEMSECTION RGB_TYPE(storage_depth) layer_name##Bitmap[SM_BACKGROUND_NUM_BUFFERS(background_options)*width*height]; \
+            static color_chan_t layer_name##colorCorrectionLUT[SM_BACKGROUND_LUT_SIZE(SM_RGB)];                          \
+            static uint8_t layer_name##RowsChanged[SM_BACKGROUND_ROWS_CHANGED_BYTES(background_options, width, height)]; \
+            static SMLayerBackground<RGB_TYPE(storage_depth), background_options> layer_name(layer_name##Bitmap, width, height, layer_name##colorCorrectionLUT, layer_name##RowsChanged)  
 
         #define SMARTMATRIX_ALLOCATE_SCROLLING_LAYER(layer_name, width, height, storage_depth, scrolling_options) \
             typedef RGB_TYPE(storage_depth) SM_RGB;                                                                 \
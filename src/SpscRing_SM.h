@@ -0,0 +1,91 @@
+#ifndef _SMARTMATRIX_SPSCRING_H_
+#define _SMARTMATRIX_SPSCRING_H_
+
+#include <stdint.h>
+
+/* Single producer/single consumer ring of buffer indexes, replacing CircularBuffer_SM
+
+   Like CircularBuffer_SM this only contains indexes and not any data elements, and allows for peeking at the next read/write index.
+   The producer (calc ISR/task) only calls isFull(), getNextWrite(), and write(), the consumer (refresh ISR) only calls isEmpty(),
+   getNextRead(), and read().  Each side only modifies its own counter and index, so there's no shared count to update from two
+   interrupts, and the ring doesn't rely on the interrupt priorities for correctness.
+
+   head and tail count the total number of elements written and read, and are free running: the number of elements in the ring is
+   always head - tail, even after the counters wrap.  The index of the next element is kept separately by each side and wrapped with a
+   compare, so any number of buffers can be used without a modulo.
+*/
+
+// orders memory accesses between the two sides, compiles to dmb on Cortex-M and memw on ESP32
+#define SPSCRING_MEMORY_BARRIER()   __sync_synchronize()
+
+class SpscRing_SM {
+public:
+    void init(int size) {
+        ringSize = size;
+        head = 0;
+        tail = 0;
+        writeIndex = 0;
+        readIndex = 0;
+    }
+
+    bool isFull(void) const {
+        bool full = (uint32_t)(head - tail) == (uint32_t)ringSize;
+        // don't let writes to the buffer start before the consumer is done with it
+        SPSCRING_MEMORY_BARRIER();
+        return full;
+    }
+
+    bool isEmpty(void) const {
+        bool empty = (head == tail);
+        // don't let reads from the buffer start before the producer is done with it
+        SPSCRING_MEMORY_BARRIER();
+        return empty;
+    }
+
+    // number of elements written and not read yet, only a lower bound for the consumer and an upper bound for the producer
+    uint32_t getNumElements(void) const {
+        uint32_t count = head - tail;
+        SPSCRING_MEMORY_BARRIER();
+        return count;
+    }
+
+    // returns index of next element to write
+    int getNextWrite(void) const {
+        return writeIndex;
+    }
+
+    // mark next element as written, only call when isFull() is false: unlike CircularBuffer_SM, a full ring isn't overwritten, as
+    // that would need the producer to move the consumer's tail
+    void write(void) {
+#ifdef ESP32
+        assert(!isFull());
+#endif
+        if(++writeIndex == ringSize)
+            writeIndex = 0;
+        // the data written to the buffer needs to be visible before the consumer sees the new head
+        SPSCRING_MEMORY_BARRIER();
+        head = head + 1;
+    }
+
+    // returns index of next element to read
+    int getNextRead(void) const {
+        return readIndex;
+    }
+
+    // marks next element as read
+    void read(void) {
+        if(++readIndex == ringSize)
+            readIndex = 0;
+        SPSCRING_MEMORY_BARRIER();
+        tail = tail + 1;
+    }
+
+private:
+    volatile uint32_t head;     /* elements written, only modified by the producer  */
+    volatile uint32_t tail;     /* elements read, only modified by the consumer     */
+    int writeIndex;             /* index of next element to write                   */
+    int readIndex;              /* index of oldest element                          */
+    int ringSize;               /* maximum number of elements                       */
+};
+
+#endif // _SMARTMATRIX_SPSCRING_H_
@@ -0,0 +1,102 @@
+#ifndef _SMARTMATRIX_TRIPLEBUFFER_H_
+#define _SMARTMATRIX_TRIPLEBUFFER_H_
+
+#include <stdint.h>
+
+/* Indexes of three frame buffers shared between a producer (application drawing) and a consumer (refresh ISR/task)
+
+   Like SpscRing_SM this only contains indexes and not any data.  At any time one buffer is being drawn to, one is being refreshed,
+   and the third is either the newest completed frame waiting to be picked up, or free.  publish() never waits: if the previous frame
+   wasn't picked up yet it's dropped and its buffer becomes the next drawing buffer.  update() always switches to the newest frame.
+
+   Each variable is only written by one side.  The producer publishes a frame by writing the frame number and buffer index together
+   in newestFrame, then reads refreshIndex to find a free buffer.  The consumer claims the newest frame by writing refreshIndex, then
+   checks that no newer frame was published while it was doing that, and if one was it claims that one instead.  The barriers
+   between each side's write and the following read make sure that either the producer sees the consumer's claim, or the consumer
+   sees the newer frame, so they never end up with the same buffer.  This also works with the consumer running on another core,
+   without disabling interrupts or using atomic instructions.
+*/
+
+#define TRIPLEBUFFER_MEMORY_BARRIER()   __sync_synchronize()
+
+// newestFrame holds the frame number in the upper bits and the buffer index in the lower two bits, so both are read with one access
+#define TRIPLEBUFFER_INDEX_MASK         0x03
+#define TRIPLEBUFFER_FRAME_SHIFT        2
+
+class TripleBuffer_SM {
+public:
+    // starts with buffer 0 drawing and buffer 1 refreshing
+    void init(void) {
+        drawIndex = 0;
+        refreshIndex = 1;
+        newestFrame = 1;
+        consumedFrameNumber = 0;
+    }
+
+    int getDrawIndex(void) const {
+        return drawIndex;
+    }
+
+    int getRefreshIndex(void) const {
+        return refreshIndex;
+    }
+
+    // index of the last frame published, or the initial refresh buffer if nothing was published yet
+    int getNewestIndex(void) const {
+        return newestFrame & TRIPLEBUFFER_INDEX_MASK;
+    }
+
+    // true if the newest frame wasn't picked up by the consumer yet
+    bool isPending(void) const {
+        return (newestFrame >> TRIPLEBUFFER_FRAME_SHIFT) != consumedFrameNumber;
+    }
+
+    // producer: makes the drawing buffer the newest frame and moves drawing to a free buffer, returns the index of the new frame
+    int publish(void) {
+        int frame = drawIndex;
+        uint32_t frameNumber = (newestFrame >> TRIPLEBUFFER_FRAME_SHIFT) + 1;
+
+        // the frame's data needs to be visible before the consumer sees the new frame
+        TRIPLEBUFFER_MEMORY_BARRIER();
+        newestFrame = (frameNumber << TRIPLEBUFFER_FRAME_SHIFT) | frame;
+        TRIPLEBUFFER_MEMORY_BARRIER();
+
+        // the consumer is refreshing either this buffer or one it claimed before seeing the new frame, the remaining buffer is free
+        int refresh = refreshIndex;
+        if(refresh == frame)
+            drawIndex = (frame == 2) ? 0 : (frame + 1);
+        else
+            drawIndex = 3 - frame - refresh;
+
+        return frame;
+    }
+
+    // consumer: switches to the newest frame, returns the number of frames published since the last update (more than one if frames were dropped)
+    uint32_t update(void) {
+        uint32_t frame = newestFrame;
+        if((frame >> TRIPLEBUFFER_FRAME_SHIFT) == consumedFrameNumber)
+            return 0;
+
+        while(true) {
+            refreshIndex = frame & TRIPLEBUFFER_INDEX_MASK;
+            TRIPLEBUFFER_MEMORY_BARRIER();
+            // if another frame was published before the claim was visible, the producer may have already started drawing to the claimed buffer
+            uint32_t newerFrame = newestFrame;
+            if(newerFrame == frame)
+                break;
+            frame = newerFrame;
+        }
+
+        uint32_t framesPublished = (frame >> TRIPLEBUFFER_FRAME_SHIFT) - consumedFrameNumber;
+        consumedFrameNumber = frame >> TRIPLEBUFFER_FRAME_SHIFT;
+        return framesPublished;
+    }
+
+private:
+    volatile int drawIndex;                 /* only modified by the producer                                    */
+    volatile uint32_t newestFrame;          /* frame number and index of newest frame, only modified by producer */
+    volatile int refreshIndex;              /* only modified by the consumer                                    */
+    volatile uint32_t consumedFrameNumber;  /* frame number currently refreshing, only modified by the consumer  */
+};
+
+#endif // _SMARTMATRIX_TRIPLEBUFFER_H_